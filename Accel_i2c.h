@@ -5,8 +5,13 @@
  * Created on April 21, 2022
  */
 
+#ifndef ACCEL_I2C_H
+#define ACCEL_I2C_H
+
 typedef enum {OK, NACK, ACK, BAD_ADDR, BAD_REG} I2Cerror;
 
 void i2c1_open(void);
 I2Cerror i2cReadSlaveRegister(unsigned char devAddW, unsigned char regAdd, unsigned char *reg);
 I2Cerror i2cWriteSlave(unsigned char devAddW, unsigned char regAdd, unsigned char data);
+
+#endif // ACCEL_I2C_H
@@ -0,0 +1,132 @@
+/*
+ * File:   Accel_tap.c
+ *
+ * ADXL345 tap engine configuration and INT1 event delivery.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "Accel_tap.h"
+
+#define ACCEL_ADDR_W            0x3A
+
+// ADXL345 registers
+#define ADXL345_THRESH_TAP      0x1D
+#define ADXL345_DUR             0x21
+#define ADXL345_LATENT          0x22
+#define ADXL345_WINDOW          0x23
+#define ADXL345_TAP_AXES        0x2A
+#define ADXL345_INT_ENABLE      0x2E
+#define ADXL345_INT_MAP         0x2F
+#define ADXL345_INT_SOURCE      0x30
+
+#define ADXL345_INT_SINGLE_TAP  0x40
+#define ADXL345_INT_DOUBLE_TAP  0x20
+
+// Tap tuning
+#define TAP_THRESHOLD   0x38  // 62.5 mg/LSB  -> 3.5 g
+#define TAP_DURATION    0x10  // 625 us/LSB   -> 10 ms max above threshold
+#define TAP_LATENCY     0x40  // 1.25 ms/LSB  -> 80 ms before the second tap may start
+#define TAP_WINDOW      0xC8  // 1.25 ms/LSB  -> 250 ms window for the second tap
+#define TAP_AXES        0x01  // Z only: taps on the display face
+
+// A held single tap is given up on once no second tap can follow it
+#define TAP_HOLD_MS     ((TAP_LATENCY + TAP_WINDOW) * 5 / 4 + 20)
+
+static volatile bool tapPending = false;
+static volatile uint16_t tapIrqCount = 0;
+static uint16_t tapSourceReads = 0;
+static TapClock tapClock;
+static bool singleHeld = false;
+static uint32_t singleHeldAt;
+
+I2Cerror accelTap_initialize(TapClock millis)
+{
+    static const uint8_t config[][2] = {
+        { ADXL345_INT_ENABLE, 0x00 },   // quiet while reconfiguring
+        { ADXL345_THRESH_TAP, TAP_THRESHOLD },
+        { ADXL345_DUR,        TAP_DURATION },
+        { ADXL345_LATENT,     TAP_LATENCY },
+        { ADXL345_WINDOW,     TAP_WINDOW },
+        { ADXL345_TAP_AXES,   TAP_AXES },
+        { ADXL345_INT_MAP,    0x00 },   // everything on INT1
+    };
+    uint8_t source;
+    uint8_t i;
+
+    IEC1bits.INT1IE = 0;
+    for (i = 0; i < sizeof(config) / sizeof(config[0]); i++) {
+        if (i2cWriteSlave(ACCEL_ADDR_W, config[i][0], config[i][1]) != OK)
+            return BAD_REG;
+    }
+    // Clear any latched source so INT1 starts low and the first edge is seen
+    if (i2cReadSlaveRegister(ACCEL_ADDR_W, ADXL345_INT_SOURCE, &source) != OK)
+        return BAD_REG;
+    if (i2cWriteSlave(ACCEL_ADDR_W, ADXL345_INT_ENABLE,
+                      ADXL345_INT_SINGLE_TAP | ADXL345_INT_DOUBLE_TAP) != OK)
+        return BAD_REG;
+
+    tapClock = millis;
+    tapPending = false;
+    singleHeld = false;
+    INTCON2bits.INT1EP = 0;   // rising edge, INT1 is active high
+    IFS1bits.INT1IF = 0;
+    IEC1bits.INT1IE = 1;
+    return OK;
+}
+
+TapEvent accelTap_getEvent(void)
+{
+    uint8_t source;
+    uint32_t now = tapClock();
+
+    if (!tapPending) {
+        if (singleHeld && now - singleHeldAt >= TAP_HOLD_MS) {
+            singleHeld = false;
+            return TAP_SINGLE;
+        }
+        return TAP_NONE;
+    }
+    tapPending = false;
+
+    // Reading INT_SOURCE also releases INT1 for the next edge
+    tapSourceReads++;
+    if (i2cReadSlaveRegister(ACCEL_ADDR_W, ADXL345_INT_SOURCE, &source) != OK)
+        return TAP_NONE;
+    if (source & ADXL345_INT_DOUBLE_TAP) {
+        singleHeld = false;     // it was the first half of this one
+        return TAP_DOUBLE;
+    }
+    if (source & ADXL345_INT_SINGLE_TAP) {
+        // A second single means the one held had no double tap after all
+        bool released = singleHeld;
+        singleHeld = true;
+        singleHeldAt = now;
+        return released ? TAP_SINGLE : TAP_NONE;
+    }
+    return TAP_NONE;
+}
+
+void accelTap_flush(void)
+{
+    (void) accelTap_getEvent();
+    singleHeld = false;
+}
+
+uint16_t accelTap_getIrqCount(void)
+{
+    return tapIrqCount;
+}
+
+uint16_t accelTap_getSourceReadCount(void)
+{
+    return tapSourceReads;
+}
+
+void __attribute__((interrupt, no_auto_psv)) _INT1Interrupt(void)
+{
+    IFS1bits.INT1IF = 0;
+    tapIrqCount++;
+    tapPending = true;
+}
@@ -0,0 +1,37 @@
+/*
+ * File:   Accel_tap.h
+ *
+ * Tap / double-tap input from the ADXL345 tap engine.
+ * The accelerometer does the detection itself and raises its INT1 line,
+ * which is wired to RC7 (external interrupt INT1). The MCU only reads
+ * INT_SOURCE after an interrupt, so idle taps cost nothing.
+ *
+ * The tap engine flags SINGLE_TAP on the first tap of a double tap too.
+ * A single tap is therefore held until the latency and window have run
+ * out with no second tap, and dropped when the double tap follows: each
+ * gesture reaches the caller as exactly one event.
+ */
+
+#ifndef ACCEL_TAP_H
+#define ACCEL_TAP_H
+
+#include <stdint.h>
+#include "Accel_i2c.h"
+
+typedef enum {
+    TAP_NONE,
+    TAP_SINGLE,
+    TAP_DOUBLE
+} TapEvent;
+
+typedef uint32_t (*TapClock)(void);   // milliseconds
+
+I2Cerror accelTap_initialize(TapClock millis);
+TapEvent accelTap_getEvent(void);
+void accelTap_flush(void);
+
+// Counters: every INT_SOURCE read must be paid for by an interrupt
+uint16_t accelTap_getIrqCount(void);
+uint16_t accelTap_getSourceReadCount(void);
+
+#endif // ACCEL_TAP_H
@@ -0,0 +1,398 @@
+/*
+ * File:   step_codec.c
+ *
+ * Delta / zigzag / nibble codec for step-count blocks, with fixed-width
+ * packing for blocks the tokens do not suit.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "step_codec.h"
+
+#define TOKEN_SMALL_MAX     12
+#define TOKEN_SHORT         13      // one more nibble: 13..28
+#define SHORT_MIN           (TOKEN_SMALL_MAX + 1)
+#define LONG_MIN            (SHORT_MIN + 16)
+#define TOKEN_RUN           14
+#define TOKEN_ESCAPE        15
+#define RUN_MIN             2
+#define RUN_MAX             (RUN_MIN + 15)
+#define VARINT_MORE         0x08
+#define WIDTH_BITS          4       // the width nibble ahead of packed samples
+
+enum {
+    KIND_NONE,
+    KIND_ZERO,      // single unchanged sample, can grow into a run
+    KIND_RUN,
+    KIND_OTHER
+};
+
+static uint8_t getNibble(const uint8_t *block, uint8_t pos)
+{
+    uint8_t b = block[1 + (pos >> 1)];
+    return (pos & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+static void setNibble(uint8_t *block, uint8_t pos, uint8_t value)
+{
+    uint8_t *b = &block[1 + (pos >> 1)];
+    *b = (pos & 1) ? (*b & 0xF0) | value : (*b & 0x0F) | (value << 4);
+}
+
+/* Bit 0 is the high bit of the first token byte, as nibble 0 is its high nibble */
+static uint32_t getBits(const uint8_t *block, uint8_t bit, uint8_t width)
+{
+    uint32_t v = 0;
+
+    while (width--) {
+        v = (v << 1) | ((block[1 + (bit >> 3)] >> (7 - (bit & 7))) & 1);
+        bit++;
+    }
+    return v;
+}
+
+static void setBits(uint8_t *block, uint8_t bit, uint8_t width, uint32_t v)
+{
+    uint8_t mask;
+
+    while (width--) {
+        mask = 0x80 >> (bit & 7);
+        if ((v >> width) & 1)
+            block[1 + (bit >> 3)] |= mask;
+        else
+            block[1 + (bit >> 3)] &= ~mask;
+        bit++;
+    }
+}
+
+static uint8_t bitWidth(uint32_t v)
+{
+    uint8_t n = 1;
+    while (v >>= 1)
+        n++;
+    return n;
+}
+
+static bool packedFits(uint8_t samples, uint8_t width)
+{
+    return width <= STEP_CODEC_PACKED_WIDTH && (uint16_t)samples * width <= STEP_CODEC_PACKED_BITS;
+}
+
+/* Width of a packed block; 0 for a token block or an impossible packed one */
+static uint8_t packedWidth(const uint8_t *block)
+{
+    uint8_t width;
+
+    if (!(block[0] & STEP_CODEC_PACKED))
+        return 0;
+    width = getNibble(block, 0) + 1;
+    return packedFits(stepCodec_count(block), width) ? width : 0;
+}
+
+static uint32_t zigzag(uint32_t value, uint32_t prev)
+{
+    uint32_t delta = value - prev;
+    return (delta & 0x80000000UL) ? ~(delta << 1) : delta << 1;
+}
+
+static uint32_t unzigzag(uint32_t z)
+{
+    return (z & 1) ? ~(z >> 1) : z >> 1;
+}
+
+static uint8_t varintNibbles(uint32_t v)
+{
+    uint8_t n = 1;
+    while (v >>= 3)
+        n++;
+    return n;
+}
+
+/* Read a token's zigzag value (runs excluded); false past the end of the block */
+static bool readValue(const uint8_t *block, uint8_t *pos, uint8_t token, uint32_t *z)
+{
+    uint8_t shift = 0;
+    uint8_t nib;
+
+    if (token <= TOKEN_SMALL_MAX) {
+        *z = token;
+        return true;
+    }
+    if (token == TOKEN_SHORT) {
+        if (*pos >= STEP_CODEC_BLOCK_NIBBLES)
+            return false;
+        *z = SHORT_MIN + getNibble(block, (*pos)++);
+        return true;
+    }
+    *z = 0;
+    do {
+        if (*pos >= STEP_CODEC_BLOCK_NIBBLES || shift > 30)
+            return false;
+        nib = getNibble(block, (*pos)++);
+        *z |= (uint32_t)(nib & 0x07) << shift;
+        shift += 3;
+    } while (nib & VARINT_MORE);
+    *z += LONG_MIN;
+    return true;
+}
+
+void stepCodec_begin(StepEncoder *enc, uint8_t *block)
+{
+    uint8_t i;
+
+    for (i = 0; i < STEP_CODEC_BLOCK_BYTES; i++)
+        block[i] = 0;
+    enc->block = block;
+    enc->prev = 0;
+    enc->pos = 0;
+    enc->lastPos = 0;
+    enc->lastKind = KIND_NONE;
+    enc->width = 0;
+}
+
+/* Walk the tokens of a block to pick up where its encoder stopped */
+bool stepCodec_resume(StepEncoder *enc, uint8_t *block)
+{
+    uint8_t count = stepCodec_count(block);
+    uint8_t samples = 0;
+    uint8_t pos = 0;
+    uint8_t token;
+    uint32_t z;
+
+    enc->block = block;
+    enc->prev = 0;
+    enc->lastPos = 0;
+    enc->lastKind = KIND_NONE;
+    enc->width = 0;
+    if (block[0] & STEP_CODEC_PACKED) {
+        enc->width = packedWidth(block);
+        if (enc->width && count)
+            enc->prev = getBits(block, WIDTH_BITS + (count - 1) * enc->width, enc->width);
+        enc->pos = 0;
+        return enc->width != 0;
+    }
+
+    while (samples < count) {
+        if (pos >= STEP_CODEC_BLOCK_NIBBLES)
+            return false;
+        enc->lastPos = pos;
+        token = getNibble(block, pos++);
+        if (token == TOKEN_RUN) {
+            if (pos >= STEP_CODEC_BLOCK_NIBBLES)
+                return false;
+            samples += getNibble(block, pos++) + RUN_MIN;
+            enc->lastKind = KIND_RUN;
+        } else {
+            if (!readValue(block, &pos, token, &z))
+                return false;
+            enc->prev += unzigzag(z);
+            samples++;
+            enc->lastKind = (token == 0) ? KIND_ZERO : KIND_OTHER;
+        }
+    }
+    enc->pos = pos;
+    return samples == count;
+}
+
+/* Tokens for one more sample; the count is left to the caller */
+static bool appendToken(StepEncoder *enc, uint32_t value)
+{
+    uint8_t *block = enc->block;
+    uint32_t z;
+    uint8_t need;
+
+    z = zigzag(value, enc->prev);
+    if (z == 0 && enc->lastKind == KIND_RUN &&
+        getNibble(block, enc->lastPos + 1) < RUN_MAX - RUN_MIN) {
+        // Lengthen the run in place
+        setNibble(block, enc->lastPos + 1, getNibble(block, enc->lastPos + 1) + 1);
+    } else if (z == 0 && enc->lastKind == KIND_ZERO && enc->pos < STEP_CODEC_BLOCK_NIBBLES) {
+        // Second unchanged sample in a row: turn the zero into a run of two
+        setNibble(block, enc->lastPos, TOKEN_RUN);
+        setNibble(block, enc->pos++, 0);
+        enc->lastKind = KIND_RUN;
+    } else {
+        if (z <= TOKEN_SMALL_MAX)
+            need = 1;
+        else if (z < LONG_MIN)
+            need = 2;
+        else
+            need = 1 + varintNibbles(z - LONG_MIN);
+        if (enc->pos + need > STEP_CODEC_BLOCK_NIBBLES)
+            return false;
+
+        enc->lastPos = enc->pos;
+        if (z <= TOKEN_SMALL_MAX) {
+            setNibble(block, enc->pos++, (uint8_t)z);
+            enc->lastKind = (z == 0) ? KIND_ZERO : KIND_OTHER;
+        } else if (z < LONG_MIN) {
+            setNibble(block, enc->pos++, TOKEN_SHORT);
+            setNibble(block, enc->pos++, (uint8_t)(z - SHORT_MIN));
+            enc->lastKind = KIND_OTHER;
+        } else {
+            z -= LONG_MIN;
+            setNibble(block, enc->pos++, TOKEN_ESCAPE);
+            do {
+                uint8_t nib = z & 0x07;
+                z >>= 3;
+                if (z)
+                    nib |= VARINT_MORE;
+                setNibble(block, enc->pos++, nib);
+            } while (z);
+            enc->lastKind = KIND_OTHER;
+        }
+    }
+
+    enc->prev = value;
+    return true;
+}
+
+static bool appendPacked(StepEncoder *enc, uint32_t value)
+{
+    uint8_t n = stepCodec_count(enc->block);
+
+    if (bitWidth(value) > enc->width || !packedFits(n + 1, enc->width))
+        return false;
+    setBits(enc->block, WIDTH_BITS + n * enc->width, enc->width, value);
+    enc->prev = value;
+    return true;
+}
+
+static bool appendSample(StepEncoder *enc, uint32_t value)
+{
+    if (!(enc->width ? appendPacked(enc, value) : appendToken(enc, value)))
+        return false;
+    enc->block[0]++;
+    return true;
+}
+
+/* Write the samples of from, then value, into a fresh block packed at width or as tokens (0) */
+static bool refill(StepEncoder *enc, const uint8_t *from, uint8_t width, uint32_t value)
+{
+    StepDecoder dec;
+    uint32_t v;
+    bool fits = true;
+
+    stepCodec_begin(enc, enc->block);
+    if (width) {
+        enc->width = width;
+        enc->block[0] = STEP_CODEC_PACKED;
+        setNibble(enc->block, 0, width - 1);
+    }
+    stepCodec_decodeBegin(&dec, from);
+    while (fits && stepCodec_decodeNext(&dec, &v))
+        fits = appendSample(enc, v);
+    return fits && appendSample(enc, value);
+}
+
+/*
+ * The block has no room for value in its current form. A token block may
+ * still take it packed, a packed one wider or as tokens; the samples are
+ * rewritten from a copy, which is put back when no form fits.
+ */
+static bool reform(StepEncoder *enc, uint32_t value)
+{
+    uint8_t saved[STEP_CODEC_BLOCK_BYTES];
+    StepEncoder before = *enc;
+    StepDecoder dec;
+    uint8_t width = bitWidth(value);
+    uint8_t i;
+    uint32_t v;
+
+    for (i = 0; i < STEP_CODEC_BLOCK_BYTES; i++)
+        saved[i] = enc->block[i];
+    stepCodec_decodeBegin(&dec, saved);
+    while (stepCodec_decodeNext(&dec, &v)) {
+        if (bitWidth(v) > width)
+            width = bitWidth(v);
+    }
+
+    if (width != before.width && packedFits(stepCodec_count(saved) + 1, width) &&
+        refill(enc, saved, width, value))
+        return true;
+    if (before.width && refill(enc, saved, 0, value))
+        return true;
+
+    for (i = 0; i < STEP_CODEC_BLOCK_BYTES; i++)
+        before.block[i] = saved[i];
+    *enc = before;
+    return false;
+}
+
+bool stepCodec_append(StepEncoder *enc, uint32_t value)
+{
+    if (stepCodec_count(enc->block) >= STEP_CODEC_MAX_SAMPLES)
+        return false;
+    return appendSample(enc, value) || reform(enc, value);
+}
+
+void stepCodec_decodeBegin(StepDecoder *dec, const uint8_t *block)
+{
+    dec->block = block;
+    dec->value = 0;
+    dec->pos = 0;
+    dec->left = stepCodec_count(block);
+    dec->run = 0;
+    dec->width = 0;
+    if (block[0] & STEP_CODEC_PACKED) {
+        dec->width = packedWidth(block);
+        dec->pos = WIDTH_BITS;
+        if (dec->width == 0)
+            dec->left = 0;  // corrupt block: nothing to read
+    }
+}
+
+/* Read the next token into the decoder state; false past the end of the block */
+static bool readToken(StepDecoder *dec)
+{
+    uint8_t token;
+    uint32_t z;
+
+    if (dec->pos >= STEP_CODEC_BLOCK_NIBBLES)
+        return false;
+    token = getNibble(dec->block, dec->pos++);
+    if (token == TOKEN_RUN) {
+        if (dec->pos >= STEP_CODEC_BLOCK_NIBBLES)
+            return false;
+        dec->run = getNibble(dec->block, dec->pos++) + RUN_MIN;
+        return true;
+    }
+    if (!readValue(dec->block, &dec->pos, token, &z))
+        return false;
+    dec->value += unzigzag(z);
+    return true;
+}
+
+bool stepCodec_decodeNext(StepDecoder *dec, uint32_t *value)
+{
+    if (dec->left == 0)
+        return false;
+    if (dec->width) {
+        dec->left--;
+        *value = getBits(dec->block, dec->pos, dec->width);
+        dec->pos += dec->width;
+        return true;
+    }
+    if (dec->run == 0 && !readToken(dec)) {
+        dec->left = 0;      // corrupt block: stop here
+        return false;
+    }
+    if (dec->run)
+        dec->run--;
+
+    dec->left--;
+    *value = dec->value;
+    return true;
+}
+
+bool stepCodec_intact(const uint8_t *block)
+{
+    StepDecoder dec;
+    uint32_t v;
+    uint8_t n = 0;
+
+    stepCodec_decodeBegin(&dec, block);
+    while (stepCodec_decodeNext(&dec, &v))
+        n++;
+    return n == stepCodec_count(block);
+}
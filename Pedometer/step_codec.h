@@ -0,0 +1,81 @@
+/*
+ * File:   step_codec.h
+ *
+ * Compact codec for step-count series. Every sample is stored as the
+ * zigzagged delta from the previous one, packed into 4-bit tokens:
+ *
+ *   0..12      delta of that zigzag value (one nibble)
+ *   13 n       zigzag value 13 + n (two nibbles)
+ *   14 n       run of n + 2 unchanged samples (two nibbles)
+ *   15 v...    zigzag value - 29 as a nibble varint: 3 data bits per
+ *              nibble, low group first, bit 3 set on all but the last
+ *
+ * Samples are packed into fixed blocks of STEP_CODEC_BLOCK_BYTES:
+ * byte 0 holds the sample count, the rest the tokens (high nibble
+ * first). The first sample of a block is coded against 0, so every block
+ * is a key frame and can be decoded without its neighbours. A block is
+ * also exactly one persistence chunk of the step history.
+ *
+ * Series that move a lot between samples (quarter hours, days) cost more
+ * as tokens than as plain numbers. A block can instead be packed: bit 7
+ * of byte 0 is set, the first nibble holds the width - 1 and the other
+ * 68 bits hold the samples at that many bits each, high bit first. The
+ * encoder keeps a block in whichever form still takes the next sample,
+ * so a block holds at least 68 / width samples: four full day totals of
+ * up to 15 bits, five quarter hours of up to 13 bits.
+ */
+
+#ifndef STEP_CODEC_H
+#define STEP_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STEP_CODEC_BLOCK_BYTES      10
+#define STEP_CODEC_BLOCK_NIBBLES    ((STEP_CODEC_BLOCK_BYTES - 1) * 2)
+#define STEP_CODEC_MAX_SAMPLES      127
+#define STEP_CODEC_PACKED           0x80    // byte 0: fixed-width samples
+#define STEP_CODEC_PACKED_BITS      ((STEP_CODEC_BLOCK_NIBBLES - 1) * 4)
+#define STEP_CODEC_PACKED_WIDTH     16      // widest packed sample
+
+typedef struct {
+    uint8_t *block;
+    uint32_t prev;
+    uint8_t  pos;        // next free nibble
+    uint8_t  lastPos;    // first nibble of the last token
+    uint8_t  lastKind;
+    uint8_t  width;      // packed block: bits per sample; 0 for tokens
+} StepEncoder;
+
+typedef struct {
+    const uint8_t *block;
+    uint32_t value;
+    uint8_t  pos;
+    uint8_t  left;       // samples not yet returned
+    uint8_t  run;        // unchanged samples still owed by a run token
+    uint8_t  width;      // packed block: bits per sample; 0 for tokens
+} StepDecoder;
+
+/* Start a new (empty) block */
+void stepCodec_begin(StepEncoder *enc, uint8_t *block);
+
+/* Continue appending to a block that already holds samples; false if it is corrupt */
+bool stepCodec_resume(StepEncoder *enc, uint8_t *block);
+
+/* Append one sample; false (block untouched) when it does not fit */
+bool stepCodec_append(StepEncoder *enc, uint32_t value);
+
+static inline uint8_t stepCodec_count(const uint8_t *block)
+{
+    return block[0] & ~STEP_CODEC_PACKED;
+}
+
+void stepCodec_decodeBegin(StepDecoder *dec, const uint8_t *block);
+
+/* Next sample, oldest first; false when the block is exhausted */
+bool stepCodec_decodeNext(StepDecoder *dec, uint32_t *value);
+
+/* Every sample the count promises decodes */
+bool stepCodec_intact(const uint8_t *block);
+
+#endif // STEP_CODEC_H
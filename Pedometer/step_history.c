@@ -0,0 +1,436 @@
+/*
+ * File:   step_history.c
+ *
+ * Tiered step history rings with incremental rollups.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "step_history.h"
+#include "step_index.h"
+
+#define SECONDS_PER_MINUTE  60
+#define MINUTES_PER_QUARTER 15
+#define QUARTERS_PER_DAY    96
+
+#define BLOCK_COUNT         (STEP_MINUTE_BLOCKS + STEP_QUARTER_BLOCKS + STEP_DAY_BLOCKS)
+#define CODED_TIERS         (STEP_TIER_COUNT - STEP_TIER_MINUTE)
+
+// Persistence chunk map: two state chunks, then one chunk per codec block
+#define CHUNK_STATE_RINGS   0
+#define CHUNK_STATE_OPEN    1
+#define CHUNK_BLOCK_FIRST   2
+#define CHUNK_LAYOUT        0x2A    // bumped whenever the chunk map changes
+#define RING_WRAPPED        0x8000  // head flag in CHUNK_STATE_RINGS
+
+typedef struct {
+    uint16_t head;   // SECOND: next slot to write, others: open block
+    uint16_t count;  // SECOND: closed buckets, others: blocks in use
+} StepRing;
+
+static struct {
+    uint8_t  second[STEP_SECOND_BUCKETS];
+    uint8_t  block[BLOCK_COUNT][STEP_CODEC_BLOCK_BYTES];
+
+    StepRing ring[STEP_TIER_COUNT];
+    uint16_t samples[STEP_TIER_COUNT];  // closed buckets held by a coded tier
+    StepEncoder enc[CODED_TIERS];       // appends to the open block of each coded tier
+
+    // Open (not yet closed) bucket of every tier
+    uint16_t secondSteps;
+    uint16_t minuteSteps;
+    uint16_t quarterSteps;
+    uint32_t daySteps;
+
+    uint8_t secondsInMinute;
+    uint8_t minutesInQuarter;
+    uint8_t quartersInDay;
+
+    uint16_t dirty[(STEP_CHUNK_COUNT + 15) / 16];
+} history;
+
+// Fails to compile if the rings outgrow the budget stated in the header
+typedef char stepHistoryBudgetCheck[(sizeof(history) <= STEP_HISTORY_RAM_BUDGET) ? 1 : -1];
+
+// Buckets closed per tier since init, wrapping; not part of the persisted state
+static uint16_t closedBuckets[STEP_TIER_COUNT];
+
+// Where each coded tier's blocks live in history.block
+static const uint16_t tierFirstBlock[STEP_TIER_COUNT] = {
+    0, 0, STEP_MINUTE_BLOCKS, STEP_MINUTE_BLOCKS + STEP_QUARTER_BLOCKS
+};
+
+static const uint16_t tierBlocks[STEP_TIER_COUNT] = {
+    0, STEP_MINUTE_BLOCKS, STEP_QUARTER_BLOCKS, STEP_DAY_BLOCKS
+};
+
+static const uint32_t tierSeconds[STEP_TIER_COUNT] = {
+    1UL, 60UL, 900UL, 86400UL
+};
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static uint8_t *tierBlock(StepTier tier, uint16_t index)
+{
+    return history.block[tierFirstBlock[tier] + index];
+}
+
+static uint16_t prevBlock(StepTier tier, uint16_t index)
+{
+    return (index == 0) ? tierBlocks[tier] - 1 : index - 1;
+}
+
+static uint16_t nextBlock(StepTier tier, uint16_t index)
+{
+    return (index + 1 == tierBlocks[tier]) ? 0 : index + 1;
+}
+
+/* Start an empty open block at index 0 of a coded tier */
+static void resetTier(StepTier tier)
+{
+    history.ring[tier].head = 0;
+    history.ring[tier].count = 1;
+    history.samples[tier] = 0;
+    stepCodec_begin(&history.enc[tier - STEP_TIER_MINUTE], tierBlock(tier, 0));
+}
+
+/* Append a closed bucket to a coded tier, opening a new block when it is full */
+static void pushSample(StepTier tier, uint32_t steps)
+{
+    StepRing *r = &history.ring[tier];
+    StepEncoder *enc = &history.enc[tier - STEP_TIER_MINUTE];
+
+    if (!stepCodec_append(enc, steps)) {
+        r->head = nextBlock(tier, r->head);
+        if (r->count < tierBlocks[tier])
+            r->count++;
+        else
+            history.samples[tier] -= stepCodec_count(tierBlock(tier, r->head));
+        stepCodec_begin(enc, tierBlock(tier, r->head));
+        (void) stepCodec_append(enc, steps);
+        stepHistory_markChunkDirty(CHUNK_STATE_RINGS);
+        stepIndex_blockOpened(tier, r->head);
+    } else {
+        stepIndex_append(tier, r->head, steps);
+    }
+    history.samples[tier]++;
+    closedBuckets[tier]++;
+    stepHistory_markChunkDirty(CHUNK_BLOCK_FIRST + tierFirstBlock[tier] + r->head);
+    stepHistory_markChunkDirty(CHUNK_STATE_OPEN);
+}
+
+void stepHistory_init(void)
+{
+    uint8_t *p = (uint8_t *)&history;
+    size_t i;
+    for (i = 0; i < sizeof(history); i++)
+        p[i] = 0;
+    for (i = 0; i < STEP_TIER_COUNT; i++)
+        closedBuckets[i] = 0;
+
+    resetTier(STEP_TIER_MINUTE);
+    resetTier(STEP_TIER_QUARTER);
+    resetTier(STEP_TIER_DAY);
+    stepIndex_rebuild(STEP_TIER_MINUTE);
+    stepIndex_rebuild(STEP_TIER_QUARTER);
+    stepIndex_rebuild(STEP_TIER_DAY);
+}
+
+void stepHistory_addSteps(uint16_t steps)
+{
+    uint32_t sum = (uint32_t)history.secondSteps + steps;
+    history.secondSteps = (sum > 0xFFFF) ? 0xFFFF : (uint16_t)sum;
+}
+
+void stepHistory_tick(void)
+{
+    StepRing *r = &history.ring[STEP_TIER_SECOND];
+    uint16_t steps = history.secondSteps;
+    history.secondSteps = 0;
+
+    history.second[r->head] = (steps > 0xFF) ? 0xFF : (uint8_t)steps;
+    r->head = (r->head + 1 == STEP_SECOND_BUCKETS) ? 0 : r->head + 1;
+    if (r->count < STEP_SECOND_BUCKETS)
+        r->count++;
+    closedBuckets[STEP_TIER_SECOND]++;
+
+    history.minuteSteps += steps;
+    if (++history.secondsInMinute < SECONDS_PER_MINUTE)
+        return;
+    history.secondsInMinute = 0;
+
+    pushSample(STEP_TIER_MINUTE, history.minuteSteps);
+    history.quarterSteps += history.minuteSteps;
+    history.minuteSteps = 0;
+    if (++history.minutesInQuarter < MINUTES_PER_QUARTER)
+        return;
+    history.minutesInQuarter = 0;
+
+    pushSample(STEP_TIER_QUARTER, history.quarterSteps);
+    history.daySteps += history.quarterSteps;
+    history.quarterSteps = 0;
+    if (++history.quartersInDay < QUARTERS_PER_DAY)
+        return;
+    history.quartersInDay = 0;
+
+    pushSample(STEP_TIER_DAY, history.daySteps);
+    history.daySteps = 0;
+}
+
+uint16_t stepHistory_count(StepTier tier)
+{
+    if (tier == STEP_TIER_SECOND)
+        return history.ring[tier].count;
+    return (tier < STEP_TIER_COUNT) ? history.samples[tier] : 0;
+}
+
+uint16_t stepHistory_closed(StepTier tier)
+{
+    return (tier < STEP_TIER_COUNT) ? closedBuckets[tier] : 0;
+}
+
+uint16_t stepHistory_capacity(StepTier tier)
+{
+    if (tier == STEP_TIER_SECOND)
+        return STEP_SECOND_BUCKETS;
+    return (tier < STEP_TIER_COUNT) ? tierBlocks[tier] * STEP_CODEC_MAX_SAMPLES : 0;
+}
+
+uint32_t stepHistory_bucketSeconds(StepTier tier)
+{
+    return (tier < STEP_TIER_COUNT) ? tierSeconds[tier] : 0;
+}
+
+uint32_t stepHistory_get(StepTier tier, uint16_t age)
+{
+    StepHistoryReader rd;
+
+    stepHistory_openReader(&rd, tier, age);
+    return stepHistory_readNext(&rd);
+}
+
+/*
+ * openReader: blocks are key frames, so seeking only walks the block
+ * counts back from the open block and then decodes inside one block
+ */
+void stepHistory_openReader(StepHistoryReader *rd, StepTier tier, uint16_t age)
+{
+    uint16_t held = stepHistory_count(tier);
+    uint16_t newer = 0;
+    uint16_t index;
+    uint32_t skipped;
+    uint8_t inBlock;
+
+    rd->tier = tier;
+    rd->missing = 0;
+    rd->remaining = 0;
+    if (tier >= STEP_TIER_COUNT)
+        return;
+    if (age >= held) {
+        rd->missing = age - held + 1;
+        if (held == 0)
+            return;
+        age = held - 1;
+    }
+    rd->remaining = age + 1;
+
+    if (tier == STEP_TIER_SECOND) {
+        index = history.ring[tier].head;
+        rd->slot = (index > age) ? index - 1 - age : index + STEP_SECOND_BUCKETS - 1 - age;
+        return;
+    }
+
+    index = history.ring[tier].head;
+    while (age >= newer + stepCodec_count(tierBlock(tier, index))) {
+        newer += stepCodec_count(tierBlock(tier, index));
+        index = prevBlock(tier, index);
+    }
+    rd->slot = index;
+    stepCodec_decodeBegin(&rd->dec, tierBlock(tier, index));
+    for (inBlock = stepCodec_count(tierBlock(tier, index)) - 1 - (age - newer); inBlock; inBlock--)
+        (void) stepCodec_decodeNext(&rd->dec, &skipped);
+}
+
+uint32_t stepHistory_readNext(StepHistoryReader *rd)
+{
+    uint32_t steps;
+
+    if (rd->missing) {
+        rd->missing--;
+        return 0;
+    }
+    if (rd->remaining == 0)
+        return 0;
+    rd->remaining--;
+
+    if (rd->tier == STEP_TIER_SECOND) {
+        steps = history.second[rd->slot];
+        rd->slot = (rd->slot + 1 == STEP_SECOND_BUCKETS) ? 0 : rd->slot + 1;
+        return steps;
+    }
+
+    while (!stepCodec_decodeNext(&rd->dec, &steps)) {
+        if (rd->slot == history.ring[rd->tier].head) {
+            rd->remaining = 0;
+            return 0;
+        }
+        rd->slot = nextBlock(rd->tier, rd->slot);
+        stepCodec_decodeBegin(&rd->dec, tierBlock(rd->tier, rd->slot));
+    }
+    return steps;
+}
+
+uint16_t stepHistory_tierBlocks(StepTier tier)
+{
+    return (tier < STEP_TIER_COUNT) ? tierBlocks[tier] : 0;
+}
+
+uint16_t stepHistory_headBlock(StepTier tier)
+{
+    return (tier < STEP_TIER_COUNT) ? history.ring[tier].head : 0;
+}
+
+/* Buckets in a block; 0 for blocks the ring has not reached yet */
+uint8_t stepHistory_blockSamples(StepTier tier, uint16_t index)
+{
+    if (tier == STEP_TIER_SECOND || tier >= STEP_TIER_COUNT || index >= tierBlocks[tier])
+        return 0;
+    if (history.ring[tier].count < tierBlocks[tier] && index > history.ring[tier].head)
+        return 0;
+    return stepCodec_count(tierBlock(tier, index));
+}
+
+const uint8_t *stepHistory_block(StepTier tier, uint16_t index)
+{
+    return tierBlock(tier, index);
+}
+
+void stepHistory_readChunk(uint16_t chunk, uint8_t *out)
+{
+    StepTier tier;
+    uint8_t i;
+
+    for (i = 0; i < STEP_CHUNK_BYTES; i++)
+        out[i] = 0;
+
+    if (chunk == CHUNK_STATE_RINGS) {
+        for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++) {
+            uint16_t head = history.ring[tier].head;
+            if (history.ring[tier].count == tierBlocks[tier])
+                head |= RING_WRAPPED;
+            put16(out + 2 * (tier - STEP_TIER_MINUTE), head);
+        }
+        out[9] = CHUNK_LAYOUT;
+    } else if (chunk == CHUNK_STATE_OPEN) {
+        put16(out + 0, history.quarterSteps);
+        put32(out + 2, history.daySteps);
+        out[6] = history.minutesInQuarter;
+        out[7] = history.quartersInDay;
+        out[9] = CHUNK_LAYOUT;
+    } else if (chunk < STEP_CHUNK_COUNT) {
+        for (i = 0; i < STEP_CHUNK_BYTES; i++)
+            out[i] = history.block[chunk - CHUNK_BLOCK_FIRST][i];
+    }
+}
+
+/* Restore one chunk; state from another layout or out of range is dropped */
+void stepHistory_writeChunk(uint16_t chunk, const uint8_t *in)
+{
+    StepTier tier;
+    uint8_t i;
+
+    if (chunk == CHUNK_STATE_RINGS) {
+        if (in[9] != CHUNK_LAYOUT)
+            return;
+        for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++) {
+            if ((get16(in + 2 * (tier - STEP_TIER_MINUTE)) & ~RING_WRAPPED) >= tierBlocks[tier])
+                return;
+        }
+        for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++) {
+            uint16_t head = get16(in + 2 * (tier - STEP_TIER_MINUTE));
+            history.ring[tier].head = head & ~RING_WRAPPED;
+            history.ring[tier].count = (head & RING_WRAPPED) ? tierBlocks[tier] : (head & ~RING_WRAPPED) + 1;
+        }
+    } else if (chunk == CHUNK_STATE_OPEN) {
+        if (in[9] != CHUNK_LAYOUT || in[6] >= MINUTES_PER_QUARTER || in[7] >= QUARTERS_PER_DAY)
+            return;
+        history.quarterSteps = get16(in + 0);
+        history.daySteps = get32(in + 2);
+        history.minutesInQuarter = in[6];
+        history.quartersInDay = in[7];
+    } else if (chunk < STEP_CHUNK_COUNT) {
+        for (i = 0; i < STEP_CHUNK_BYTES; i++)
+            history.block[chunk - CHUNK_BLOCK_FIRST][i] = in[i];
+    }
+}
+
+/* After the last writeChunk: recount the coded tiers and reopen their head blocks */
+void stepHistory_restoreComplete(void)
+{
+    StepTier tier;
+    uint16_t index, n;
+
+    for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++) {
+        StepRing *r = &history.ring[tier];
+
+        if (!stepCodec_resume(&history.enc[tier - STEP_TIER_MINUTE], tierBlock(tier, r->head))) {
+            resetTier(tier);
+            continue;
+        }
+        history.samples[tier] = 0;
+        index = r->head;
+        for (n = 0; n < r->count; n++) {
+            uint8_t *block = tierBlock(tier, index);
+            if (!stepCodec_intact(block))
+                block[0] = 0;       // corrupt: keep the ring, drop the block
+            history.samples[tier] += stepCodec_count(block);
+            index = prevBlock(tier, index);
+        }
+    }
+    for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++)
+        stepIndex_rebuild(tier);
+}
+
+void stepHistory_markChunkDirty(uint16_t chunk)
+{
+    if (chunk < STEP_CHUNK_COUNT)
+        history.dirty[chunk >> 4] |= (uint16_t)1 << (chunk & 15);
+}
+
+/* Hand out (and clear) the lowest dirty chunk; false when none is left */
+bool stepHistory_takeDirtyChunk(uint16_t *chunk)
+{
+    uint16_t w;
+    uint8_t b;
+
+    for (w = 0; w < sizeof(history.dirty) / sizeof(history.dirty[0]); w++) {
+        if (history.dirty[w] == 0)
+            continue;
+        for (b = 0; !(history.dirty[w] & ((uint16_t)1 << b)); b++)
+            ;
+        history.dirty[w] &= ~((uint16_t)1 << b);
+        *chunk = (w << 4) | b;
+        return true;
+    }
+    return false;
+}
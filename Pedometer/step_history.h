@@ -0,0 +1,101 @@
+/*
+ * File:   step_history.h
+ *
+ * Tiered step history. One ring per resolution; each tier is rolled up
+ * from the one below as it completes a bucket, so an update is O(1).
+ *
+ * SECOND is a plain uint8_t ring. MINUTE, QUARTER and DAY are rings of
+ * step_codec blocks, so how far back they reach depends on the data:
+ * quiet periods pack up to STEP_CODEC_MAX_SAMPLES buckets per block.
+ *
+ *   tier      bucket    storage              bytes   reach*   vs plain ring
+ *   SECOND    1 s       120 samples            120   2 minutes
+ *   MINUTE    1 min     200 blocks            2000   2.3 days    3.3x
+ *   QUARTER   15 min    210 blocks            2100   16 days     1.5x
+ *   DAY       1 day     158 blocks            1580   1.5 years   1.4x
+ *
+ * (*) on the synthetic month of tools/step_codec_bench.c; zero runs pack
+ * far tighter, noisy light activity less. The plain rings this replaced
+ * held 24 h, 7 days and 1 year in about the same RAM. Quarter and day
+ * totals mostly go into packed blocks, which never do worse than the
+ * uint16_t and uint32_t rings while a quarter stays under 8192 steps.
+ *
+ * RAM budget: STEP_HISTORY_RAM_BUDGET bytes for rings plus rollup state,
+ * checked at compile time in step_history.c.
+ *
+ * For persistence the codec blocks and the rollup state are the
+ * STEP_CHUNK_COUNT chunks of STEP_CHUNK_BYTES. Every chunk changed by a
+ * rollup is marked dirty until the journal takes it.
+ */
+
+#ifndef STEP_HISTORY_H
+#define STEP_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "step_codec.h"
+
+#define STEP_SECOND_BUCKETS     120
+#define STEP_MINUTE_BLOCKS      200
+#define STEP_QUARTER_BLOCKS     210
+#define STEP_DAY_BLOCKS         158
+
+#define STEP_HISTORY_RAM_BUDGET 6016
+
+#define STEP_CHUNK_BYTES        STEP_CODEC_BLOCK_BYTES
+#define STEP_CHUNK_COUNT        (2 + STEP_MINUTE_BLOCKS + STEP_QUARTER_BLOCKS + STEP_DAY_BLOCKS)
+
+typedef enum {
+    STEP_TIER_SECOND,
+    STEP_TIER_MINUTE,
+    STEP_TIER_QUARTER,
+    STEP_TIER_DAY,
+    STEP_TIER_COUNT
+} StepTier;
+
+/* Sequential reader, oldest requested bucket first */
+typedef struct {
+    StepTier    tier;
+    uint16_t    missing;    // requested buckets older than anything held
+    uint16_t    remaining;  // held buckets still to return
+    uint16_t    slot;       // SECOND: ring slot, others: block in the tier
+    StepDecoder dec;
+} StepHistoryReader;
+
+void stepHistory_init(void);
+
+/* Count steps into the bucket that is currently open */
+void stepHistory_addSteps(uint16_t steps);
+
+/* Close the current one-second bucket and roll it up the tiers */
+void stepHistory_tick(void);
+
+/* Closed buckets held by a tier, and the most it could ever hold */
+uint16_t stepHistory_count(StepTier tier);
+uint16_t stepHistory_capacity(StepTier tier);
+uint32_t stepHistory_bucketSeconds(StepTier tier);
+
+/* Buckets a tier has closed since init, wrapping: a change means new data */
+uint16_t stepHistory_closed(StepTier tier);
+
+/* Steps in a closed bucket; age 0 is the newest. 0 if not held. */
+uint32_t stepHistory_get(StepTier tier, uint16_t age);
+
+/* Read buckets age, age - 1, ... 0 in order; buckets not held read as 0 */
+void stepHistory_openReader(StepHistoryReader *rd, StepTier tier, uint16_t age);
+uint32_t stepHistory_readNext(StepHistoryReader *rd);
+
+/* Raw block access for step_index; blocks not in use read as empty */
+uint16_t stepHistory_tierBlocks(StepTier tier);
+uint16_t stepHistory_headBlock(StepTier tier);
+uint8_t stepHistory_blockSamples(StepTier tier, uint16_t index);
+const uint8_t *stepHistory_block(StepTier tier, uint16_t index);
+
+/* Persistence chunks */
+void stepHistory_readChunk(uint16_t chunk, uint8_t *out);
+void stepHistory_writeChunk(uint16_t chunk, const uint8_t *in);
+void stepHistory_restoreComplete(void);
+void stepHistory_markChunkDirty(uint16_t chunk);
+bool stepHistory_takeDirtyChunk(uint16_t *chunk);
+
+#endif // STEP_HISTORY_H
@@ -0,0 +1,297 @@
+/*
+ * File:   step_index.c
+ *
+ * Segment trees of bucket aggregates over the coded history tiers.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "step_index.h"
+
+#define SB                  STEP_INDEX_SUPERBLOCK
+#define LEAVES              STEP_INDEX_LEAVES
+#define CODED_TIERS         (STEP_TIER_COUNT - STEP_TIER_MINUTE)
+#define SATURATED           0xFFFF
+
+// Every block of the largest tier must fall on a leaf
+typedef char stepIndexLeafCheck[(LEAVES * SB >= STEP_MINUTE_BLOCKS &&
+                                 LEAVES * SB >= STEP_QUARTER_BLOCKS &&
+                                 LEAVES * SB >= STEP_DAY_BLOCKS) ? 1 : -1];
+
+/*
+ * Per tier a perfect binary tree: node 1 is the root, node LEAVES + i
+ * summarises blocks i * SB .. i * SB + SB - 1. Node 0 is unused.
+ */
+static StepAggregate tree[CODED_TIERS][2 * LEAVES];
+
+static StepAggregate *node(StepTier tier, uint16_t n)
+{
+    return &tree[tier - STEP_TIER_MINUTE][n];
+}
+
+static void aggClear(StepAggregate *a)
+{
+    a->sum = 0;
+    a->count = 0;
+    a->min = SATURATED;
+    a->max = 0;
+}
+
+static void aggAdd(StepAggregate *a, uint32_t steps)
+{
+    uint16_t v = (steps > SATURATED) ? SATURATED : (uint16_t)steps;
+
+    a->sum += steps;
+    a->count++;
+    if (v < a->min)
+        a->min = v;
+    if (v > a->max)
+        a->max = v;
+}
+
+static void aggMerge(StepAggregate *a, const StepAggregate *b)
+{
+    if (b->count == 0)
+        return;
+    a->sum += b->sum;
+    a->count += b->count;
+    if (b->min < a->min)
+        a->min = b->min;
+    if (b->max > a->max)
+        a->max = b->max;
+}
+
+/* Add samples first..last (0 = oldest in the block) of one block */
+static void aggBlock(StepAggregate *a, StepTier tier, uint16_t block, uint8_t first, uint8_t last)
+{
+    StepDecoder dec;
+    uint32_t steps;
+    uint8_t i = 0;
+
+    if (stepHistory_blockSamples(tier, block) == 0)
+        return;
+    stepCodec_decodeBegin(&dec, stepHistory_block(tier, block));
+    while (i <= last && stepCodec_decodeNext(&dec, &steps)) {
+        if (i >= first)
+            aggAdd(a, steps);
+        i++;
+    }
+}
+
+static void aggWholeBlock(StepAggregate *a, StepTier tier, uint16_t block)
+{
+    aggBlock(a, tier, block, 0, STEP_CODEC_MAX_SAMPLES - 1);
+}
+
+static void rebuildLeaf(StepTier tier, uint16_t leaf)
+{
+    StepAggregate *a = node(tier, LEAVES + leaf);
+    uint16_t block;
+
+    aggClear(a);
+    for (block = leaf * SB; block < leaf * SB + SB; block++)
+        aggWholeBlock(a, tier, block);
+}
+
+static void pullUp(StepTier tier, uint16_t n)
+{
+    StepAggregate *a = node(tier, n);
+
+    aggClear(a);
+    aggMerge(a, node(tier, 2 * n));
+    aggMerge(a, node(tier, 2 * n + 1));
+}
+
+static void propagate(StepTier tier, uint16_t leaf)
+{
+    uint16_t n;
+
+    for (n = (LEAVES + leaf) >> 1; n; n >>= 1)
+        pullUp(tier, n);
+}
+
+/* Aggregate of leaves lo..hi, bottom-up */
+static void aggLeaves(StepAggregate *a, StepTier tier, uint16_t lo, uint16_t hi)
+{
+    lo += LEAVES;
+    hi += LEAVES + 1;
+    while (lo < hi) {
+        if (lo & 1)
+            aggMerge(a, node(tier, lo++));
+        if (hi & 1)
+            aggMerge(a, node(tier, --hi));
+        lo >>= 1;
+        hi >>= 1;
+    }
+}
+
+static uint16_t leafCount(StepTier tier, uint16_t lo, uint16_t hi)
+{
+    StepAggregate a;
+
+    aggClear(&a);
+    aggLeaves(&a, tier, lo, hi);
+    return a.count;
+}
+
+/*
+ * Block holding bucket k of the tier in physical order (block 0 first),
+ * found by descending the tree on counts. *k becomes the index in the block.
+ */
+static uint16_t findBlock(StepTier tier, uint16_t *k)
+{
+    uint16_t n = 1;
+    uint16_t block;
+    uint8_t c;
+
+    while (n < LEAVES) {
+        if (*k < node(tier, 2 * n)->count) {
+            n = 2 * n;
+        } else {
+            *k -= node(tier, 2 * n)->count;
+            n = 2 * n + 1;
+        }
+    }
+    for (block = (n - LEAVES) * SB; block < (n - LEAVES) * SB + SB - 1; block++) {
+        c = stepHistory_blockSamples(tier, block);
+        if (*k < c)
+            break;
+        *k -= c;
+    }
+    return block;
+}
+
+/*
+ * Block and in-block index (0 = oldest) of the bucket at age. Newest first
+ * the ring runs: head block down to its leaf start, the whole leaves below,
+ * the whole leaves above (only once wrapped), the rest of the head leaf.
+ */
+static uint16_t locate(StepTier tier, uint16_t age, uint8_t *inBlock)
+{
+    uint16_t head = stepHistory_headBlock(tier);
+    uint16_t headLeaf = head / SB;
+    uint16_t last = stepHistory_tierBlocks(tier) - 1;
+    uint16_t block, n, k;
+    uint8_t c;
+
+    for (block = head; ; block--) {
+        c = stepHistory_blockSamples(tier, block);
+        if (age < c) {
+            *inBlock = c - 1 - age;
+            return block;
+        }
+        age -= c;
+        if (block == headLeaf * SB)
+            break;
+    }
+
+    n = (headLeaf > 0) ? leafCount(tier, 0, headLeaf - 1) : 0;
+    if (age < n) {
+        k = n - 1 - age;
+        block = findBlock(tier, &k);
+        *inBlock = (uint8_t)k;
+        return block;
+    }
+    age -= n;
+
+    n = node(tier, 1)->count - leafCount(tier, 0, headLeaf);
+    if (age < n) {
+        k = node(tier, 1)->count - 1 - age;
+        block = findBlock(tier, &k);
+        *inBlock = (uint8_t)k;
+        return block;
+    }
+    age -= n;
+
+    for (block = (headLeaf * SB + SB - 1 < last) ? headLeaf * SB + SB - 1 : last; block > head + 1; block--) {
+        c = stepHistory_blockSamples(tier, block);
+        if (age < c)
+            break;
+        age -= c;
+    }
+    c = stepHistory_blockSamples(tier, block);
+    *inBlock = (age < c) ? c - 1 - age : 0;
+    return block;
+}
+
+void stepIndex_rebuild(StepTier tier)
+{
+    uint16_t i;
+
+    if (tier == STEP_TIER_SECOND || tier >= STEP_TIER_COUNT)
+        return;
+    for (i = 0; i < LEAVES; i++)
+        rebuildLeaf(tier, i);
+    for (i = LEAVES - 1; i; i--)
+        pullUp(tier, i);
+}
+
+/* The leaf drops whatever the reused block held before */
+void stepIndex_blockOpened(StepTier tier, uint16_t block)
+{
+    rebuildLeaf(tier, block / SB);
+    propagate(tier, block / SB);
+}
+
+void stepIndex_append(StepTier tier, uint16_t block, uint32_t steps)
+{
+    aggAdd(node(tier, LEAVES + block / SB), steps);
+    propagate(tier, block / SB);
+}
+
+/*
+ * Whole leaves strictly between the two end blocks come from the tree;
+ * the ends and the blocks sharing their leaves are decoded (at most two
+ * superblocks). The head leaf mixes newest and oldest blocks, but it only
+ * ever sits at an end of the range.
+ */
+bool stepIndex_query(StepTier tier, uint16_t newestAge, uint16_t oldestAge, StepAggregate *out)
+{
+    uint16_t held = stepHistory_count(tier);
+    uint16_t last = stepHistory_tierBlocks(tier) - 1;
+    uint16_t headLeaf, oldest, newest, block, leaf, endLeaf;
+    StepHistoryReader rd;
+    uint8_t from, to;
+
+    aggClear(out);
+    if (oldestAge >= held)
+        oldestAge = held - 1;
+    if (held == 0 || newestAge > oldestAge)
+        return false;
+
+    if (tier == STEP_TIER_SECOND) {
+        stepHistory_openReader(&rd, tier, oldestAge);
+        for (from = 0; from <= oldestAge - newestAge; from++)
+            aggAdd(out, stepHistory_readNext(&rd));
+        return true;
+    }
+
+    oldest = locate(tier, oldestAge, &from);
+    newest = locate(tier, newestAge, &to);
+    if (oldest == newest) {
+        aggBlock(out, tier, oldest, from, to);
+        return true;
+    }
+    aggBlock(out, tier, oldest, from, STEP_CODEC_MAX_SAMPLES - 1);
+    aggBlock(out, tier, newest, 0, to);
+
+    headLeaf = stepHistory_headBlock(tier) / SB;
+    block = (oldest == last) ? 0 : oldest + 1;
+    while (block != newest) {
+        leaf = block / SB;
+        if (block == leaf * SB && leaf != newest / SB && leaf != headLeaf) {
+            endLeaf = (newest / SB == 0) ? last / SB : newest / SB - 1;
+            if (leaf <= endLeaf) {
+                aggLeaves(out, tier, leaf, endLeaf);
+            } else {
+                aggLeaves(out, tier, leaf, last / SB);
+                aggLeaves(out, tier, 0, endLeaf);
+            }
+            block = (newest / SB) * SB;
+            continue;
+        }
+        aggWholeBlock(out, tier, block);
+        block = (block == last) ? 0 : block + 1;
+    }
+    return true;
+}
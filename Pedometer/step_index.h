@@ -0,0 +1,45 @@
+/*
+ * File:   step_index.h
+ *
+ * Range aggregates (sum / min / max) over the coded history tiers.
+ *
+ * One segment tree per coded tier. A leaf summarises a superblock of
+ * STEP_INDEX_SUPERBLOCK codec blocks and is updated on every new bucket,
+ * so keeping the index costs O(log n) per bucket. A query walks the tree
+ * for whole superblocks and decodes only the blocks at its two ends.
+ * SECOND (120 plain samples) is scanned directly.
+ *
+ * Plain C with no UI dependency, so screens and any export path share it.
+ */
+
+#ifndef STEP_INDEX_H
+#define STEP_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "step_history.h"
+
+#define STEP_INDEX_SUPERBLOCK   8
+#define STEP_INDEX_LEAVES       32      // power of two covering the largest tier
+
+typedef struct {
+    uint32_t sum;
+    uint16_t count;     // buckets aggregated
+    uint16_t min;       // min / max saturate at 0xFFFF
+    uint16_t max;
+} StepAggregate;
+
+/* Rebuild a tier's tree from its blocks (init, after a journal restore) */
+void stepIndex_rebuild(StepTier tier);
+
+/* Kept current by step_history: a block was (re)opened, a bucket was appended */
+void stepIndex_blockOpened(StepTier tier, uint16_t block);
+void stepIndex_append(StepTier tier, uint16_t block, uint32_t steps);
+
+/*
+ * Aggregate of the closed buckets newestAge..oldestAge (age 0 = newest).
+ * The range is clipped to what the tier holds; false if nothing is left.
+ */
+bool stepIndex_query(StepTier tier, uint16_t newestAge, uint16_t oldestAge, StepAggregate *out);
+
+#endif // STEP_INDEX_H
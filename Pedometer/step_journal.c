@@ -0,0 +1,476 @@
+/*
+ * File:   step_journal.c
+ *
+ * Log-structured step journal in program flash (PIC24FJ256GA705 RTSP).
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "step_journal.h"
+#include "step_history.h"
+
+// Flash geometry, in program-counter units (2 per instruction word)
+#define JOURNAL_PAGES       16
+#define JOURNAL_BASE        0x22800UL   // ends below the configuration-word page
+#define PAGE_PC             0x800UL     // 1024 instructions
+#define ROW_PC              0x100UL     // 128 instructions
+#define ROWS_PER_PAGE       8
+
+#define RECORD_WORDS        8
+#define RECORDS_PER_ROW     16
+#define RECORDS_PER_PAGE    (RECORDS_PER_ROW * ROWS_PER_PAGE)
+#define ERASED_KEY          0xFFFF
+#define SUMMARY_KEY         0xFFFE      // page summary, see step_journal.h
+#define NO_PAGE             0xFF
+
+#define COMMIT_SECONDS      300     // dirty chunks are appended every 5 minutes
+#define FLUSH_SECONDS       1800    // a part-filled row is programmed after 30 minutes
+
+#define NVMCON_PAGE_ERASE   0x4003  // WREN, NVMOP = page erase
+#define NVMCON_ROW_PROGRAM  0x4202  // WREN, RPDF (compressed RAM data), NVMOP = row program
+
+// Keeps the linker from placing code in the journal pages
+static const uint16_t journalArea[JOURNAL_PAGES * 1024]
+    __attribute__((space(prog), address(JOURNAL_BASE), noload));
+
+// One row in the compressed RAM format: instruction pair n is stored as
+// { LSW(2n), MSB(2n+1):MSB(2n), LSW(2n+1) }. Also the "seen" bitmap at mount.
+static uint16_t rowBuf[RECORDS_PER_ROW * RECORD_WORDS * 3 / 2];
+
+static struct {
+    uint32_t base;
+    uint16_t nextSeq;
+    uint16_t secondsSinceCommit;
+    uint16_t rowAge;          // seconds since rowBuf got its first record
+    uint8_t  headPage;
+    uint8_t  headRow;         // row rowBuf will be programmed to
+    uint8_t  rowFill;         // records in rowBuf
+    uint8_t  recyclePage;     // page whose chunks are being carried forward
+    uint8_t  erasePage;       // page waiting for an idle-time erase
+    uint8_t  tornRows;        // rows of the head page a power cut left torn, one bit each
+    bool     mounted;
+} journal;
+
+// Page holding the newest record of each chunk, one nibble per chunk
+static uint8_t latestPage[(STEP_CHUNK_COUNT + 1) / 2];
+
+static StepJournalStats stats;
+
+typedef char stepJournalRecordCheck[(STEP_CHUNK_BYTES == 2 * (RECORD_WORDS - 3)) ? 1 : -1];
+
+/*--- crc16: CRC-16/CCITT (0x1021) over little-endian words, nibble table ---*/
+static uint16_t crc16(const uint16_t *w, uint8_t words)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    uint16_t crc = 0xFFFF;
+    uint8_t i, b, byte;
+
+    for (i = 0; i < words; i++) {
+        for (b = 0; b < 2; b++) {
+            byte = (uint8_t)(w[i] >> (8 * b));
+            crc = (crc << 4) ^ table[(crc >> 12) ^ (byte >> 4)];
+            crc = (crc << 4) ^ table[(crc >> 12) ^ (byte & 0x0F)];
+        }
+    }
+    return crc;
+}
+
+static uint8_t getLatestPage(uint16_t chunk)
+{
+    return (chunk & 1) ? latestPage[chunk >> 1] >> 4 : latestPage[chunk >> 1] & 0x0F;
+}
+
+static void setLatestPage(uint16_t chunk, uint8_t page)
+{
+    uint8_t *p = &latestPage[chunk >> 1];
+    *p = (chunk & 1) ? (*p & 0x0F) | (page << 4) : (*p & 0xF0) | page;
+}
+
+static uint8_t nextPage(uint8_t page)
+{
+    return (page + 1 == JOURNAL_PAGES) ? 0 : page + 1;
+}
+
+static uint32_t slotAddress(uint8_t page, uint8_t slot)
+{
+    return journal.base + page * PAGE_PC + (uint32_t)slot * RECORD_WORDS * 2;
+}
+
+static uint16_t readWord(uint32_t address)
+{
+    TBLPAG = (uint16_t)(address >> 16);
+    return __builtin_tblrdl((uint16_t)address);
+}
+
+static uint16_t readKey(uint8_t page, uint8_t slot)
+{
+    return readWord(slotAddress(page, slot) + 2);
+}
+
+static void readRecordWords(uint8_t page, uint8_t slot, uint16_t *w)
+{
+    uint32_t address = slotAddress(page, slot);
+    uint8_t i;
+
+    for (i = 0; i < RECORD_WORDS; i++)
+        w[i] = readWord(address + 2 * i);
+}
+
+/* True when a record holds a chunk or a page summary and its CRC matches */
+static bool recordValid(const uint16_t *w)
+{
+    stats.recordsChecked++;
+    return (w[1] < STEP_CHUNK_COUNT || w[1] == SUMMARY_KEY) &&
+           crc16(w, RECORD_WORDS - 1) == w[RECORD_WORDS - 1];
+}
+
+static bool readRecord(uint8_t page, uint8_t slot, uint16_t *w)
+{
+    readRecordWords(page, slot, w);
+    return recordValid(w);
+}
+
+
+/*
+ * Every word, not just the keys: a row program torn before its first key
+ * or an erase cut short leaves words that must not be programmed again
+ */
+static bool rowErased(uint8_t page, uint8_t row)
+{
+    uint32_t address = journal.base + page * PAGE_PC + row * ROW_PC;
+    uint16_t i;
+
+    for (i = 0; i < ROW_PC; i += 2) {
+        if (readWord(address + i) != 0xFFFF)
+            return false;
+    }
+    return true;
+}
+
+static bool pageErased(uint8_t page)
+{
+    uint8_t row;
+
+    for (row = 0; row < ROWS_PER_PAGE; row++) {
+        if (!rowErased(page, row))
+            return false;
+    }
+    return true;
+}
+
+/*--- nvmExecute: run one NVM operation; the CPU stalls until it is done ---*/
+static void nvmExecute(uint16_t nvmcon, uint32_t address)
+{
+    NVMADRU = (uint16_t)(address >> 16);
+    NVMADR = (uint16_t)address;
+    NVMCON = nvmcon;
+    __builtin_write_NVM();      // unlock sequence + WR, interrupts held off
+    while (NVMCONbits.WR)
+        ;
+    NVMCONbits.WREN = 0;
+}
+
+static void eraseNow(uint8_t page)
+{
+    nvmExecute(NVMCON_PAGE_ERASE, journal.base + page * PAGE_PC);
+    stats.pagesErased++;
+    if (journal.erasePage == page)
+        journal.erasePage = NO_PAGE;
+}
+
+static void clearRowBuf(void)
+{
+    uint16_t i;
+    for (i = 0; i < sizeof(rowBuf) / sizeof(rowBuf[0]); i++)
+        rowBuf[i] = 0xFFFF;
+}
+
+static void putRowWord(uint8_t index, uint16_t value)
+{
+    uint8_t pair = index >> 1;
+    rowBuf[3 * pair + ((index & 1) ? 2 : 0)] = value;
+}
+
+/*--- flushRow: program rowBuf to the head row, erased slots pad a part-filled row ---*/
+static void flushRow(void)
+{
+    if (journal.rowFill == 0)
+        return;
+
+    NVMSRCADRL = (uint16_t)rowBuf;
+    NVMSRCADRH = 0;
+    nvmExecute(NVMCON_ROW_PROGRAM,
+               journal.base + journal.headPage * PAGE_PC + journal.headRow * ROW_PC);
+    stats.rowsProgrammed++;
+
+    clearRowBuf();
+    journal.rowFill = 0;
+    journal.rowAge = 0;
+    journal.headRow++;
+}
+
+/* Number, seal and queue a record for the head row; words 1-6 are filled in */
+static void putRecord(uint16_t *w)
+{
+    uint8_t i;
+
+    w[0] = journal.nextSeq++;
+    w[RECORD_WORDS - 1] = crc16(w, RECORD_WORDS - 1);
+    for (i = 0; i < RECORD_WORDS; i++)
+        putRowWord(journal.rowFill * RECORD_WORDS + i, w[i]);
+
+    if (++journal.rowFill == RECORDS_PER_ROW)
+        flushRow();
+}
+
+/* Mark the chunks whose newest record is in a page dirty so they are re-appended from RAM */
+static void carryForward(uint8_t page)
+{
+    uint8_t slot;
+    uint16_t key;
+
+    for (slot = 0; slot < RECORDS_PER_PAGE; slot++) {
+        key = readKey(page, slot);
+        if (key < STEP_CHUNK_COUNT && getLatestPage(key) == page)
+            stepHistory_markChunkDirty(key);
+    }
+}
+
+/*--- openNextPage: move the head to the next (erased) page, start recycling the one after ---*/
+static void openNextPage(void)
+{
+    uint8_t page = nextPage(journal.headPage);
+    uint8_t upcoming = nextPage(page);
+    uint16_t w[RECORD_WORDS];
+    uint8_t i;
+
+    if (journal.recyclePage == page)
+        journal.recyclePage = NO_PAGE;     // its chunks are already marked dirty
+    else if (journal.erasePage != page && !pageErased(page))
+        carryForward(page);
+    if (journal.erasePage == page || !pageErased(page)) {
+        eraseNow(page);
+        stats.syncErases++;
+    }
+
+    journal.headPage = page;
+    journal.headRow = 0;
+
+    // The page just left is sealed; tell mount which of its rows still need a CRC
+    w[1] = SUMMARY_KEY;
+    w[2] = journal.tornRows;
+    for (i = 3; i < RECORD_WORDS - 1; i++)
+        w[i] = 0xFFFF;
+    putRecord(w);
+    journal.tornRows = 0;
+
+    // Keep one page erased ahead of the head
+    if (journal.recyclePage == NO_PAGE && journal.erasePage != upcoming && !pageErased(upcoming)) {
+        carryForward(upcoming);
+        journal.recyclePage = upcoming;
+    }
+}
+
+static void appendChunk(uint16_t chunk)
+{
+    uint16_t w[RECORD_WORDS];
+    uint8_t payload[STEP_CHUNK_BYTES];
+    uint8_t i;
+
+    if (journal.rowFill == 0 && journal.headRow == ROWS_PER_PAGE)
+        openNextPage();
+
+    stepHistory_readChunk(chunk, payload);
+    w[1] = chunk;
+    for (i = 0; i < STEP_CHUNK_BYTES / 2; i++)
+        w[2 + i] = (uint16_t)payload[2 * i] | ((uint16_t)payload[2 * i + 1] << 8);
+    setLatestPage(chunk, journal.headPage);
+    stats.recordsWritten++;
+    putRecord(w);
+}
+
+/*--- commit: append all dirty chunks, then hand a fully carried-forward page to idle erase ---*/
+static void commit(void)
+{
+    uint16_t chunk;
+
+    while (stepHistory_takeDirtyChunk(&chunk))
+        appendChunk(chunk);
+
+    if (journal.recyclePage != NO_PAGE) {
+        flushRow();     // the carried-forward copies must be in flash before the erase
+        if (journal.erasePage != NO_PAGE)
+            eraseNow(journal.erasePage);
+        journal.erasePage = journal.recyclePage;
+        journal.recyclePage = NO_PAGE;
+    }
+    journal.secondsSinceCommit = 0;
+}
+
+/*--- mountFresh: no valid page found, start an empty log at page 0 ---*/
+static void mountFresh(void)
+{
+    uint8_t page;
+
+    for (page = 0; page < JOURNAL_PAGES; page++) {
+        if (!pageErased(page))
+            eraseNow(page);
+    }
+    journal.headPage = 0;
+    journal.headRow = 0;
+    journal.nextSeq = 0;
+    journal.tornRows = 0;
+}
+
+void stepJournal_mount(StepJournalClock millis)
+{
+    uint32_t start = millis();
+    uint16_t firstSeq[JOURNAL_PAGES];
+    uint8_t summary[JOURNAL_PAGES];     // torn rows of the page before, from each page's summary
+    uint16_t validPages = 0;
+    uint16_t w[RECORD_WORDS];
+    uint8_t payload[STEP_CHUNK_BYTES];
+    uint8_t page, after, head, slot, k, i, checkRows, rowBit;
+
+    journal.base = ((uint32_t)__builtin_tblpage(journalArea) << 16) | __builtin_tbloffset(journalArea);
+    journal.recyclePage = NO_PAGE;
+    journal.erasePage = NO_PAGE;
+    journal.rowFill = 0;
+    journal.tornRows = 0;
+
+    // Index scan: the first record of each page orders the pages
+    for (page = 0; page < JOURNAL_PAGES; page++) {
+        summary[page] = 0xFF;
+        if (readRecord(page, 0, w)) {
+            validPages |= 1U << page;
+            firstSeq[page] = w[0];
+            if (w[1] == SUMMARY_KEY)
+                summary[page] = (uint8_t)w[2];
+        }
+    }
+
+    if (validPages == 0) {
+        mountFresh();
+    } else {
+        // Head: a valid page followed by an erased or older one
+        head = 0;
+        for (page = 0; page < JOURNAL_PAGES; page++) {
+            after = nextPage(page);
+            if ((validPages & (1U << page)) &&
+                (!(validPages & (1U << after)) || (int16_t)(firstSeq[after] - firstSeq[page]) < 0)) {
+                head = page;
+                break;
+            }
+        }
+
+        // Rows are programmed in order; the head row is the first one left fully erased
+        journal.headPage = head;
+        for (journal.headRow = 1; journal.headRow < ROWS_PER_PAGE; journal.headRow++) {
+            if (rowErased(head, journal.headRow))
+                break;
+        }
+
+        // Replay newest first; the first record seen for a chunk is its latest
+        clearRowBuf();
+        for (i = 0; i < (STEP_CHUNK_COUNT + 15) / 16; i++)
+            rowBuf[i] = 0;
+        journal.nextSeq = firstSeq[head];
+        for (k = 0; k < JOURNAL_PAGES; k++) {
+            page = (head + JOURNAL_PAGES - k) % JOURNAL_PAGES;
+            if (!(validPages & (1U << page)))
+                continue;
+
+            // A sealed page needs a CRC only in the rows its successor's summary flags;
+            // the head page (torn rows not yet recorded) and the oldest (maybe part-erased) need all
+            after = nextPage(page);
+            checkRows = 0xFF;
+            if (page != head && page != nextPage(head) && (validPages & (1U << after)) &&
+                (int16_t)(firstSeq[after] - firstSeq[page]) > 0)
+                checkRows = summary[after];
+
+            for (slot = RECORDS_PER_PAGE; slot-- > 0;) {
+                uint16_t key = readKey(page, slot);
+                bool skip;
+
+                if (key == ERASED_KEY)
+                    continue;
+                stats.recordsScanned++;
+                skip = key >= STEP_CHUNK_COUNT || (rowBuf[key >> 4] & (1U << (key & 15)));
+                if (skip && page != head)
+                    continue;
+                readRecordWords(page, slot, w);
+                rowBit = 1U << (slot / RECORDS_PER_ROW);
+                if ((checkRows & rowBit) && !recordValid(w)) {
+                    stats.crcErrors++;
+                    if (page == head)
+                        journal.tornRows |= rowBit;
+                    continue;
+                }
+                if (page == head && (int16_t)(w[0] - journal.nextSeq) >= 0)
+                    journal.nextSeq = w[0] + 1;
+                if (skip)
+                    continue;
+                rowBuf[key >> 4] |= 1U << (key & 15);
+                setLatestPage(key, page);
+                for (i = 0; i < STEP_CHUNK_BYTES / 2; i++) {
+                    payload[2 * i] = (uint8_t)w[2 + i];
+                    payload[2 * i + 1] = (uint8_t)(w[2 + i] >> 8);
+                }
+                stepHistory_writeChunk(key, payload);
+                stats.chunksRestored++;
+            }
+        }
+        clearRowBuf();
+        stepHistory_restoreComplete();
+
+        // The page after the head may still hold the oldest chunks
+        page = nextPage(head);
+        if (!pageErased(page)) {
+            carryForward(page);
+            journal.recyclePage = page;
+        }
+    }
+
+    clearRowBuf();
+    journal.secondsSinceCommit = 0;
+    journal.rowAge = 0;
+    journal.mounted = true;
+    stats.mountMs = (uint16_t)(millis() - start);
+}
+
+void stepJournal_tick(void)
+{
+    if (!journal.mounted)
+        return;
+    if (journal.rowFill)
+        journal.rowAge++;
+    if (++journal.secondsSinceCommit >= COMMIT_SECONDS)
+        commit();
+}
+
+void stepJournal_idle(void)
+{
+    if (!journal.mounted)
+        return;
+    if (journal.erasePage != NO_PAGE)
+        eraseNow(journal.erasePage);
+    else if (journal.rowFill && journal.rowAge >= FLUSH_SECONDS)
+        flushRow();
+}
+
+void stepJournal_sync(void)
+{
+    if (!journal.mounted)
+        return;
+    commit();
+    flushRow();
+}
+
+void stepJournal_getStats(StepJournalStats *out)
+{
+    *out = stats;
+}
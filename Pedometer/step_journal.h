@@ -0,0 +1,62 @@
+/*
+ * File:   step_journal.h
+ *
+ * Persistent step journal in on-chip program flash.
+ *
+ * The journal is a log of fixed 16-byte records, each carrying one
+ * step-history chunk (see step_history.h), a sequence number and a CRC.
+ * Chunks are step_codec blocks, so the flash copy is as compact as RAM.
+ * A chunk is rewritten by appending a new record; the newest record of a
+ * chunk wins. The log runs round-robin over JOURNAL_PAGES erase pages, so
+ * every page is erased once per lap (wear levelling). Before a page is
+ * reused, the chunks it still carries are re-appended from RAM.
+ *
+ *   record   word 0    sequence number
+ *            word 1    chunk index (0xFFFF = erased slot)
+ *            word 2-6  chunk payload (STEP_CHUNK_BYTES)
+ *            word 7    CRC-16/CCITT over words 0-6
+ *
+ * The first record of each page is a page summary (chunk index 0xFFFE)
+ * whose word 2 flags the rows of the previous page that a power cut left
+ * torn. Mount checks the CRC of every record in the head page and the
+ * oldest page, but in the other pages only in the flagged rows.
+ *
+ * Only the low 16 bits of each 24-bit instruction word carry data.
+ * Records are collected in a RAM row buffer and programmed a whole row
+ * (16 records) at a time; page erases are deferred to stepJournal_idle().
+ */
+
+#ifndef STEP_JOURNAL_H
+#define STEP_JOURNAL_H
+
+#include <stdint.h>
+
+typedef uint32_t (*StepJournalClock)(void);    // milliseconds
+
+typedef struct {
+    uint16_t recordsWritten;
+    uint16_t rowsProgrammed;
+    uint16_t pagesErased;
+    uint16_t syncErases;     // erases that could not wait for idle time
+    uint16_t recordsScanned; // at mount
+    uint16_t chunksRestored; // at mount
+    uint16_t crcErrors;      // at mount
+    uint16_t recordsChecked; // at mount, CRCs computed
+    uint16_t mountMs;        // at mount, including the history restore
+} StepJournalStats;
+
+/* Locate the log head and replay it into step history (call after stepHistory_init); millis times it */
+void stepJournal_mount(StepJournalClock millis);
+
+/* Once per closed one-second history bucket: commits dirty chunks periodically */
+void stepJournal_tick(void);
+
+/* From the main loop when nothing else is pending: deferred erase and row flush */
+void stepJournal_idle(void);
+
+/* Append every dirty chunk and program the open row now (e.g. before power-down) */
+void stepJournal_sync(void);
+
+void stepJournal_getStats(StepJournalStats *stats);
+
+#endif // STEP_JOURNAL_H
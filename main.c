@@ -3,19 +3,27 @@
  ******************************************************************************/
 #include <xc.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 
 // Adjust includes to your project structure
 #include "System/system.h"
 #include "oledDriver/oledC.h"
 #include "oledDriver/oledC_shapes.h"
+#include "oledDriver/oledC_segments.h"
+#include "oledDriver/oledC_framebuffer.h"
+#include "oledDriver/oledC_compositor.h"
+#include "oledDriver/oledC_renderTask.h"
 #include "oledDriver/oledC_colors.h"
 #include "System/delay.h"
 #include "Accel_i2c.h"
+#include "Accel_tap.h"
+#include "Pedometer/step_history.h"
+#include "Pedometer/step_index.h"
+#include "Pedometer/step_journal.h"
 
 /*******************************************************************************
  * MACROS & CONSTANTS
@@ -59,7 +67,24 @@
 #define OPT24H_Y       40
 #define OPT24H_WIDTH   35
 #define OPT24H_HEIGHT  30
-#define GRAPH_SAMPLES 90
+#define GRAPH_X_START  20
+#define GRAPH_COLUMNS  76   // x = 20..95, one value per column
+#define GRAPH_BASELINE 95   // y of the x-axis
+#define GRAPH_MAX_PACE 100  // pace at the top of the graph
+#define GRID_DASH      3    // dashed grid lines: pixels on, then off
+#define GRID_GAP       2
+#define GRID_MARK_STEP 10   // 2x2 x-axis markers
+#define SLIDE_ROWS     8    // rows the screen moves per step entering the menu
+#define SLIDE_DELAY    15   // milliseconds between steps
+#define FRAME_INTERVAL 50   // milliseconds per render frame (20 fps)
+#define DIGIT_GAP      2    // between the two seven-segment digits of a field
+
+// Change bits posted to the render task
+#define RENDER_CLOCK   0x0001   // time or date ticked
+#define RENDER_PACE    0x0002   // pace, foot icon or walking state
+#define RENDER_INPUT   0x0004   // menu highlight or a value being edited
+#define RENDER_GRAPH   0x0008   // step history closed a sample
+#define RENDER_SPAN    0x0010   // graph time span changed
 // For pedometer threshold, step array, etc.
 #define STEP_THRESHOLD         500  // Adjust based on testing
 #define SCREEN_UPDATE_INTERVAL 1000 // Update display every 1 second
@@ -73,7 +98,6 @@ static volatile uint32_t msCounter = 0;  // Global milliseconds counter (Timer1)
 // Timer & button globals
 static bool s1Pressed = false;           
 static uint32_t lastPressTimeS1 = 0;     
-static uint32_t lastMovementTime = 0;
 static uint32_t lastStepTime = 0;
 
 // Time & Date globals (Watch Display)
@@ -84,6 +108,12 @@ static uint8_t day = 1;
 static uint8_t month = 1;
 static char ampmStr[3] = "PM"; // "AM"/"PM" or "" for 24H
 
+// Values being edited by the config screens, drawn by their compose callbacks
+static uint8_t newHour, newMinute;
+static uint8_t newDay, newMonth;
+static uint8_t activeField = 0;
+static bool currentFormat = true; // true => 12H, false => 24H
+
 // Watch/ Menu states
 typedef enum {
     STATE_TIME_DISPLAY, // Normal watch mode
@@ -112,14 +142,6 @@ static const char* menuItems[] = {
 
 // Clock display parameters structure
 typedef struct {
-    // Old values (for partial-update comparison)
-    uint8_t oldHours;
-    uint8_t oldMinutes;
-    uint8_t oldSeconds;
-    uint8_t oldDay;
-    uint8_t oldMonth;
-    char oldAmPm[3];
-
     // Positions/scales
     int hourX, hourY, hourScale;
     int minX,  minY,  minScale;
@@ -129,32 +151,27 @@ typedef struct {
 
     // Whether or not to show date
     bool showDate;
+
+    // Seven-segment hours, minutes and seconds, or NULL for font text
+    const oledc_segment_style_t *digits;
 } ClockDisplayParams;
 
+// 12 + 2 + 12 px per field and 9 px per colon: HH:MM:SS spans all 96 columns
+static const oledc_segment_style_t watchDigits = { 12, 23, 3 };
+
 // Watch mode display parameters
 static ClockDisplayParams watchDisplay = {
-    .oldHours = 99,
-    .oldMinutes = 99,
-    .oldSeconds = 99,
-    .oldDay = 99,
-    .oldMonth = 99,
-    .oldAmPm = "XX",
     .hourX = 0,  .hourY = 30, .hourScale = 2,
-    .minX  = 36, .minY  = 30, .minScale  = 2,
-    .secX  = 72, .secY  = 30, .secScale  = 2,
+    .minX  = 35, .minY  = 30, .minScale  = 2,
+    .secX  = 70, .secY  = 30, .secScale  = 2,
     .ampmX = 10, .ampmY = 65, .ampmScale = 1,
     .dateX = 60, .dateY = 65, .dateScale = 1,
-    .showDate = true
+    .showDate = true,
+    .digits = &watchDigits
 };
 
 // Menu mode display parameters
 static ClockDisplayParams menuDisplay = {
-    .oldHours = 99,
-    .oldMinutes = 99,
-    .oldSeconds = 99,
-    .oldDay = 0,
-    .oldMonth = 0,
-    .oldAmPm = "XX",
     .hourX = 45 - MENU_CLOCK_MARGIN_RIGHT, .hourY = 2, .hourScale = 1,
     .minX  = 63 - MENU_CLOCK_MARGIN_RIGHT, .minY  = 2, .minScale  = 1,
     .secX  = 81 - MENU_CLOCK_MARGIN_RIGHT, .secY  = 2, .secScale  = 1,
@@ -167,19 +184,46 @@ static ClockDisplayParams menuDisplay = {
  * PEDOMETER / FOOT ICON
  ******************************************************************************/
 static bool footToggle = false;
-static bool movementDetected = false;
 static uint32_t currentPace = 0;  // steps per minute
 static uint32_t decayTimer = 0;
-
-// Two foot bitmaps (16x16) for animation
-static const uint16_t foot1Bitmap[16] = {
-    0x7800, 0xF800, 0xFC00, 0xFC00, 0xFC00, 0x7C1E, 0x783E, 0x047F,
-    0x3F9F, 0x1F3E, 0x0C3E, 0x003E, 0x0004, 0x00F0, 0x01F0, 0x00E0
+static uint32_t lastPedometerUpdate = 0;
+static uint32_t shownPace = 0;    // paceSignature() of the last RENDER_PACE
+
+// Two foot icons (16x16) for animation
+// foot1Icon: 16x16, converted with tools/rle_convert.c
+static const uint8_t foot1IconRuns[] = {
+    OLEDC_RLE_RUN(0, 1), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 6), OLEDC_RLE_RUN(1, 1),
+    OLEDC_RLE_RUN(0, 3), OLEDC_RLE_RUN(1, 7), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 7),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 3), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 2),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 14), OLEDC_RLE_RUN(1, 1), OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 12), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5)
 };
-static const uint16_t foot2Bitmap[16] = {
-    0x001E, 0x003F, 0x003F, 0x007F, 0x003F, 0x383E, 0x7C1E, 0x7E10,
-    0x7E7C, 0x7E78, 0x7C30, 0x3C00, 0x2000, 0x1E00, 0x1F00, 0x0E00
+static const uint16_t foot1IconColors[] = { 0x0000, 0xFFFF };
+static const oledc_rle_image_t foot1Icon = { 16, 16, 2, foot1IconColors, foot1IconRuns };
+// foot2Icon: 16x16, converted with tools/rle_convert.c
+static const uint8_t foot2IconRuns[] = {
+    OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 9), OLEDC_RLE_RUN(1, 7),
+    OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 1), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 3), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 2), OLEDC_RLE_RUN(0, 6), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 12), OLEDC_RLE_RUN(1, 1), OLEDC_RLE_RUN(0, 16), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 12), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 12), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 9)
 };
+static const uint16_t foot2IconColors[] = { 0x0000, 0xFFFF };
+static const oledc_rle_image_t foot2Icon = { 16, 16, 2, foot2IconColors, foot2IconRuns };
 
 /*******************************************************************************
  * STEP-COUNTING DATA
@@ -189,34 +233,64 @@ static uint32_t stepCount = 0;
 static uint32_t stepArray[STEP_ARRAY_SIZE] = {0};
 static uint8_t stepIndex = 0;
 static uint32_t totalSteps = 0;
-static uint32_t prevPaceDisplay = 0;
 
 /*******************************************************************************
- * GRAPH DATA ARRAYS (90 SAMPLES FOR 2 MINUTES)
+ * GRAPH TIME SPANS (tap cycles through them)
  ******************************************************************************/
-static int stepsHistory[90] = {0};     // raw pace data
-static int smoothedSteps[90] = {0};    // smoothed
-static uint8_t stepsHistoryIndex = 0;  // circular index
+typedef struct {
+    StepTier tier;     // history tier the span is read from
+    uint16_t buckets;  // how many buckets of that tier the span covers
+    const char *label;
+} GraphSpan;
+
+static const GraphSpan graphSpans[] = {
+    { STEP_TIER_SECOND,  120,  "2m"  },
+    { STEP_TIER_MINUTE,  60,   "1h"  },
+    { STEP_TIER_MINUTE,  1440, "24h" },
+    { STEP_TIER_QUARTER, 672,  "7d"  },
+    { STEP_TIER_DAY,     366,  "1y"  }
+};
+#define GRAPH_SPAN_COUNT (sizeof(graphSpans) / sizeof(graphSpans[0]))
+static uint8_t graphSpanIndex = 0;
+static uint32_t lastHistoryTick = 0;
+
+// y of the dashed grid lines, top to bottom
+static const uint8_t gridLines[] = { 5, 35, 65, GRAPH_BASELINE };
+
+/*
+ * Live graph: one sample per column, written as a sweep. The newest sample
+ * overwrites the oldest column and the column after it is left blank as
+ * the cursor, so each new sample repaints four columns whatever the span.
+ */
+typedef struct {
+    uint8_t  columns;     // samples in the ring, right-aligned on the panel
+    uint8_t  perColumn;   // history buckets averaged into one sample
+    uint8_t  newest;      // slot of the newest sample; the next slot is the cursor
+    uint16_t closed;      // stepHistory_closed() when the newest sample was taken
+    uint16_t pace[GRAPH_COLUMNS];
+} LiveGraph;
+
+static LiveGraph graph;
 
 /*******************************************************************************
  * FUNCTION PROTOTYPES
  ******************************************************************************/
 void haltOnError(const char *errorMsg);
 int16_t readAxisValue(uint8_t regAddr);
-void drawFootIcon(uint8_t x, uint8_t y, const uint16_t *bitmap,
-                  uint8_t width, uint8_t height, uint16_t color);
 static void checkForMovement(void);
 static void setupAccelerometer(void);
 static bool isDeviceFlipped(void);
 static uint8_t getDaysInMonth(uint8_t m);
-static void drawClockPartial(ClockDisplayParams* p,
-                             uint8_t h, uint8_t m, uint8_t s,
-                             const char* ampm,
-                             uint8_t d, uint8_t mo);
-static void drawWatchColons(void);
-static void drawMenuColons(void);
+static void composeClock(const ClockDisplayParams* p);
+static void composeDigits(const ClockDisplayParams* p);
 static void initOLED(void);
-static void drawInitialDisplay(void);
+#ifdef BUS_BENCHMARK
+static void runBusBenchmark(void);
+#endif
+static bool isWalking(void);
+static void servicePedometer(void);
+static uint32_t paceSignature(void);
+static void composeWatchFace(uint16_t changes);
 static void updateTime(void);
 void TMR1_Initialize(void);
 void __attribute__((interrupt, auto_psv)) _T1Interrupt(void);
@@ -224,12 +298,14 @@ static uint32_t getMillis(void);
 static bool isButtonPressed(volatile unsigned int* port, uint8_t bit);
 static void navigateMenuUp(void);
 static void navigateMenuDown(void);
-void drawRectangleOutline(uint8_t x, uint8_t y,
-                          uint8_t widthRect, uint8_t heightRect,
-                          uint16_t color);
 static void enterMenu(void);
 static void processButtons(void);
-static void drawMenuStatic(void);
+static void composeMenu(uint16_t changes);
+static void composeField(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                         uint8_t value, bool active);
+static void composeTimeConfig(uint16_t changes);
+static void composeFormatConfig(uint16_t changes);
+static void composeDateConfig(uint16_t changes);
 static void setTimeConfig(void);
 static void setFormatConfig(void);
 static void setDateConfig(void);
@@ -237,12 +313,13 @@ static void selectMenuOption(void);
 static void drawMenu(void);
 
 /* --- NEW GRAPH FUNCTIONS --- */
-static void updateStepsHistory(void);
-static void computeSmoothedSteps(void);
+static bool serviceStepHistory(void);
 static void drawDashedLine(int x1, int y1, int x2, int y2, 
                            int dashLen, int gapLen, uint16_t color);
 static void drawGraphGrid(void);
 static void drawStepsGraph(void);
+static void advanceStepsGraph(void);
+static void composeGraph(uint16_t changes);
 static void displayPedometerGraph(void);
 
 /*******************************************************************************
@@ -263,7 +340,11 @@ int main(void)
 
     // OLED init
     initOLED();
-    drawInitialDisplay();
+#ifdef BUS_BENCHMARK
+    runBusBenchmark();
+#endif
+    oledC_renderInit(getMillis, FRAME_INTERVAL);
+    oledC_renderSetScreen(composeWatchFace);
 
     // I2C + accelerometer check
     i2c1_open();
@@ -279,13 +360,18 @@ int main(void)
     }
     setupAccelerometer();
 
+    stepHistory_init();
+    stepJournal_mount(getMillis);
+    lastHistoryTick = getMillis();
+
     uint32_t lastTimeUpdate = getMillis();
-    uint32_t lastPedometerUpdate = getMillis();
+    lastPedometerUpdate = getMillis();
     decayTimer = getMillis();
 
     while (1)
     {
         processButtons();
+        serviceStepHistory();
 
         // 1) Time display mode
         if (currentState == STATE_TIME_DISPLAY)
@@ -295,7 +381,7 @@ int main(void)
             {
                 lastTimeUpdate = currentTime;
                 updateTime();
-                drawClockPartial(&watchDisplay, hours, minutes, seconds, ampmStr, day, month);
+                oledC_renderPost(RENDER_CLOCK);
             }
         }
         // 2) Menu mode
@@ -305,66 +391,10 @@ int main(void)
         }
 
         // 3) Pedometer update (every ~100ms)
-        if (getMillis() - lastPedometerUpdate >= 100)
-        {
-            lastPedometerUpdate = getMillis();
-            checkForMovement();  // update stepCount/currentPace
-
-            // If no movement for 2000ms => start decaying
-            if (getMillis() - lastStepTime >= 2000)
-            {
-                if (getMillis() - decayTimer >= 1000)
-                {
-                    decayTimer = getMillis();
-                    if (currentPace > 0)
-                    {
-                        currentPace--;
-                        footToggle = !footToggle;
-                    }
-                }
-            }
-            else
-            {
-                // Movement detected recently => reset decay timer
-                decayTimer = getMillis();
-            }
-
-            // Store the new pace in stepsHistory
-            updateStepsHistory();
-
-            // Update display only if currentPace changed
-       // Update display only if currentPace changed
-if (currentPace != prevPaceDisplay)
-{
-    // Clear old area
-    oledC_DrawRectangle(0, 0, 16, 16, OLEDC_COLOR_BLACK);
-    oledC_DrawRectangle(20, 0, 50, 8, OLEDC_COLOR_BLACK);
-
-    // Only display icon and steps if movement was detected recently
-    if ((getMillis() - lastStepTime < 2000) && (currentPace > 0))
-    {
-        // Show foot icon based on toggle state
-        if (footToggle)
-            drawFootIcon(0, 0, foot1Bitmap, 16, 16, OLEDC_COLOR_WHITE);
-        else
-            drawFootIcon(0, 0, foot2Bitmap, 16, 16, OLEDC_COLOR_WHITE);
-
-        // Print pace value
-        char paceStr[10];
-        snprintf(paceStr, sizeof(paceStr), "%lu", currentPace);
-        oledC_DrawString(20, 0, 1, 1, (uint8_t *) paceStr, OLEDC_COLOR_WHITE);
-    }
-    else
-    {
-        // If no recent movement, clear the area so nothing is shown
-        oledC_DrawRectangle(0, 0, 16, 16, OLEDC_COLOR_BLACK);
-        oledC_DrawRectangle(20, 0, 50, 8, OLEDC_COLOR_BLACK);
-    }
-    prevPaceDisplay = currentPace;
-}
-
-        }
+        servicePedometer();
 
+        stepJournal_idle();
+        oledC_renderService();
         DELAY_milliseconds(20);
     }
 
@@ -381,6 +411,7 @@ if (currentPace != prevPaceDisplay)
 void haltOnError(const char *errorMsg) {
     oledC_DrawString(0, 20, 1, 1, (uint8_t *) errorMsg, OLEDC_COLOR_DARKRED);
     printf("Error: %s\n", errorMsg);
+    oledC_flush();
     while (1);
 }
 
@@ -410,21 +441,6 @@ int16_t readAxisValue(uint8_t regAddr) {
     return (int16_t)((highByte << 8) | lowByte);
 }
 
-/*------------------------------------------------------------------------------
- * drawFootIcon
- *----------------------------------------------------------------------------*/
-void drawFootIcon(uint8_t x, uint8_t y, const uint16_t *bitmap,
-                  uint8_t width, uint8_t height, uint16_t color) {
-    for (uint8_t row = 0; row < height; row++) {
-        uint16_t rowData = bitmap[row];
-        for (uint8_t col = 0; col < width; col++) {
-            if (rowData & (1 << (width - 1 - col))) {
-                oledC_DrawPoint(x + col, y + row, color);
-            }
-        }
-    }
-}
-
 /*------------------------------------------------------------------------------
  * checkForMovement: updates stepCount/currentPace
  *----------------------------------------------------------------------------*/
@@ -440,6 +456,7 @@ static void checkForMovement(void) {
         abs(z - lastZ) > STEP_THRESHOLD)
     {
         stepCount++;
+        stepHistory_addSteps(1);
     }
 
     lastX = x;
@@ -464,6 +481,44 @@ static void checkForMovement(void) {
 
 }
 
+/*------------------------------------------------------------------------------
+ * servicePedometer: every ~100 ms sample the accelerometer into the step
+ * history, decay the pace after 2 s without steps and post RENDER_PACE when
+ * what the watch face shows of it changed. Steps only reach the history
+ * from here, so the main loop and the graph loop both call it.
+ *----------------------------------------------------------------------------*/
+static void servicePedometer(void)
+{
+    if (getMillis() - lastPedometerUpdate < 100)
+        return;
+    lastPedometerUpdate = getMillis();
+    checkForMovement();  // update stepCount/currentPace
+
+    // If no movement for 2000ms => start decaying
+    if (getMillis() - lastStepTime >= 2000)
+    {
+        if (getMillis() - decayTimer >= 1000)
+        {
+            decayTimer = getMillis();
+            if (currentPace > 0)
+            {
+                currentPace--;
+                footToggle = !footToggle;
+            }
+        }
+    }
+    else
+    {
+        // Movement detected recently => reset decay timer
+        decayTimer = getMillis();
+    }
+
+    if (paceSignature() != shownPace) {
+        shownPace = paceSignature();
+        oledC_renderPost(RENDER_PACE);
+    }
+}
+
 /*------------------------------------------------------------------------------
  * setupAccelerometer
  *----------------------------------------------------------------------------*/
@@ -478,6 +533,11 @@ static void setupAccelerometer(void) {
         if (i == 2) haltOnError("Data Format Fail");
         DELAY_milliseconds(10);
     }
+    for (int i = 0; i < 3; i++) {
+        if (accelTap_initialize(getMillis) == OK) break;
+        if (i == 2) haltOnError("Tap Config Fail");
+        DELAY_milliseconds(10);
+    }
 }
 
 /*------------------------------------------------------------------------------
@@ -497,107 +557,62 @@ static uint8_t getDaysInMonth(uint8_t m) {
 }
 
 /*------------------------------------------------------------------------------
- * drawClockPartial
+ * composeDigits: hours, minutes and seconds as seven-segment digit pairs,
+ * with two square dots for each colon, centred in the gap between fields.
+ * A tick only fills the bars that toggled.
  *----------------------------------------------------------------------------*/
-static void drawClockPartial(ClockDisplayParams* p,
-        uint8_t h, uint8_t m, uint8_t s,
-        const char* ampm,
-        uint8_t d, uint8_t mo)
+static void composeDigits(const ClockDisplayParams* p)
 {
-    // Hours
-    if (h != p->oldHours) {
-        oledC_DrawRectangle(p->hourX, p->hourY,
-                            p->hourX + 10 * p->hourScale,
-                            p->hourY + 10 * p->hourScale,
-                            OLEDC_COLOR_BLACK);
-        char hourStr[3];
-        snprintf(hourStr, sizeof(hourStr), "%02d", h);
-        oledC_DrawString(p->hourX, p->hourY,
-                         p->hourScale, p->hourScale,
-                         (uint8_t*) hourStr, OLEDC_COLOR_WHITE);
-        p->oldHours = h;
-    }
-    // Minutes
-    if (m != p->oldMinutes) {
-        oledC_DrawRectangle(p->minX, p->minY,
-                            p->minX + 10 * p->minScale,
-                            p->minY + 10 * p->minScale,
-                            OLEDC_COLOR_BLACK);
-        char minStr[3];
-        snprintf(minStr, sizeof(minStr), "%02d", m);
-        oledC_DrawString(p->minX, p->minY,
-                         p->minScale, p->minScale,
-                         (uint8_t*) minStr, OLEDC_COLOR_WHITE);
-        p->oldMinutes = m;
-    }
-    // Seconds
-    if (s != p->oldSeconds) {
-        oledC_DrawRectangle(p->secX, p->secY,
-                            p->secX + 10 * p->secScale,
-                            p->secY + 10 * p->secScale,
-                            OLEDC_COLOR_BLACK);
-        char secStr[3];
-        snprintf(secStr, sizeof(secStr), "%02d", s);
-        oledC_DrawString(p->secX, p->secY,
-                         p->secScale, p->secScale,
-                         (uint8_t*) secStr, OLEDC_COLOR_WHITE);
-        p->oldSeconds = s;
-    }
-    // AM/PM or blank for 24H
-    if (ampmStr[0] != '\0') { // 12H mode
-        if (strcmp(ampm, p->oldAmPm) != 0) {
-            oledC_DrawRectangle(p->ampmX, p->ampmY,
-                                p->ampmX + 24 * p->ampmScale,
-                                p->ampmY + 10 * p->ampmScale,
-                                OLEDC_COLOR_BLACK);
-            oledC_DrawString(p->ampmX, p->ampmY,
-                             p->ampmScale, p->ampmScale,
-                             (uint8_t*) ampm, OLEDC_COLOR_WHITE);
-            strcpy(p->oldAmPm, ampm);
-        }
-    } else {
-        // 24H mode => clear am/pm if it was displayed
-        if (strlen(p->oldAmPm) > 0) {
-            oledC_DrawRectangle(p->ampmX, p->ampmY,
-                                p->ampmX + 24 * p->ampmScale,
-                                p->ampmY + 10 * p->ampmScale,
-                                OLEDC_COLOR_BLACK);
-            p->oldAmPm[0] = '\0';
-        }
-    }
-    // Date
-    if (p->showDate) {
-        if (d != p->oldDay || mo != p->oldMonth) {
-            oledC_DrawRectangle(p->dateX, p->dateY,
-                                p->dateX + 30 * p->dateScale,
-                                p->dateY + 16 * p->dateScale,
-                                OLEDC_COLOR_BLACK);
-            char dateStr[6];
-            snprintf(dateStr, sizeof(dateStr), "%02d/%02d", d, mo);
-            oledC_DrawString(p->dateX, p->dateY,
-                             p->dateScale, p->dateScale,
-                             (uint8_t*) dateStr, OLEDC_COLOR_WHITE);
-            p->oldDay = d;
-            p->oldMonth = mo;
+    const oledc_segment_style_t *d = p->digits;
+    const int x[3] = { p->hourX, p->minX, p->secX };
+    const int y[3] = { p->hourY, p->minY, p->secY };
+    const int value[3] = { hours, minutes, seconds };
+    int fieldEnd, dot;
+
+    for (int field = 0; field < 3; field++) {
+        oledC_frameDigit(x[field], y[field], d, value[field] / 10, OLEDC_COLOR_WHITE);
+        oledC_frameDigit(x[field] + d->width + DIGIT_GAP, y[field], d, value[field] % 10,
+                         OLEDC_COLOR_WHITE);
+        if (field < 2) {
+            fieldEnd = x[field] + 2 * d->width + DIGIT_GAP;
+            dot = (fieldEnd + x[field + 1]) / 2 - d->thickness / 2;
+            oledC_frameBox(dot, y[field] + d->height / 4,
+                           dot + d->thickness - 1, y[field] + d->height / 4 + d->thickness - 1,
+                           OLEDC_COLOR_WHITE);
+            oledC_frameBox(dot, y[field] + d->height - d->height / 4 - d->thickness,
+                           dot + d->thickness - 1, y[field] + d->height - d->height / 4 - 1,
+                           OLEDC_COLOR_WHITE);
         }
     }
 }
 
 /*------------------------------------------------------------------------------
- * drawWatchColons
+ * composeClock: hours, minutes, seconds, colons, AM/PM and (optionally) the
+ * date as widgets of the current frame. In text, colons sit 12 px per scale
+ * after the hours and the minutes.
  *----------------------------------------------------------------------------*/
-static void drawWatchColons(void) {
-    oledC_DrawString(24, 30, 2, 2, (uint8_t *) ":", OLEDC_COLOR_WHITE);
-    oledC_DrawString(60, 30, 2, 2, (uint8_t *) ":", OLEDC_COLOR_WHITE);
-}
+static void composeClock(const ClockDisplayParams* p)
+{
+    char str[8];  // "dd/mm" sized for any uint8_t day and month
 
-/*------------------------------------------------------------------------------
- * drawMenuColons
- *----------------------------------------------------------------------------*/
-static void drawMenuColons(void) {
-    int margin = MENU_CLOCK_MARGIN_RIGHT;
-    oledC_DrawString(57 - margin, 2, 1, 1, (uint8_t *) ":", OLEDC_COLOR_WHITE);
-    oledC_DrawString(75 - margin, 2, 1, 1, (uint8_t *) ":", OLEDC_COLOR_WHITE);
+    if (p->digits) {
+        composeDigits(p);
+    } else {
+        snprintf(str, sizeof(str), "%02d", hours);
+        oledC_frameText(p->hourX, p->hourY, p->hourScale, str, OLEDC_COLOR_WHITE);
+        oledC_frameText(p->hourX + 12 * p->hourScale, p->hourY, p->hourScale, ":", OLEDC_COLOR_WHITE);
+        snprintf(str, sizeof(str), "%02d", minutes);
+        oledC_frameText(p->minX, p->minY, p->minScale, str, OLEDC_COLOR_WHITE);
+        oledC_frameText(p->minX + 12 * p->minScale, p->minY, p->minScale, ":", OLEDC_COLOR_WHITE);
+        snprintf(str, sizeof(str), "%02d", seconds);
+        oledC_frameText(p->secX, p->secY, p->secScale, str, OLEDC_COLOR_WHITE);
+    }
+    // Empty in 24H mode
+    oledC_frameText(p->ampmX, p->ampmY, p->ampmScale, ampmStr, OLEDC_COLOR_WHITE);
+    if (p->showDate) {
+        snprintf(str, sizeof(str), "%02u/%02u", day, month);
+        oledC_frameText(p->dateX, p->dateY, p->dateScale, str, OLEDC_COLOR_WHITE);
+    }
 }
 
 /*------------------------------------------------------------------------------
@@ -608,22 +623,88 @@ static void initOLED(void) {
     oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
 }
 
+#ifdef BUS_BENCHMARK
 /*------------------------------------------------------------------------------
- * drawInitialDisplay
+ * runBusBenchmark: full-screen fills through the byte-at-a-time path and the
+ * FIFO/MODE16 path, shown as bus bytes per second for 5 s at startup. Both
+ * send the same bytes, so only the board can tell them apart; bus bytes of
+ * the other drawing paths are compared on the host (make draw-bench).
  *----------------------------------------------------------------------------*/
-static void drawInitialDisplay(void) {
+#define BENCH_FRAMES 4
+
+static uint32_t benchBytesPerSecond(bool fast)
+{
+    oledc_bus_stats_t stats;
+    uint32_t start = getMillis();
+    uint32_t elapsed;
+
+    oledC_resetBusStats();
+    for (uint8_t frame = 0; frame < BENCH_FRAMES; frame++)
+    {
+        uint16_t color = (frame & 1) ? OLEDC_COLOR_BLACK : OLEDC_COLOR_BLUE;
+        if (fast)
+        {
+            oledC_FillWindow(0, 0, 95, 95, color, 96 * 96);
+        }
+        else
+        {
+            oledC_setColumnAddressBounds(0, 95);
+            oledC_setRowAddressBounds(0, 95);
+            for (uint16_t i = 0; i < 96 * 96; i++)
+                oledC_sendColorInt(color);
+            oledC_stopWritingDisplay();
+        }
+    }
+    elapsed = getMillis() - start;
+    oledC_getBusStats(&stats);
+    return stats.bytes * 1000 / (elapsed ? elapsed : 1);
+}
+
+static void runBusBenchmark(void)
+{
+    char line[16];
+    uint32_t bytePath = benchBytesPerSecond(false);
+    uint32_t fifoPath = benchBytesPerSecond(true);
+
     oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    drawWatchColons();
+    oledC_DrawString(0, 10, 1, 1, (uint8_t*)"bus B/s", OLEDC_COLOR_WHITE);
+    snprintf(line, sizeof(line), "byte %lu", (unsigned long)bytePath);
+    oledC_DrawString(0, 30, 1, 1, (uint8_t*)line, OLEDC_COLOR_WHITE);
+    snprintf(line, sizeof(line), "fifo %lu", (unsigned long)fifoPath);
+    oledC_DrawString(0, 45, 1, 1, (uint8_t*)line, OLEDC_COLOR_WHITE);
+    oledC_flush();
+    DELAY_milliseconds(5000);
+}
+#endif
 
-    // Force full update
-    watchDisplay.oldHours   = 99;
-    watchDisplay.oldMinutes = 99;
-    watchDisplay.oldSeconds = 99;
-    watchDisplay.oldDay     = 99;
-    watchDisplay.oldMonth   = 99;
-    strcpy(watchDisplay.oldAmPm, "XX");
+/*------------------------------------------------------------------------------
+ * isWalking: a step within ICON_DISPLAY_DELAY and a pace to show
+ *----------------------------------------------------------------------------*/
+static bool isWalking(void) {
+    return (getMillis() - lastStepTime < ICON_DISPLAY_DELAY) && (currentPace > 0);
+}
 
-    drawClockPartial(&watchDisplay, hours, minutes, seconds, ampmStr, day, month);
+/*------------------------------------------------------------------------------
+ * paceSignature: what the watch face shows of the pedometer, 0 while idle
+ *----------------------------------------------------------------------------*/
+static uint32_t paceSignature(void) {
+    return isWalking() ? (currentPace << 1) | footToggle : 0;
+}
+
+/*------------------------------------------------------------------------------
+ * composeWatchFace: clock, date and (while walking) the foot icon and pace
+ *----------------------------------------------------------------------------*/
+static void composeWatchFace(uint16_t changes) {
+    bool walking = isWalking();
+    char paceStr[11];
+
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    composeClock(&watchDisplay);
+    snprintf(paceStr, sizeof(paceStr), "%" PRIu32, currentPace);
+    oledC_frameIcon(0, 0, walking ? (footToggle ? &foot1Icon : &foot2Icon) : NULL,
+                    OLEDC_COLOR_WHITE);
+    oledC_frameText(20, 0, 1, walking ? paceStr : "", OLEDC_COLOR_WHITE);
+    oledC_frameEnd();
 }
 
 /*------------------------------------------------------------------------------
@@ -715,30 +796,25 @@ static void navigateMenuDown(void) {
 }
 
 /*------------------------------------------------------------------------------
- * drawRectangleOutline
+ * slideScreenUp: move the screen up out of view with the controller's start
+ * line; only the blank rows coming in at the bottom go over the bus
  *----------------------------------------------------------------------------*/
-void drawRectangleOutline(uint8_t x, uint8_t y,
-        uint8_t widthRect, uint8_t heightRect,
-        uint16_t color) {
-    uint8_t x2 = x + widthRect - 1;
-    uint8_t y2 = y + heightRect - 1;
-
-    oledC_DrawLine(x, y, x2, y, 1, color);
-    oledC_DrawLine(x, y2, x2, y2, 1, color);
-
-    for (uint8_t i = y + 1; i < y2; i++) {
-        oledC_DrawPoint(x, i, color);
-        oledC_DrawPoint(x2, i, color);
+static void slideScreenUp(void) {
+    for (uint8_t moved = 0; moved < 96; moved += SLIDE_ROWS) {
+        oledC_scrollRows(SLIDE_ROWS, NULL, NULL);
+        DELAY_milliseconds(SLIDE_DELAY);
     }
+    oledC_renderInvalidate();
 }
 
 /*------------------------------------------------------------------------------
  * enterMenu
  *----------------------------------------------------------------------------*/
 static void enterMenu(void) {
+    slideScreenUp();
     currentState = STATE_MENU;
     selectedMenu = MENU_PEDOMETER;
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
+    accelTap_flush(); // drop taps made on the watch face
 }
 
 /*------------------------------------------------------------------------------
@@ -763,123 +839,74 @@ static void processButtons(void) {
         } else {
             s1Pressed = false;
         }
+        // Double tap => menu
+        if (currentState == STATE_TIME_DISPLAY &&
+            accelTap_getEvent() == TAP_DOUBLE) {
+            enterMenu();
+        }
     }
 }
 
 /*------------------------------------------------------------------------------
- * drawMenuStatic
+ * composeMenu: clock on top, one row per item; every row keeps its box so the
+ * highlight only moves between two rows
  *----------------------------------------------------------------------------*/
-static void drawMenuStatic(void) {
+static void composeMenu(uint16_t changes) {
     int marginLeft = 1;
-    drawMenuColons();
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    composeClock(&menuDisplay);
     for (int i = 0; i < MENU_COUNT; i++) {
-        oledC_DrawString(marginLeft, 15 + i * 15, 1, 1,
-                (uint8_t*) menuItems[i], OLEDC_COLOR_WHITE);
+        bool selected = (i == selectedMenu);
+        oledC_frameBox(0, 15 + i * 15, 95, 14 + (i + 1) * 15,
+                       selected ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+        oledC_frameText(marginLeft, 15 + i * 15, 1, menuItems[i],
+                        selected ? OLEDC_COLOR_BLACK : OLEDC_COLOR_WHITE);
     }
-    oledC_DrawRectangle(0, 15 + selectedMenu * 15,
-            95, 15 + (selectedMenu + 1) * 15,
-            OLEDC_COLOR_WHITE);
-    oledC_DrawString(marginLeft, 15 + selectedMenu * 15, 1, 1,
-            (uint8_t*) menuItems[selectedMenu], OLEDC_COLOR_BLACK);
+    oledC_frameEnd();
+}
+
+/*------------------------------------------------------------------------------
+ * composeField: a two-digit value in its region, outlined while active
+ *----------------------------------------------------------------------------*/
+static void composeField(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                         uint8_t value, bool active) {
+    char str[4];  // sized for any uint8_t value
+    snprintf(str, sizeof(str), "%02u", value);
+    oledC_frameText(x + TEXT_OFFSET, y + TEXT_OFFSET, 2, str, OLEDC_COLOR_WHITE);
+    oledC_frameOutline(x, y, width, height,
+                       active ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+}
+
+/*------------------------------------------------------------------------------
+ * composeTimeConfig
+ *----------------------------------------------------------------------------*/
+static void composeTimeConfig(uint16_t changes) {
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    oledC_frameText(5, 5, 2, "Set Time", OLEDC_COLOR_WHITE);
+    composeField(HOUR_REGION_X, HOUR_REGION_Y,
+            HOUR_REGION_WIDTH, HOUR_REGION_HEIGHT,
+            newHour, activeField == 0);
+    composeField(MIN_REGION_X, MIN_REGION_Y,
+            MIN_REGION_WIDTH, MIN_REGION_HEIGHT,
+            newMinute, activeField == 1);
+    oledC_frameEnd();
 }
 
 /*------------------------------------------------------------------------------
  * setTimeConfig
  *----------------------------------------------------------------------------*/
 static void setTimeConfig(void) {
-    uint8_t newHour = hours;
-    uint8_t newMinute = minutes;
-    uint8_t activeField = 0; 
-    uint8_t prevActiveField = activeField;
     uint32_t bothPressStart = 0;
     uint32_t flipStart = 0;
 
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    oledC_DrawString(5, 5, 2, 2, (uint8_t*) "Set Time", OLEDC_COLOR_WHITE);
-
-    uint8_t prevHour = newHour;
-    uint8_t prevMinute = newMinute;
-
-    // Draw initial
-    {
-        char hourStr[3], minStr[3];
-        snprintf(hourStr, sizeof(hourStr), "%02d", newHour);
-        snprintf(minStr, sizeof(minStr), "%02d", newMinute);
-        oledC_DrawString(HOUR_REGION_X + TEXT_OFFSET,
-                HOUR_REGION_Y + TEXT_OFFSET, 2, 2,
-                (uint8_t*) hourStr, OLEDC_COLOR_WHITE);
-        oledC_DrawString(MIN_REGION_X + TEXT_OFFSET,
-                MIN_REGION_Y + TEXT_OFFSET, 2, 2,
-                (uint8_t*) minStr, OLEDC_COLOR_WHITE);
-    }
-    drawRectangleOutline(HOUR_REGION_X, HOUR_REGION_Y,
-            HOUR_REGION_WIDTH, HOUR_REGION_HEIGHT,
-            OLEDC_COLOR_WHITE);
+    newHour = hours;
+    newMinute = minutes;
+    activeField = 0;
+    oledC_renderSetScreen(composeTimeConfig);
 
     while (1) {
         processButtons();
-
-        if (newHour != prevHour) {
-            char tempStr[3];
-            snprintf(tempStr, sizeof(tempStr), "%02d", prevHour);
-            oledC_DrawString(HOUR_REGION_X + TEXT_OFFSET,
-                    HOUR_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_BLACK);
-            snprintf(tempStr, sizeof(tempStr), "%02d", newHour);
-            oledC_DrawString(HOUR_REGION_X + TEXT_OFFSET,
-                    HOUR_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_WHITE);
-            prevHour = newHour;
-            if (activeField == 0) {
-                drawRectangleOutline(HOUR_REGION_X, HOUR_REGION_Y,
-                        HOUR_REGION_WIDTH, HOUR_REGION_HEIGHT,
-                        OLEDC_COLOR_WHITE);
-            }
-        }
-        if (newMinute != prevMinute) {
-            char tempStr[3];
-            snprintf(tempStr, sizeof(tempStr), "%02d", prevMinute);
-            oledC_DrawString(MIN_REGION_X + TEXT_OFFSET,
-                    MIN_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_BLACK);
-            snprintf(tempStr, sizeof(tempStr), "%02d", newMinute);
-            oledC_DrawString(MIN_REGION_X + TEXT_OFFSET,
-                    MIN_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_WHITE);
-            prevMinute = newMinute;
-            if (activeField == 1) {
-                drawRectangleOutline(MIN_REGION_X, MIN_REGION_Y,
-                        MIN_REGION_WIDTH, MIN_REGION_HEIGHT,
-                        OLEDC_COLOR_WHITE);
-            }
-        }
-        if (activeField != prevActiveField) {
-            drawRectangleOutline(HOUR_REGION_X, HOUR_REGION_Y,
-                    HOUR_REGION_WIDTH, HOUR_REGION_HEIGHT,
-                    OLEDC_COLOR_BLACK);
-            drawRectangleOutline(MIN_REGION_X, MIN_REGION_Y,
-                    MIN_REGION_WIDTH, MIN_REGION_HEIGHT,
-                    OLEDC_COLOR_BLACK);
-            char hourStr[3], minStr[3];
-            snprintf(hourStr, sizeof(hourStr), "%02d", newHour);
-            snprintf(minStr, sizeof(minStr), "%02d", newMinute);
-            oledC_DrawString(HOUR_REGION_X + TEXT_OFFSET,
-                    HOUR_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) hourStr, OLEDC_COLOR_WHITE);
-            oledC_DrawString(MIN_REGION_X + TEXT_OFFSET,
-                    MIN_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) minStr, OLEDC_COLOR_WHITE);
-            if (activeField == 0) {
-                drawRectangleOutline(HOUR_REGION_X, HOUR_REGION_Y,
-                        HOUR_REGION_WIDTH, HOUR_REGION_HEIGHT,
-                        OLEDC_COLOR_WHITE);
-            } else {
-                drawRectangleOutline(MIN_REGION_X, MIN_REGION_Y,
-                        MIN_REGION_WIDTH, MIN_REGION_HEIGHT,
-                        OLEDC_COLOR_WHITE);
-            }
-            prevActiveField = activeField;
-        }
+        oledC_renderService();
 
         bool s1Down = isButtonPressed(&PORTA, 11);
         bool s2Down = isButtonPressed(&PORTA, 12);
@@ -895,6 +922,7 @@ static void setTimeConfig(void) {
             if (bothPressStart != 0) {
                 if (getMillis() - bothPressStart < 2000) {
                     activeField = (activeField + 1) % 2;
+                    oledC_renderPost(RENDER_INPUT);
                 }
                 bothPressStart = 0;
             }
@@ -910,6 +938,7 @@ static void setTimeConfig(void) {
             } else {
                 newMinute = (newMinute + 1) % 60;
             }
+            oledC_renderPost(RENDER_INPUT);
             DELAY_milliseconds(200);
         }
         // S2 only => decrement
@@ -923,6 +952,7 @@ static void setTimeConfig(void) {
             } else {
                 newMinute = (newMinute == 0) ? 59 : newMinute - 1;
             }
+            oledC_renderPost(RENDER_INPUT);
             DELAY_milliseconds(200);
         }
         // Flip device => exit
@@ -953,54 +983,41 @@ static void setTimeConfig(void) {
     } else {
         ampmStr[0] = '\0';
     }
+}
 
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    menuDisplay.oldHours   = 99;
-    menuDisplay.oldMinutes = 99;
-    menuDisplay.oldSeconds = 99;
-    strcpy(menuDisplay.oldAmPm, "XX");
-    drawMenuStatic();
+/*------------------------------------------------------------------------------
+ * composeFormatConfig
+ *----------------------------------------------------------------------------*/
+static void composeFormatConfig(uint16_t changes) {
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    oledC_frameText(5, 5, 2, "12H/24H", OLEDC_COLOR_WHITE);
+    oledC_frameText(OPT12H_X + TEXT_OFFSET, OPT12H_Y + TEXT_OFFSET, 2,
+            "12H", OLEDC_COLOR_WHITE);
+    oledC_frameText(OPT24H_X + TEXT_OFFSET, OPT24H_Y + TEXT_OFFSET, 2,
+            "24H", OLEDC_COLOR_WHITE);
+    oledC_frameOutline(OPT12H_X, OPT12H_Y, OPT12H_WIDTH, OPT12H_HEIGHT,
+            currentFormat ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+    oledC_frameOutline(OPT24H_X, OPT24H_Y, OPT24H_WIDTH, OPT24H_HEIGHT,
+            currentFormat ? OLEDC_COLOR_BLACK : OLEDC_COLOR_WHITE);
+    oledC_frameEnd();
 }
 
 /*------------------------------------------------------------------------------
  * setFormatConfig
  *----------------------------------------------------------------------------*/
 static void setFormatConfig(void) {
-    bool currentFormat = (ampmStr[0] != '\0'); // true => 12H, false => 24H
-    bool prevFormat = currentFormat;
-
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    oledC_DrawString(5, 5, 2, 2, (uint8_t*) "12H/24H", OLEDC_COLOR_WHITE);
-    oledC_DrawString(OPT12H_X + TEXT_OFFSET, OPT12H_Y + TEXT_OFFSET, 2, 2,
-            (uint8_t*) "12H", OLEDC_COLOR_WHITE);
-    oledC_DrawString(OPT24H_X + TEXT_OFFSET, OPT24H_Y + TEXT_OFFSET, 2, 2,
-            (uint8_t*) "24H", OLEDC_COLOR_WHITE);
-
-    drawRectangleOutline(currentFormat ? OPT12H_X : OPT24H_X,
-                         currentFormat ? OPT12H_Y : OPT24H_Y,
-                         currentFormat ? OPT12H_WIDTH : OPT24H_WIDTH,
-                         currentFormat ? OPT12H_HEIGHT: OPT24H_HEIGHT,
-                         OLEDC_COLOR_WHITE);
+    currentFormat = (ampmStr[0] != '\0');
+    oledC_renderSetScreen(composeFormatConfig);
 
     while (1) {
         processButtons();
-        if (currentFormat != prevFormat) {
-            drawRectangleOutline(prevFormat ? OPT12H_X : OPT24H_X,
-                                 prevFormat ? OPT12H_Y : OPT24H_Y,
-                                 prevFormat ? OPT12H_WIDTH : OPT24H_WIDTH,
-                                 prevFormat ? OPT12H_HEIGHT: OPT24H_HEIGHT,
-                                 OLEDC_COLOR_BLACK);
-            drawRectangleOutline(currentFormat ? OPT12H_X : OPT24H_X,
-                                 currentFormat ? OPT12H_Y : OPT24H_Y,
-                                 currentFormat ? OPT12H_WIDTH : OPT24H_WIDTH,
-                                 currentFormat ? OPT12H_HEIGHT: OPT24H_HEIGHT,
-                                 OLEDC_COLOR_WHITE);
-            prevFormat = currentFormat;
-        }
+        oledC_renderService();
+
         bool s1Down = isButtonPressed(&PORTA, 11);
         bool s2Down = isButtonPressed(&PORTA, 12);
         if (s2Down && !s1Down) {
             currentFormat = !currentFormat;
+            oledC_renderPost(RENDER_INPUT);
             DELAY_milliseconds(200);
         }
         if (s1Down && !s2Down) {
@@ -1026,112 +1043,43 @@ static void setFormatConfig(void) {
                 }
                 ampmStr[0] = '\0';
             }
-            oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-            drawMenuStatic();
-            menuDisplay.oldHours = 99;
-            menuDisplay.oldMinutes = 99;
-            menuDisplay.oldSeconds = 99;
-            strcpy(menuDisplay.oldAmPm, "XX");
-            drawClockPartial(&menuDisplay, hours, minutes, seconds, ampmStr, day, month);
             break;
         }
         DELAY_milliseconds(100);
     }
 }
 
+/*------------------------------------------------------------------------------
+ * composeDateConfig
+ *----------------------------------------------------------------------------*/
+static void composeDateConfig(uint16_t changes) {
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    oledC_frameText(5, 5, 2, "Set Date", OLEDC_COLOR_WHITE);
+    composeField(DAY_REGION_X, DAY_REGION_Y,
+            DAY_REGION_WIDTH, DAY_REGION_HEIGHT,
+            newDay, activeField == 0);
+    composeField(MONTH_REGION_X, MONTH_REGION_Y,
+            MONTH_REGION_WIDTH, MONTH_REGION_HEIGHT,
+            newMonth, activeField == 1);
+    oledC_frameEnd();
+}
+
 /*------------------------------------------------------------------------------
  * setDateConfig
  *----------------------------------------------------------------------------*/
 static void setDateConfig(void) {
-    uint8_t newDay = day;
-    uint8_t newMonth = month;
-    uint8_t activeField = 0;
-    uint8_t prevActiveField = activeField;
     uint32_t bothPressStart = 0;
     uint32_t flipStart = 0;
 
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    oledC_DrawString(5, 5, 2, 2, (uint8_t*) "Set Date", OLEDC_COLOR_WHITE);
-
-    uint8_t prevDay = newDay;
-    uint8_t prevMonth = newMonth;
-
-    {
-        char dayStr[3], monthStr[3];
-        snprintf(dayStr, sizeof(dayStr), "%02d", newDay);
-        snprintf(monthStr, sizeof(monthStr), "%02d", newMonth);
-        oledC_DrawString(DAY_REGION_X + TEXT_OFFSET,
-                DAY_REGION_Y + TEXT_OFFSET, 2, 2,
-                (uint8_t*) dayStr, OLEDC_COLOR_WHITE);
-        oledC_DrawString(MONTH_REGION_X + TEXT_OFFSET,
-                MONTH_REGION_Y + TEXT_OFFSET, 2, 2,
-                (uint8_t*) monthStr, OLEDC_COLOR_WHITE);
-    }
-    drawRectangleOutline(DAY_REGION_X, DAY_REGION_Y,
-            DAY_REGION_WIDTH, DAY_REGION_HEIGHT,
-            OLEDC_COLOR_WHITE);
+    newDay = day;
+    newMonth = month;
+    activeField = 0;
+    oledC_renderSetScreen(composeDateConfig);
 
     while (1) {
         processButtons();
+        oledC_renderService();
 
-        if (newDay != prevDay) {
-            char tempStr[3];
-            snprintf(tempStr, sizeof(tempStr), "%02d", prevDay);
-            oledC_DrawString(DAY_REGION_X + TEXT_OFFSET,
-                    DAY_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_BLACK);
-            snprintf(tempStr, sizeof(tempStr), "%02d", newDay);
-            oledC_DrawString(DAY_REGION_X + TEXT_OFFSET,
-                    DAY_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_WHITE);
-            prevDay = newDay;
-            if (activeField == 0)
-                drawRectangleOutline(DAY_REGION_X, DAY_REGION_Y,
-                                     DAY_REGION_WIDTH, DAY_REGION_HEIGHT,
-                                     OLEDC_COLOR_WHITE);
-        }
-        if (newMonth != prevMonth) {
-            char tempStr[3];
-            snprintf(tempStr, sizeof(tempStr), "%02d", prevMonth);
-            oledC_DrawString(MONTH_REGION_X + TEXT_OFFSET,
-                    MONTH_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_BLACK);
-            snprintf(tempStr, sizeof(tempStr), "%02d", newMonth);
-            oledC_DrawString(MONTH_REGION_X + TEXT_OFFSET,
-                    MONTH_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) tempStr, OLEDC_COLOR_WHITE);
-            prevMonth = newMonth;
-            if (activeField == 1)
-                drawRectangleOutline(MONTH_REGION_X, MONTH_REGION_Y,
-                                     MONTH_REGION_WIDTH, MONTH_REGION_HEIGHT,
-                                     OLEDC_COLOR_WHITE);
-        }
-        if (activeField != prevActiveField) {
-            drawRectangleOutline(DAY_REGION_X, DAY_REGION_Y,
-                    DAY_REGION_WIDTH, DAY_REGION_HEIGHT,
-                    OLEDC_COLOR_BLACK);
-            drawRectangleOutline(MONTH_REGION_X, MONTH_REGION_Y,
-                    MONTH_REGION_WIDTH, MONTH_REGION_HEIGHT,
-                    OLEDC_COLOR_BLACK);
-            char dayStr[3], monthStr[3];
-            snprintf(dayStr, sizeof(dayStr), "%02d", newDay);
-            snprintf(monthStr, sizeof(monthStr), "%02d", newMonth);
-            oledC_DrawString(DAY_REGION_X + TEXT_OFFSET,
-                    DAY_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) dayStr, OLEDC_COLOR_WHITE);
-            oledC_DrawString(MONTH_REGION_X + TEXT_OFFSET,
-                    MONTH_REGION_Y + TEXT_OFFSET, 2, 2,
-                    (uint8_t*) monthStr, OLEDC_COLOR_WHITE);
-            if (activeField == 0)
-                drawRectangleOutline(DAY_REGION_X, DAY_REGION_Y,
-                                     DAY_REGION_WIDTH, DAY_REGION_HEIGHT,
-                                     OLEDC_COLOR_WHITE);
-            else
-                drawRectangleOutline(MONTH_REGION_X, MONTH_REGION_Y,
-                                     MONTH_REGION_WIDTH, MONTH_REGION_HEIGHT,
-                                     OLEDC_COLOR_WHITE);
-            prevActiveField = activeField;
-        }
         bool s1Down = isButtonPressed(&PORTA, 11);
         bool s2Down = isButtonPressed(&PORTA, 12);
         if (s1Down && s2Down) {
@@ -1141,8 +1089,10 @@ static void setDateConfig(void) {
                 break;
         } else {
             if (bothPressStart != 0) {
-                if (getMillis() - bothPressStart < 2000)
+                if (getMillis() - bothPressStart < 2000) {
                     activeField = (activeField + 1) % 2;
+                    oledC_renderPost(RENDER_INPUT);
+                }
                 bothPressStart = 0;
             }
         }
@@ -1156,6 +1106,7 @@ static void setDateConfig(void) {
                 if (newDay > maxDays)
                     newDay = maxDays;
             }
+            oledC_renderPost(RENDER_INPUT);
             DELAY_milliseconds(200);
         }
         if (s2Down && !s1Down) {
@@ -1168,6 +1119,7 @@ static void setDateConfig(void) {
                 if (newDay > maxDays)
                     newDay = maxDays;
             }
+            oledC_renderPost(RENDER_INPUT);
             DELAY_milliseconds(200);
         }
         if (isDeviceFlipped()) {
@@ -1181,13 +1133,6 @@ static void setDateConfig(void) {
     }
     day = newDay;
     month = newMonth;
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    drawMenuStatic();
-    menuDisplay.oldHours   = 99;
-    menuDisplay.oldMinutes = 99;
-    menuDisplay.oldSeconds = 99;
-    strcpy(menuDisplay.oldAmPm, "XX");
-    drawClockPartial(&menuDisplay, hours, minutes, seconds, ampmStr, day, month);
 }
 
 /*------------------------------------------------------------------------------
@@ -1209,50 +1154,22 @@ static void selectMenuOption(void) {
             break;
         case MENU_EXIT:
             currentState = STATE_TIME_DISPLAY;
-            drawInitialDisplay();
             break;
         default:
             break;
     }
+    // Give the display back to whichever screen is current now
+    oledC_renderSetScreen(currentState == STATE_MENU ? composeMenu : composeWatchFace);
 }
 
 /*------------------------------------------------------------------------------
  * drawMenu
  *----------------------------------------------------------------------------*/
 static void drawMenu(void) {
- int marginLeft = 1;
-    
-    // Clear screen and draw the menu items
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
-    drawMenuColons();
-    for (int i = 0; i < MENU_COUNT; i++) {
-        oledC_DrawString(marginLeft, 15 + i * 15, 1, 1,
-                         (uint8_t*) menuItems[i], OLEDC_COLOR_WHITE);
-    }
-    oledC_DrawRectangle(0, 15 + selectedMenu * 15,
-                        95, 15 + (selectedMenu + 1) * 15,
-                        OLEDC_COLOR_WHITE);
-    oledC_DrawString(marginLeft, 15 + selectedMenu * 15, 1, 1,
-                     (uint8_t*) menuItems[selectedMenu], OLEDC_COLOR_BLACK);
-
     // Update time once right away
     updateTime();
-
-    // (1) Clear the clock area so it will redraw from scratch
-    oledC_DrawRectangle(menuDisplay.hourX, menuDisplay.hourY, 
-                        50, 16, OLEDC_COLOR_BLACK);
-
-    // (2) Force old values to something invalid
-    menuDisplay.oldHours   = 99;
-    menuDisplay.oldMinutes = 99;
-    menuDisplay.oldSeconds = 99;
-    strcpy(menuDisplay.oldAmPm, "XX");
-
-    // (3) Now immediately draw the clock so it appears right away
-    drawClockPartial(&menuDisplay, hours, minutes, seconds, ampmStr, day, month);
-
     uint32_t lastUpdateTime = getMillis();
-    MenuOption prevMenuSelection = MENU_COUNT;
+    oledC_renderSetScreen(composeMenu);
 
     // Main loop for the menu
     while (currentState == STATE_MENU) 
@@ -1264,27 +1181,18 @@ static void drawMenu(void) {
         if (currentTime - lastUpdateTime >= 1000) {
             lastUpdateTime = currentTime;
             updateTime();
-            drawClockPartial(&menuDisplay, hours, minutes, seconds, ampmStr, day, month);
+            oledC_renderPost(RENDER_CLOCK);
         }
-
-        // Highlight the selected menu item if changed
-        if (selectedMenu != prevMenuSelection) {
-            // First, re-draw the previously selected item in white text on black
-            if (prevMenuSelection < MENU_COUNT) {
-                oledC_DrawRectangle(0, 15 + prevMenuSelection * 15,
-                                    95, 15 + (prevMenuSelection + 1) * 15,
-                                    OLEDC_COLOR_BLACK);
-                oledC_DrawString(marginLeft, 15 + prevMenuSelection * 15, 1, 1,
-                                 (uint8_t*) menuItems[prevMenuSelection], OLEDC_COLOR_WHITE);
-            }
-            // Now highlight the new selection
-            oledC_DrawRectangle(0, 15 + selectedMenu * 15,
-                                95, 15 + (selectedMenu + 1) * 15,
-                                OLEDC_COLOR_WHITE);
-            oledC_DrawString(marginLeft, 15 + selectedMenu * 15, 1, 1,
-                             (uint8_t*) menuItems[selectedMenu], OLEDC_COLOR_BLACK);
-
-            prevMenuSelection = selectedMenu;
+        oledC_renderService();
+
+        // Tap => next item (wrapping), double tap => select
+        TapEvent tap = accelTap_getEvent();
+        if (tap == TAP_SINGLE) {
+            selectedMenu = (selectedMenu + 1) % MENU_COUNT;
+            oledC_renderPost(RENDER_INPUT);
+        } else if (tap == TAP_DOUBLE) {
+            selectMenuOption();
+            continue;
         }
 bool s1Down = isButtonPressed(&PORTA, 11);  // true if S1 is pressed
 bool s2Down = isButtonPressed(&PORTA, 12);  // true if S2 is pressed
@@ -1311,6 +1219,7 @@ else if (s1Down && !s2Down)
     {
         // It's still just S1 => move up
         navigateMenuUp();
+        oledC_renderPost(RENDER_INPUT);
     }
 }
 else if (!s1Down && s2Down)
@@ -1328,6 +1237,7 @@ else if (!s1Down && s2Down)
     {
         // Still just S2 => move down
         navigateMenuDown();
+        oledC_renderPost(RENDER_INPUT);
     }
 }
 else
@@ -1345,183 +1255,245 @@ else
  ******************************************************************************/
 
 /*------------------------------------------------------------------------------
- * updateStepsHistory: store currentPace into stepsHistory[] in circular manner
+ * serviceStepHistory: close one history second per elapsed second of msCounter
+ * (catches up after screens that block the main loop); true if any closed
  *----------------------------------------------------------------------------*/
-static void updateStepsHistory(void)
+static bool serviceStepHistory(void)
 {
-    stepsHistory[stepsHistoryIndex] = (int)currentPace;
-    stepsHistoryIndex++;
-    if (stepsHistoryIndex >= 90) {
-        stepsHistoryIndex = 0;
-    }
-}
-
-
-/*------------------------------------------------------------------------------
- * computeSmoothedSteps: simple neighbor average
- *----------------------------------------------------------------------------*/
-static void computeSmoothedSteps(void)
-{
-    for (int i = 0; i < 90; i++)
-    {
-        int prev = (i == 0) ? 89 : i - 1;
-        int next = (i == 89) ? 0 : i + 1;
-        int sum = stepsHistory[i] + stepsHistory[prev] + stepsHistory[next];
-        smoothedSteps[i] = sum / 3;
-    }
-}
-static void drawLineSmooth(int x1, int y1, int x2, int y2, uint16_t color)
-{
-    float dx = (float)(x2 - x1);
-    float dy = (float)(y2 - y1);
+    bool closed = false;
 
-    // Decide how many small steps to take. 
-    // Using the larger of |dx| or |dy| ensures we don't skip big vertical/horizontal leaps.
-    float steps = (fabsf(dx) > fabsf(dy)) ? fabsf(dx) : fabsf(dy);
-    if (steps < 1.0f) steps = 1.0f;  // avoid division by 0 if points are the same
-
-    // Step through from 0..1 in small increments
-    for (float i = 0.0f; i <= steps; i += 0.5f)
+    while (getMillis() - lastHistoryTick >= 1000)
     {
-        float t = i / steps;  // fraction from 0..1
-        int px = (int)(x1 + dx * t);
-        int py = (int)(y1 + dy * t);
-
-        oledC_DrawPoint(px, py, color);
+        lastHistoryTick += 1000;
+        stepHistory_tick();
+        stepJournal_tick();
+        closed = true;
     }
+    return closed;
 }
 
-
 /*------------------------------------------------------------------------------
- * drawDashedLine
+ * drawDashedLine: dashLen pixels on, gapLen off, measured along the major axis
  *----------------------------------------------------------------------------*/
 static void drawDashedLine(int x1, int y1, int x2, int y2, 
                            int dashLen, int gapLen, uint16_t color)
 {
     int dx = x2 - x1;
     int dy = y2 - y1;
-    float length = sqrtf((float)(dx*dx + dy*dy));
-    if (length <= 0) return;
+    int length = (abs(dx) > abs(dy)) ? abs(dx) : abs(dy);
 
-    float stepX = dx / length;
-    float stepY = dy / length;
-    float pos = 0.0f;
-    float totalCycle = dashLen + gapLen;
+    if (length == 0 || dashLen <= 0) return;
 
-    while (pos < length) {
-        float endPos = pos + dashLen;
+    for (int pos = 0; pos < length; pos += dashLen + gapLen) {
+        int endPos = pos + dashLen - 1;
         if (endPos > length) endPos = length;
-        // Start
-        int sx = x1 + (int)(stepX * pos);
-        int sy = y1 + (int)(stepY * pos);
-        // End
-        int ex = x1 + (int)(stepX * endPos);
-        int ey = y1 + (int)(stepY * endPos);
-
-        oledC_DrawLine(sx, sy, ex, ey, 1, color);
-        pos += totalCycle;
+        oledC_DrawLine(x1 + dx * pos / length, y1 + dy * pos / length,
+                       x1 + dx * endPos / length, y1 + dy * endPos / length, 1, color);
     }
 }
 
 
 /*------------------------------------------------------------------------------
- * drawGraphGrid
+ * drawGraphGrid: the static layer, drawn once per span
  *----------------------------------------------------------------------------*/
 static void drawGraphGrid(void)
 {
     // Clear the screen
     oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
 
-    // Draw Y-axis labels and dashed horizontal lines
-    char label[4];
-    // Draw "100" at top (y = 0)
-    snprintf(label, sizeof(label), "100");
-    oledC_DrawString(0, 0, 1, 1, (uint8_t*)label, OLEDC_COLOR_WHITE);
-    drawDashedLine(20, 5, 95, 5, 3, 2, OLEDC_COLOR_WHITE);
-
-    // Draw "60" label (y = 30)
-    snprintf(label, sizeof(label), "60");
-    oledC_DrawString(0, 30, 1, 1, (uint8_t*)label, OLEDC_COLOR_WHITE);
-    drawDashedLine(20, 35, 95, 35, 3, 2, OLEDC_COLOR_WHITE);
-
-    // Draw "30" label (y = 60)
-    snprintf(label, sizeof(label), "30");
-    oledC_DrawString(0, 60, 1, 1, (uint8_t*)label, OLEDC_COLOR_WHITE);
-    drawDashedLine(20, 65, 95, 65, 3, 2, OLEDC_COLOR_WHITE);
-
-    // Draw the bottom dashed line (x-axis) at y = 95
-    drawDashedLine(20, 95, 95, 95, 3, 2, OLEDC_COLOR_WHITE);
-
-    // Now add x-axis markers (small 2x2 squares) along the bottom line.
-    int charWidth = 6;
-    int margin = 2;
-    int fixedLeftMargin = (3 * charWidth) + margin;  // Same left margin used for labels
-    int x2_end = 95;  // End of the screen (width - 1)
-    int yBaseline = 95;  // y-coordinate for the bottom axis
-    int squareSpacing = 10;  // Adjust spacing as needed
-
-    for (int xSquare = fixedLeftMargin; xSquare <= x2_end; xSquare += squareSpacing) {
-        // Draw a 2x2 pixel square at (xSquare, yBaseline - 2)
-        for (int i = 0; i < 2; i++) {
-            for (int j = 0; j < 2; j++) {
-                oledC_DrawPoint(xSquare + i, yBaseline - 2 + j, OLEDC_COLOR_WHITE);
-            }
-        }
+    // Y-axis labels beside the upper three grid lines
+    oledC_DrawString(0, 0, 1, 1, (uint8_t*)"100", OLEDC_COLOR_WHITE);
+    oledC_DrawString(0, 30, 1, 1, (uint8_t*)"60", OLEDC_COLOR_WHITE);
+    oledC_DrawString(0, 60, 1, 1, (uint8_t*)"30", OLEDC_COLOR_WHITE);
+    for (uint8_t i = 0; i < sizeof(gridLines); i++)
+        drawDashedLine(GRAPH_X_START, gridLines[i], 95, gridLines[i],
+                       GRID_DASH, GRID_GAP, OLEDC_COLOR_WHITE);
+
+    // Selected time span, bottom left
+    oledC_DrawString(0, 86, 1, 1, (uint8_t*)graphSpans[graphSpanIndex].label,
+                     OLEDC_COLOR_WHITE);
+
+    // x-axis markers: 2x2 squares just above the bottom line
+    for (int x = GRAPH_X_START; x <= 95; x += GRID_MARK_STEP)
+        oledC_DrawRectangle(x, GRAPH_BASELINE - 2, x + 1, GRAPH_BASELINE - 1, OLEDC_COLOR_WHITE);
+}
+
+/*------------------------------------------------------------------------------
+ * drawGridColumn: clear one plot column and put back the grid pixels in it,
+ * as drawGraphGrid laid them down
+ *----------------------------------------------------------------------------*/
+static void drawGridColumn(uint8_t x)
+{
+    uint8_t pos = x - GRAPH_X_START;
+
+    oledC_DrawRectangle(x, 0, x, GRAPH_BASELINE, OLEDC_COLOR_BLACK);
+    if (pos % (GRID_DASH + GRID_GAP) < GRID_DASH && pos < 95 - GRAPH_X_START)
+    {
+        for (uint8_t i = 0; i < sizeof(gridLines); i++)
+            oledC_DrawPoint(x, gridLines[i], OLEDC_COLOR_WHITE);
     }
+    if (pos % GRID_MARK_STEP < 2)
+        oledC_DrawRectangle(x, GRAPH_BASELINE - 2, x, GRAPH_BASELINE - 1, OLEDC_COLOR_WHITE);
 }
 
 /*------------------------------------------------------------------------------
- * drawStepsGraph
+ * graphY: a sample averaged with its neighbours in time, as a y coordinate
  *----------------------------------------------------------------------------*/
+static uint8_t graphY(uint8_t slot)
+{
+    uint8_t oldest = (graph.newest + 1) % graph.columns;
+    uint8_t prev = (slot == oldest) ? slot : (slot + graph.columns - 1) % graph.columns;
+    uint8_t next = (slot == graph.newest) ? slot : (slot + 1) % graph.columns;
+    uint32_t smoothed = ((uint32_t)graph.pace[prev] + graph.pace[slot] + graph.pace[next]) / 3;
+
+    if (smoothed >= GRAPH_MAX_PACE)
+        return 0;
+    return GRAPH_BASELINE - (uint8_t)(smoothed * GRAPH_BASELINE / GRAPH_MAX_PACE);
+}
+
 /*------------------------------------------------------------------------------
- * drawStepsGraph
+ * drawGraphColumn: one sample as a vertical run from beside the previous
+ * sample's y to its own, so every segment of the line lives in one column.
+ * The cursor slot stays blank and the sample after it starts the line.
+ * erase first restores the column to the grid.
  *----------------------------------------------------------------------------*/
-static void drawStepsGraph(void)
+static void drawGraphColumn(uint8_t slot, bool erase)
 {
-    // 1) ????? ??????? ?????? ?????? ????? ?????
-    int orderedSteps[GRAPH_SAMPLES];
-    for (int i = 0; i < GRAPH_SAMPLES; i++)
+    uint8_t x = 96 - graph.columns + slot;
+    uint8_t cursor = (graph.newest + 1) % graph.columns;
+    uint8_t y, from;
+
+    if (erase)
+        drawGridColumn(x);
+    if (slot == cursor)
+        return;
+    y = graphY(slot);
+    from = y;
+    if (slot > 0 && slot - 1 != cursor)
     {
-        int idx = (stepsHistoryIndex + i) % GRAPH_SAMPLES;
-        orderedSteps[i] = stepsHistory[idx];
+        from = graphY(slot - 1);
+        if (from < y)
+            from++;
+        else if (from > y)
+            from--;
     }
+    oledC_DrawLine(x, from, x, y, 1, OLEDC_COLOR_WHITE);
+}
 
-    // 2) ????? ????? ?????
-    int orderedSmoothed[GRAPH_SAMPLES];
-    for (int i = 0; i < GRAPH_SAMPLES; i++)
-    {
-        int prev = (i == 0) ? GRAPH_SAMPLES - 1 : i - 1;
-        int next = (i == GRAPH_SAMPLES - 1) ? 0 : i + 1;
-        orderedSmoothed[i] = (orderedSteps[i] + orderedSteps[prev] + orderedSteps[next]) / 3;
-    }
+/*------------------------------------------------------------------------------
+ * graphPace: average pace (steps/min) of a sample from its perColumn buckets'
+ * step total
+ *----------------------------------------------------------------------------*/
+static uint16_t graphPace(uint32_t sum)
+{
+    const GraphSpan *span = &graphSpans[graphSpanIndex];
 
-    // 3) ???? ????
-    int xStart = 20;      // ?????? ???????
-    int baseline = 95;    // ?? ????? ????
-    int maxVal = 100;     // ??? ???????
+    sum = sum * 60 / ((uint32_t)graph.perColumn * stepHistory_bucketSeconds(span->tier));
+    return (sum > 0xFFFF) ? 0xFFFF : (uint16_t)sum;
+}
+
+/*------------------------------------------------------------------------------
+ * readGraphSample: the next sample of a refill, read bucket by bucket
+ *----------------------------------------------------------------------------*/
+static uint16_t readGraphSample(StepHistoryReader *reader)
+{
+    uint32_t sum = 0;
 
-    // ?????? ?? ?????? ??????? (i=0) ???? ????? ???? ??
-    int xPrev = xStart;
-    int yPrev = baseline - (orderedSmoothed[0] * baseline / maxVal);
+    for (uint8_t b = 0; b < graph.perColumn; b++)
+        sum += stepHistory_readNext(reader);
+    return graphPace(sum);
+}
 
-    // ??????? ??? ???? ??????? ????
-    if (yPrev < 0)       yPrev = 0;
-    if (yPrev > baseline) yPrev = baseline;
+/*------------------------------------------------------------------------------
+ * queryGraphSample: one sample on its own, the newest of its buckets
+ * newestAge back, as a step_index range aggregate. Buckets not held count
+ * as 0, as they read in a refill.
+ *----------------------------------------------------------------------------*/
+static uint16_t queryGraphSample(uint16_t newestAge)
+{
+    const GraphSpan *span = &graphSpans[graphSpanIndex];
+    StepAggregate agg;
 
-    // ??? ??????? ????? ?? ??????? ?????? (i=1)
-    for (int i = 1; i < GRAPH_SAMPLES; i++)
-    {
-        int xCur = xStart + i;
-        int yCur = baseline - (orderedSmoothed[i] * baseline / maxVal);
+    (void) stepIndex_query(span->tier, newestAge, newestAge + graph.perColumn - 1, &agg);
+    return graphPace(agg.sum);
+}
 
-        if (yCur < 0)         yCur = 0;
-        if (yCur > baseline)  yCur = baseline;
+/*------------------------------------------------------------------------------
+ * drawStepsGraph: refill the whole ring for the selected span (oldest on
+ * the left) and plot it over the grid. One reader pass decodes each bucket
+ * once, where a query per column would decode the blocks at its ends.
+ *----------------------------------------------------------------------------*/
+static void drawStepsGraph(void)
+{
+    const GraphSpan *span = &graphSpans[graphSpanIndex];
+    StepHistoryReader reader;
+
+    graph.perColumn = (span->buckets + GRAPH_COLUMNS - 1) / GRAPH_COLUMNS;
+    graph.columns = span->buckets / graph.perColumn;
+    graph.newest = graph.columns - 1;
+    graph.closed = stepHistory_closed(span->tier);
+
+    stepHistory_openReader(&reader, span->tier,
+                           (uint16_t)graph.columns * graph.perColumn - 1);
+    for (uint8_t slot = 0; slot < graph.columns; slot++)
+        graph.pace[slot] = readGraphSample(&reader);
+    for (uint8_t slot = 0; slot < graph.columns; slot++)
+        drawGraphColumn(slot, false);
+}
 
-        // ??????? ?? ?????? i-1 ?? ????? i
-        drawLineSmooth(xPrev, yPrev, xCur, yCur, OLEDC_COLOR_WHITE);
+/*------------------------------------------------------------------------------
+ * advanceStepsGraph: take every sample the history has closed since the last
+ * call. Each one repaints four columns: the previous newest (its smoothing
+ * now has a right neighbour), the new one, the cursor over the oldest, and
+ * the column after it, which no longer joins the oldest.
+ *----------------------------------------------------------------------------*/
+static void advanceStepsGraph(void)
+{
+    const GraphSpan *span = &graphSpans[graphSpanIndex];
+    uint16_t behind = stepHistory_closed(span->tier) - graph.closed;
 
-        xPrev = xCur;
-        yPrev = yCur;
+    if (behind < graph.perColumn)
+        return;
+    oledC_beginTransaction();
+    if (behind / graph.perColumn >= graph.columns)
+    {
+        drawGraphGrid();    // fell a whole screen behind
+        drawStepsGraph();
+        oledC_endTransaction();
+        return;
+    }
+    while (behind >= graph.perColumn)
+    {
+        uint8_t previous = graph.newest;
+        graph.newest = (graph.newest + 1) % graph.columns;
+        graph.pace[graph.newest] = queryGraphSample(behind - graph.perColumn);
+        graph.closed += graph.perColumn;
+        behind -= graph.perColumn;
+
+        drawGraphColumn(previous, true);
+        drawGraphColumn(graph.newest, true);
+        drawGraphColumn((graph.newest + 1) % graph.columns, true);
+        drawGraphColumn((graph.newest + 2) % graph.columns, true);
+    }
+    oledC_endTransaction();
+}
+
+/*------------------------------------------------------------------------------
+ * composeGraph: the graph draws on the panel itself, so it repaints whole on
+ * entry and span changes and otherwise only sweeps in the closed samples
+ *----------------------------------------------------------------------------*/
+static void composeGraph(uint16_t changes)
+{
+    if (changes & RENDER_SPAN)
+    {
+        oledC_beginTransaction();   // whole redraw on one SPI1 setup
+        drawGraphGrid();
+        drawStepsGraph();
+        oledC_endTransaction();
+    }
+    else if (changes & RENDER_GRAPH)
+    {
+        advanceStepsGraph();
     }
 }
 
@@ -1530,20 +1502,38 @@ static void drawStepsGraph(void)
  *----------------------------------------------------------------------------*/
 static void displayPedometerGraph(void)
 {
-    computeSmoothedSteps();
-    drawGraphGrid();
-    drawStepsGraph();
+    serviceStepHistory();
+    oledC_renderSetScreen(composeGraph);
 
     // Turn these LEDs off as soon as we enter pedometer.
     LATAbits.LATA8 = 0;
     LATAbits.LATA9 = 0;
 
     uint32_t s1DownStart = 0;
+    accelTap_flush();
 
     while (1)
     {
         bool s1 = isButtonPressed(&PORTA, 11);
 
+        servicePedometer();
+        if (serviceStepHistory())
+            oledC_renderPost(RENDER_GRAPH);
+        stepJournal_idle();
+        oledC_renderService();
+
+        // Tap => next time span (wrapping), double tap => leave
+        TapEvent tap = accelTap_getEvent();
+        if (tap == TAP_SINGLE)
+        {
+            graphSpanIndex = (graphSpanIndex + 1) % GRAPH_SPAN_COUNT;
+            oledC_renderPost(RENDER_SPAN);
+        }
+        else if (tap == TAP_DOUBLE)
+        {
+            break;
+        }
+
         // NEW: Turn RA8 ON if s1 is pressed
         LATAbits.LATA8 = s1 ? 1 : 0;
 
@@ -1567,8 +1557,7 @@ static void displayPedometerGraph(void)
         DELAY_milliseconds(50);
     }
 
-    // Clear screen, return to watch display
-    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
+    // The graph was drawn directly; return to a fully repainted watch display
+    oledC_renderInvalidate();
     currentState = STATE_TIME_DISPLAY;
-    drawInitialDisplay();
 }
\ No newline at end of file
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=oledDriver/oledC.c oledDriver/oledC_shapeHandler.c oledDriver/oledC_shapes.c oledDriver/pin_manager.c spiDriver/spi1_driver.c System/clock.c System/delay.c System/system.c System/traps.c main.c Accel_i2c.c i2cDriver/i2c1_driver.c
+SOURCEFILES_QUOTED_IF_SPACED=oledDriver/oledC.c oledDriver/oledC_shapeHandler.c oledDriver/oledC_shapes.c oledDriver/pin_manager.c spiDriver/spi1_driver.c System/clock.c System/delay.c System/system.c System/traps.c main.c Accel_i2c.c i2cDriver/i2c1_driver.c Accel_tap.c Pedometer/step_history.c Pedometer/step_journal.c Pedometer/step_codec.c Pedometer/step_index.c oledDriver/oledC_framebuffer.c oledDriver/oledC_compositor.c oledDriver/oledC_sprites.c oledDriver/oledC_renderTask.c oledDriver/oledC_shadow.c oledDriver/oledC_segments.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/oledDriver/oledC.o ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o ${OBJECTDIR}/oledDriver/oledC_shapes.o ${OBJECTDIR}/oledDriver/pin_manager.o ${OBJECTDIR}/spiDriver/spi1_driver.o ${OBJECTDIR}/System/clock.o ${OBJECTDIR}/System/delay.o ${OBJECTDIR}/System/system.o ${OBJECTDIR}/System/traps.o ${OBJECTDIR}/main.o ${OBJECTDIR}/Accel_i2c.o ${OBJECTDIR}/i2cDriver/i2c1_driver.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/oledDriver/oledC.o.d ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o.d ${OBJECTDIR}/oledDriver/oledC_shapes.o.d ${OBJECTDIR}/oledDriver/pin_manager.o.d ${OBJECTDIR}/spiDriver/spi1_driver.o.d ${OBJECTDIR}/System/clock.o.d ${OBJECTDIR}/System/delay.o.d ${OBJECTDIR}/System/system.o.d ${OBJECTDIR}/System/traps.o.d ${OBJECTDIR}/main.o.d ${OBJECTDIR}/Accel_i2c.o.d ${OBJECTDIR}/i2cDriver/i2c1_driver.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/oledDriver/oledC.o ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o ${OBJECTDIR}/oledDriver/oledC_shapes.o ${OBJECTDIR}/oledDriver/pin_manager.o ${OBJECTDIR}/spiDriver/spi1_driver.o ${OBJECTDIR}/System/clock.o ${OBJECTDIR}/System/delay.o ${OBJECTDIR}/System/system.o ${OBJECTDIR}/System/traps.o ${OBJECTDIR}/main.o ${OBJECTDIR}/Accel_i2c.o ${OBJECTDIR}/i2cDriver/i2c1_driver.o ${OBJECTDIR}/Accel_tap.o ${OBJECTDIR}/Pedometer/step_history.o ${OBJECTDIR}/Pedometer/step_journal.o ${OBJECTDIR}/Pedometer/step_codec.o ${OBJECTDIR}/Pedometer/step_index.o ${OBJECTDIR}/oledDriver/oledC_framebuffer.o ${OBJECTDIR}/oledDriver/oledC_compositor.o ${OBJECTDIR}/oledDriver/oledC_sprites.o ${OBJECTDIR}/oledDriver/oledC_renderTask.o ${OBJECTDIR}/oledDriver/oledC_shadow.o ${OBJECTDIR}/oledDriver/oledC_segments.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/oledDriver/oledC.o.d ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o.d ${OBJECTDIR}/oledDriver/oledC_shapes.o.d ${OBJECTDIR}/oledDriver/pin_manager.o.d ${OBJECTDIR}/spiDriver/spi1_driver.o.d ${OBJECTDIR}/System/clock.o.d ${OBJECTDIR}/System/delay.o.d ${OBJECTDIR}/System/system.o.d ${OBJECTDIR}/System/traps.o.d ${OBJECTDIR}/main.o.d ${OBJECTDIR}/Accel_i2c.o.d ${OBJECTDIR}/i2cDriver/i2c1_driver.o.d ${OBJECTDIR}/Accel_tap.o.d ${OBJECTDIR}/Pedometer/step_history.o.d ${OBJECTDIR}/Pedometer/step_journal.o.d ${OBJECTDIR}/Pedometer/step_codec.o.d ${OBJECTDIR}/Pedometer/step_index.o.d ${OBJECTDIR}/oledDriver/oledC_framebuffer.o.d ${OBJECTDIR}/oledDriver/oledC_compositor.o.d ${OBJECTDIR}/oledDriver/oledC_sprites.o.d ${OBJECTDIR}/oledDriver/oledC_renderTask.o.d ${OBJECTDIR}/oledDriver/oledC_shadow.o.d ${OBJECTDIR}/oledDriver/oledC_segments.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/oledDriver/oledC.o ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o ${OBJECTDIR}/oledDriver/oledC_shapes.o ${OBJECTDIR}/oledDriver/pin_manager.o ${OBJECTDIR}/spiDriver/spi1_driver.o ${OBJECTDIR}/System/clock.o ${OBJECTDIR}/System/delay.o ${OBJECTDIR}/System/system.o ${OBJECTDIR}/System/traps.o ${OBJECTDIR}/main.o ${OBJECTDIR}/Accel_i2c.o ${OBJECTDIR}/i2cDriver/i2c1_driver.o
+OBJECTFILES=${OBJECTDIR}/oledDriver/oledC.o ${OBJECTDIR}/oledDriver/oledC_shapeHandler.o ${OBJECTDIR}/oledDriver/oledC_shapes.o ${OBJECTDIR}/oledDriver/pin_manager.o ${OBJECTDIR}/spiDriver/spi1_driver.o ${OBJECTDIR}/System/clock.o ${OBJECTDIR}/System/delay.o ${OBJECTDIR}/System/system.o ${OBJECTDIR}/System/traps.o ${OBJECTDIR}/main.o ${OBJECTDIR}/Accel_i2c.o ${OBJECTDIR}/i2cDriver/i2c1_driver.o ${OBJECTDIR}/Accel_tap.o ${OBJECTDIR}/Pedometer/step_history.o ${OBJECTDIR}/Pedometer/step_journal.o ${OBJECTDIR}/Pedometer/step_codec.o ${OBJECTDIR}/Pedometer/step_index.o ${OBJECTDIR}/oledDriver/oledC_framebuffer.o ${OBJECTDIR}/oledDriver/oledC_compositor.o ${OBJECTDIR}/oledDriver/oledC_sprites.o ${OBJECTDIR}/oledDriver/oledC_renderTask.o ${OBJECTDIR}/oledDriver/oledC_shadow.o ${OBJECTDIR}/oledDriver/oledC_segments.o
 
 # Source Files
-SOURCEFILES=oledDriver/oledC.c oledDriver/oledC_shapeHandler.c oledDriver/oledC_shapes.c oledDriver/pin_manager.c spiDriver/spi1_driver.c System/clock.c System/delay.c System/system.c System/traps.c main.c Accel_i2c.c i2cDriver/i2c1_driver.c
+SOURCEFILES=oledDriver/oledC.c oledDriver/oledC_shapeHandler.c oledDriver/oledC_shapes.c oledDriver/pin_manager.c spiDriver/spi1_driver.c System/clock.c System/delay.c System/system.c System/traps.c main.c Accel_i2c.c i2cDriver/i2c1_driver.c Accel_tap.c Pedometer/step_history.c Pedometer/step_journal.c Pedometer/step_codec.c Pedometer/step_index.c oledDriver/oledC_framebuffer.c oledDriver/oledC_compositor.c oledDriver/oledC_sprites.c oledDriver/oledC_renderTask.c oledDriver/oledC_shadow.c oledDriver/oledC_segments.c
 
 
 
@@ -161,6 +161,72 @@ ${OBJECTDIR}/i2cDriver/i2c1_driver.o: i2cDriver/i2c1_driver.c  .generated_files/
 	@${RM} ${OBJECTDIR}/i2cDriver/i2c1_driver.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE)  i2cDriver/i2c1_driver.c  -o ${OBJECTDIR}/i2cDriver/i2c1_driver.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/i2cDriver/i2c1_driver.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
 	
+${OBJECTDIR}/Accel_tap.o: Accel_tap.c  .generated_files/flags/default/90727dd6e332e6f9e638d4f5aa7a7109cd37f37c .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Accel_tap.o.d 
+	@${RM} ${OBJECTDIR}/Accel_tap.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Accel_tap.c  -o ${OBJECTDIR}/Accel_tap.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Accel_tap.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_history.o: Pedometer/step_history.c  .generated_files/flags/default/06374038ca0e44d5021ac07f0e96188cef09c719 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_history.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_history.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_history.c  -o ${OBJECTDIR}/Pedometer/step_history.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_history.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_journal.o: Pedometer/step_journal.c  .generated_files/flags/default/afc9059923cacb4f0bc68018e2bfd414a8dd410a .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_journal.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_journal.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_journal.c  -o ${OBJECTDIR}/Pedometer/step_journal.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_journal.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_codec.o: Pedometer/step_codec.c  .generated_files/flags/default/da2d1619678fd74d8e0dad8922c789137dc2fb67 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_codec.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_codec.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_codec.c  -o ${OBJECTDIR}/Pedometer/step_codec.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_codec.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_index.o: Pedometer/step_index.c  .generated_files/flags/default/690b2ce20c3983151434028030dc51dd01bdd690 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_index.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_index.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_index.c  -o ${OBJECTDIR}/Pedometer/step_index.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_index.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_framebuffer.o: oledDriver/oledC_framebuffer.c  .generated_files/flags/default/630420664d8c1a3c935e87d0901c0a63998be8d7 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_framebuffer.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_framebuffer.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_framebuffer.c  -o ${OBJECTDIR}/oledDriver/oledC_framebuffer.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_framebuffer.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_compositor.o: oledDriver/oledC_compositor.c  .generated_files/flags/default/c6e4673f6455cdc82f01efce222f338e5c421062 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_compositor.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_compositor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_compositor.c  -o ${OBJECTDIR}/oledDriver/oledC_compositor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_compositor.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_sprites.o: oledDriver/oledC_sprites.c  .generated_files/flags/default/aa33cc4af9a400bda103ae82352f65c1c5d379a4 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_sprites.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_sprites.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_sprites.c  -o ${OBJECTDIR}/oledDriver/oledC_sprites.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_sprites.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_renderTask.o: oledDriver/oledC_renderTask.c  .generated_files/flags/default/490fec4bf0ab3a25ef5c35be4226cbcae8a7ef6d .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_renderTask.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_renderTask.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_renderTask.c  -o ${OBJECTDIR}/oledDriver/oledC_renderTask.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_renderTask.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_shadow.o: oledDriver/oledC_shadow.c  .generated_files/flags/default/9dc34b575f8ef2bd9d8515a0c0af7e9b0f69b162 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_shadow.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_shadow.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_shadow.c  -o ${OBJECTDIR}/oledDriver/oledC_shadow.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_shadow.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_segments.o: oledDriver/oledC_segments.c  .generated_files/flags/default/d06c8309bbd51990cec16969c2d3cde9da60163e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_segments.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_segments.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_segments.c  -o ${OBJECTDIR}/oledDriver/oledC_segments.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_segments.o.d"      -g -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1  -mno-eds-warn  -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
 else
 ${OBJECTDIR}/oledDriver/oledC.o: oledDriver/oledC.c  .generated_files/flags/default/98af7dc4fb291ff026f98cfdea1f77c684afe735 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}/oledDriver" 
@@ -234,6 +300,72 @@ ${OBJECTDIR}/i2cDriver/i2c1_driver.o: i2cDriver/i2c1_driver.c  .generated_files/
 	@${RM} ${OBJECTDIR}/i2cDriver/i2c1_driver.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE)  i2cDriver/i2c1_driver.c  -o ${OBJECTDIR}/i2cDriver/i2c1_driver.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/i2cDriver/i2c1_driver.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
 	
+${OBJECTDIR}/Accel_tap.o: Accel_tap.c  .generated_files/flags/default/9e4c4556d72360a88ac46fdedac9d74fbb7e17dd .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Accel_tap.o.d 
+	@${RM} ${OBJECTDIR}/Accel_tap.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Accel_tap.c  -o ${OBJECTDIR}/Accel_tap.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Accel_tap.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_history.o: Pedometer/step_history.c  .generated_files/flags/default/9663e2797b7176c96c277e2d3a5fbcbe9b9a9314 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_history.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_history.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_history.c  -o ${OBJECTDIR}/Pedometer/step_history.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_history.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_journal.o: Pedometer/step_journal.c  .generated_files/flags/default/1414974acbf6edde974366cea2111f78c2ff73d5 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_journal.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_journal.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_journal.c  -o ${OBJECTDIR}/Pedometer/step_journal.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_journal.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_codec.o: Pedometer/step_codec.c  .generated_files/flags/default/eb9f715f930254aaeee05b2b4858a32871b8429e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_codec.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_codec.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_codec.c  -o ${OBJECTDIR}/Pedometer/step_codec.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_codec.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/Pedometer/step_index.o: Pedometer/step_index.c  .generated_files/flags/default/1fde40bd095ec4a08da6d265af454b883e9b4c14 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/Pedometer" 
+	@${RM} ${OBJECTDIR}/Pedometer/step_index.o.d 
+	@${RM} ${OBJECTDIR}/Pedometer/step_index.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  Pedometer/step_index.c  -o ${OBJECTDIR}/Pedometer/step_index.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/Pedometer/step_index.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_framebuffer.o: oledDriver/oledC_framebuffer.c  .generated_files/flags/default/48a6f3c17ab5b24e410583dfc6582c0ea9e95054 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_framebuffer.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_framebuffer.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_framebuffer.c  -o ${OBJECTDIR}/oledDriver/oledC_framebuffer.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_framebuffer.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_compositor.o: oledDriver/oledC_compositor.c  .generated_files/flags/default/535c1627eeff545f84b7db342187fa5a027de646 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_compositor.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_compositor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_compositor.c  -o ${OBJECTDIR}/oledDriver/oledC_compositor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_compositor.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_sprites.o: oledDriver/oledC_sprites.c  .generated_files/flags/default/fe179d47cdad7d280ddda79e165095ca1496c038 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_sprites.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_sprites.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_sprites.c  -o ${OBJECTDIR}/oledDriver/oledC_sprites.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_sprites.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_renderTask.o: oledDriver/oledC_renderTask.c  .generated_files/flags/default/920588e15ef505774019985e92934667323122d8 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_renderTask.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_renderTask.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_renderTask.c  -o ${OBJECTDIR}/oledDriver/oledC_renderTask.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_renderTask.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_shadow.o: oledDriver/oledC_shadow.c  .generated_files/flags/default/372a18dd9b115fe5d70163f332816c49c6e226c2 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_shadow.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_shadow.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_shadow.c  -o ${OBJECTDIR}/oledDriver/oledC_shadow.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_shadow.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
+${OBJECTDIR}/oledDriver/oledC_segments.o: oledDriver/oledC_segments.c  .generated_files/flags/default/15abeff65f740866af4ff6fa2106c1f86772af1e .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}/oledDriver" 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_segments.o.d 
+	@${RM} ${OBJECTDIR}/oledDriver/oledC_segments.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  oledDriver/oledC_segments.c  -o ${OBJECTDIR}/oledDriver/oledC_segments.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/oledDriver/oledC_segments.o.d"      -mno-eds-warn  -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -O0 -I"bsp" -DFCY=4000000 -msmart-io=1 -Wall -msfr-warn=off   
+	
 endif
 
 # ------------------------------------------------------------------------------------
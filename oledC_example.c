@@ -29,33 +29,39 @@
 
 static bool exampleInitialized;
 static uint16_t background_color;
+static oledc_shape_handle_t logo;
 
-static const uint32_t logo[] = 
-{ 
-    0b11111111111000000000011111111111,
-    0b11111111100000000000001111111111,
-    0b11111111000000000000000111111111,
-    0b11111110000000000000000111111111,
-    0b11111100000000000000000011111111,
-    0b11111000000010000000100011111111,
-    0b11111000000110000001100001111111,
-    0b11110000001111000011110000111111,
-    0b11110000001111100011111000111111,
-    0b11110000000111100001111000011111,
-    0b11110000000111110001111100001111,
-    0b11110001000011110000111110001111,
-    0b11110001100011111000111110001111,
-    0b11110011110001111100011111001111,
-    0b11110111110000111100001111001111,
-    0b11111111100000111100001111111111,
-    0b11111111100000011100000111111111,
-    0b11111111000000011000000011111111,
-    0b11111110000000000000000011111111,
-    0b11111110000000000000000001111111,
-    0b11111110000000000000000001111111,
-    0b11111111100000000000000111111111,
-    0b11111111111000000000011111111111
+// logoImage: 32x23, converted with tools/rle_convert.c
+static const uint8_t logoImageRuns[] = {
+    OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 10), OLEDC_RLE_RUN(0, 20), OLEDC_RLE_RUN(1, 13),
+    OLEDC_RLE_RUN(0, 18), OLEDC_RLE_RUN(1, 15), OLEDC_RLE_RUN(0, 16), OLEDC_RLE_RUN(1, 16),
+    OLEDC_RLE_RUN(0, 15), OLEDC_RLE_RUN(1, 18), OLEDC_RLE_RUN(0, 13), OLEDC_RLE_RUN(1, 7),
+    OLEDC_RLE_RUN(0, 1), OLEDC_RLE_RUN(1, 7), OLEDC_RLE_RUN(0, 1), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 13), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 11), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 6), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3), OLEDC_RLE_RUN(0, 10), OLEDC_RLE_RUN(1, 7),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 9), OLEDC_RLE_RUN(1, 7), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 8), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 1), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3), OLEDC_RLE_RUN(0, 8), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 3), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3), OLEDC_RLE_RUN(0, 8), OLEDC_RLE_RUN(1, 2),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 3), OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 3),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 2), OLEDC_RLE_RUN(0, 8), OLEDC_RLE_RUN(1, 1),
+    OLEDC_RLE_RUN(0, 5), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 2), OLEDC_RLE_RUN(0, 13), OLEDC_RLE_RUN(1, 5),
+    OLEDC_RLE_RUN(0, 4), OLEDC_RLE_RUN(1, 4), OLEDC_RLE_RUN(0, 19), OLEDC_RLE_RUN(1, 6),
+    OLEDC_RLE_RUN(0, 3), OLEDC_RLE_RUN(1, 5), OLEDC_RLE_RUN(0, 17), OLEDC_RLE_RUN(1, 7),
+    OLEDC_RLE_RUN(0, 2), OLEDC_RLE_RUN(1, 7), OLEDC_RLE_RUN(0, 15), OLEDC_RLE_RUN(1, 17),
+    OLEDC_RLE_RUN(0, 15), OLEDC_RLE_RUN(1, 18), OLEDC_RLE_RUN(0, 14), OLEDC_RLE_RUN(1, 18),
+    OLEDC_RLE_RUN(0, 16), OLEDC_RLE_RUN(1, 14), OLEDC_RLE_RUN(0, 20), OLEDC_RLE_RUN(1, 10),
+    OLEDC_RLE_RUN(0, 11)
 };
+static const uint16_t logoImageColors[] = { 0xFFFF, 0xF800 };
+static const oledc_rle_image_t logoImage = { 32, 23, 2, logoImageColors, logoImageRuns };
 
 static void oledC_clearScreen(void) 
 {    
@@ -75,6 +81,7 @@ static void oledC_clearScreen(void)
 static void oledC_setBackground(uint16_t color)
 {
     background_color = color;
+    oledC_setShapeBackground(color);
     oledC_clearScreen();
 }
 
@@ -83,57 +90,67 @@ static void oledC_example_setup(void)
     oledC_setBackground(OLEDC_COLOR_WHITE);
     shape_params_t params;
     
-    params.bitmap.color = OLEDC_COLOR_RED;
-    params.bitmap.x = 14;
-    params.bitmap.y = 25;
-    params.bitmap.sx = 2;
-    params.bitmap.sy = 2;
-    params.bitmap.bit_array = (uint32_t *)&logo[0];
-    params.bitmap.array_length = 23;
-    oledC_addShape(0,OLED_SHAPE_BITMAP, &params);
+    params.rle.color = OLEDC_COLOR_RED;
+    params.rle.x = 16;
+    params.rle.y = 25;
+    params.rle.sx = 2;
+    params.rle.sy = 2;
+    params.rle.image = &logoImage;
+    logo = oledC_newShape(OLED_SHAPE_RLE, &params);
     
     params.circle.radius = 10;
     params.circle.xc = 10;
     params.circle.yc = 10;
-    oledC_addShape(1,OLED_SHAPE_CIRCLE, &params);
+    oledC_newShape(OLED_SHAPE_CIRCLE, &params);
     
     params.circle.color = OLEDC_COLOR_BLUE;
     params.circle.yc = 85;
-    oledC_addShape(2,OLED_SHAPE_CIRCLE, &params);
+    oledC_newShape(OLED_SHAPE_CIRCLE, &params);
     
     params.circle.color = OLEDC_COLOR_YELLOW;
     params.circle.xc = 85;
-    oledC_addShape(3,OLED_SHAPE_CIRCLE, &params);
+    oledC_newShape(OLED_SHAPE_CIRCLE, &params);
     
     params.circle.color = OLEDC_COLOR_GREEN;
     params.circle.yc = 10;
-    oledC_addShape(4,OLED_SHAPE_CIRCLE, &params);
+    oledC_newShape(OLED_SHAPE_CIRCLE, &params);
     
+    params.string.color = OLEDC_COLOR_BLACK;
+    params.string.x = 10;
+    params.string.y = 0;
+    params.string.scale_x = 2;
+    params.string.scale_y = 2;
+    params.string.string = (uint8_t*)"Shenkar";
+    oledC_newShape(OLED_SHAPE_STRING, &params);
     
-    oledC_redrawAll();
+    params.string.color = OLEDC_COLOR_DARKGREEN;
+    params.string.x = 30;
+    params.string.y = 78;
+    params.string.string = (uint8_t*)"Lab";
+    oledC_newShape(OLED_SHAPE_STRING, &params);
+    
+    oledC_redrawDirty();
     exampleInitialized = true;
 }
 
 void oledC_example(void)
 {
     static int8_t shift = -24;
-    const uint8_t shift_from = 15;
+    const uint8_t shift_from = 17;
     if(!exampleInitialized)
     {
         oledC_example_setup();
     }
-    
-    oledC_DrawString(10,0,2,2,(uint8_t*)"Shenkar", OLEDC_COLOR_BLACK);
-    oledC_DrawString(30,78,2,2,(uint8_t*)"Lab", OLEDC_COLOR_DARKGREEN);
-    shape_t *moveIt = oledC_getShape(0);
+    shape_t *moveIt = oledC_shapeOf(logo);
            
-    oledC_eraseShape(0, background_color);
-    moveIt->params.bitmap.x = shift_from + shift;
+    // The logo paints its whole box: only the strip it leaves goes back to the background
+    moveIt->params.rle.x = shift_from + shift;
+    oledC_shapeChanged(logo);
     shift += 4;
     if(shift > 24)
     {
         shift = -24;
     }
-    oledC_redrawIndex(0);
+    oledC_redrawDirty();
 }
 
@@ -24,6 +24,8 @@
 #include <stdbool.h>
 #include "../spiDriver/spi1_driver.h"
 #include "oledC.h"
+#include "oledC_framebuffer.h"
+#include "oledC_shadow.h"
 #include "pin_manager.h"
 #include "../system/delay.h"
 
@@ -33,9 +35,36 @@ enum STREAMING_MODES
 };
 static uint8_t streamingMode = NOSTREAM;
 
-static void startStreamingIfNeeded(OLEDC_COMMAND cmd);
+/*
+ * The controller holds 128 rows and 128 columns of RAM; the panel shows 96
+ * of each. Columns 16..111 are the visible ones. Rows follow the start line:
+ * drawing row y lands on RAM row (y + rowOrigin) % 128, so scrolling moves
+ * the origin instead of the pixels and the 32 rows off the panel take the
+ * rows about to come into view.
+ */
+#define PANEL_ROWS          96
+#define RAM_ROWS            128
+#define RAM_COLUMNS         128
+#define COLUMN_OFFSET       16
+#define START_LINE_HOME     0x20
+#define DISPLAY_OFFSET_HOME 0x60    // the controller's reset value
+static uint8_t rowOrigin;
+static bool horizontalScroll;
+
+static uint8_t transactionDepth;
+static bool dataPhase;
+static oledc_bus_stats_t busStats;
+static uint16_t tileBuffer[2][OLEDC_TILE_PIXELS];
+
 static void stopStreaming(void);
+static void commandByte(uint8_t cmd);
+static void dataByte(uint8_t byte);
+static void dataPhaseOn(void);
 static uint16_t exchangeTwoBytes(uint8_t byte1, uint8_t byte2);
+static bool openRamWindow(uint8_t column0, uint8_t row0, uint8_t column1, uint8_t row1);
+static bool openWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+static void closeWindow(void);
+static uint8_t wrapRow(uint8_t y0, uint8_t y1);
 
 oledc_color_t oledC_parseIntToRGB(uint16_t raw)
 {
@@ -60,60 +89,131 @@ uint16_t oledC_parseRGBToInt(uint8_t red, uint8_t green, uint8_t blue)
     return (((uint16_t)byte1) << 8) | byte2;
 }
 
-static void startStreamingIfNeeded(OLEDC_COMMAND cmd)
+/*
+ * SPI1 is configured and nCS dropped by the outermost beginTransaction only;
+ * nested calls just count. DC follows the command/data phase and is only
+ * driven when the phase changes.
+ */
+bool oledC_beginTransaction(void)
 {
-    if(cmd == OLEDC_CMD_WRITE_RAM || cmd == OLEDC_CMD_READ_RAM)
+    if(transactionDepth == 0)
     {
-        streamingMode = cmd == OLEDC_CMD_WRITE_RAM ? WRITESTREAM : READSTREAM;
-    } 
-    else 
+        if(!oledC_open())
+        {
+            return false;
+        }
+        busStats.transactions++;
+        LATCbits.LATC3 = 0; /* set oledC_DC output low */
+        dataPhase = false;
+        LATCbits.LATC9 = 0; /* set oledC_nCS output low */
+    }
+    transactionDepth++;
+    return true;
+}
+
+void oledC_endTransaction(void)
+{
+    if(transactionDepth == 0 || --transactionDepth > 0)
     {
-        streamingMode = NOSTREAM;
+        return;
     }
+    LATCbits.LATC9 = 1; /* set oledC_nCS output high */
+    LATCbits.LATC3 = 0; /* set oledC_DC output low */
+    dataPhase = false;
+    spi1_close();
+}
+
+void oledC_getBusStats(oledc_bus_stats_t *stats)
+{
+    *stats = busStats;
+}
+
+void oledC_resetBusStats(void)
+{
+    busStats.bytes = 0;
+    busStats.commands = 0;
+    busStats.transactions = 0;
 }
 
+static void commandByte(uint8_t cmd)
+{
+    if(dataPhase)
+    {
+        LATCbits.LATC3 = 0; /* set oledC_DC output low */
+        dataPhase = false;
+    }
+    spi1_exchangeByte(cmd);
+    busStats.bytes++;
+    busStats.commands++;
+}
+
+static void dataPhaseOn(void)
+{
+    if(!dataPhase)
+    {
+        LATCbits.LATC3 = 1; /* set oledC_DC output high */
+        dataPhase = true;
+    }
+}
+
+static void dataByte(uint8_t byte)
+{
+    dataPhaseOn();
+    spi1_exchangeByte(byte);
+    busStats.bytes++;
+}
+
+/* A RAM stream holds its own transaction until it is stopped */
 static void stopStreaming(void)
 {
-    streamingMode = NOSTREAM;
+    if(streamingMode != NOSTREAM)
+    {
+        streamingMode = NOSTREAM;
+        oledC_endTransaction();
+    }
 }
 
 static uint16_t exchangeTwoBytes(uint8_t byte1, uint8_t byte2)
 {
-    if(!oledC_open())
+    if(!oledC_beginTransaction())
     {
         return 0xFFFF;
     }
+    dataPhaseOn();
     byte1 = spi1_exchangeByte(byte1);
     byte2 = spi1_exchangeByte(byte2);
-    spi1_close();
+    busStats.bytes += 2;
+    oledC_endTransaction();
     return ((uint16_t)byte1) << 8 | byte2;
 }
 
 void oledC_sendCommand(OLEDC_COMMAND cmd, uint8_t *payload, uint8_t payload_size)
 {
-    if(!oledC_open())
+    stopStreaming();
+    if(!oledC_beginTransaction())
     {
         return;
     }
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 0; /* set oledC_DC output low */
-    spi1_exchangeByte(cmd);
-    if(payload_size > 0)
+    commandByte(cmd);
+    while(payload_size--)
     {
-        LATCbits.LATC3 = 1; /* set oledC_DC output high */
-        spi1_writeBlock(payload, payload_size);
-        LATCbits.LATC3 = 0; /* set oledC_DC output low */
+        dataByte(*payload++);
     }
-    LATCbits.LATC9 = 1; /* set oledC_nCS output high */
-    spi1_close();
-    startStreamingIfNeeded(cmd);
+    oledC_endTransaction();
 }
 
+/* Rows past the end of RAM are cut off when the bounds cross it */
 void oledC_setRowAddressBounds(uint8_t min, uint8_t max)
 {
     uint8_t payload[2];
-    payload[0] = min > 95 ? 95 : min;
-    payload[1] = max > 95 ? 95 : max;
+    min = min > 95 ? 95 : min;
+    max = max > 95 ? 95 : max;
+    payload[0] = (min + rowOrigin) % RAM_ROWS;
+    payload[1] = (max + rowOrigin) % RAM_ROWS;
+    if(payload[1] < payload[0])
+    {
+        payload[1] = RAM_ROWS - 1;
+    }
     oledC_sendCommand(OLEDC_CMD_SET_ROW_ADDRESS, payload, 2);
     
 }
@@ -138,15 +238,119 @@ void oledC_setDisplayOrientation(void)
     uint8_t payload[1];
     payload[0] = 0x32;
     oledC_sendCommand(OLEDC_CMD_SET_REMAP_DUAL_COM_LINE_MODE, payload, 1);
-    payload[0] = 0x20;
+    payload[0] = (START_LINE_HOME + rowOrigin) % RAM_ROWS;
+    oledC_sendCommand(OLEDC_CMD_SET_DISPLAY_START_LINE, payload, 1);
+}
+
+/*
+ * The rows coming in are drawn, or cleared, while they are still in the
+ * hidden part of RAM; only then does the start line move, so they appear
+ * whole. Pending shadow tiles go out first, at the rows they were drawn for.
+ */
+void oledC_scrollRows(int8_t rows, oledc_render_t render, void *context)
+{
+    uint8_t count, y0;
+    uint8_t payload[1];
+
+    rows = rows > OLEDC_SCROLL_MAX_ROWS ? OLEDC_SCROLL_MAX_ROWS : rows;
+    rows = rows < -OLEDC_SCROLL_MAX_ROWS ? -OLEDC_SCROLL_MAX_ROWS : rows;
+    if(rows == 0 || !oledC_beginTransaction())
+    {
+        return;
+    }
+    oledC_flush();
+    count = rows < 0 ? -rows : rows;
+    y0 = rows < 0 ? 0 : PANEL_ROWS - count;
+    rowOrigin = (rowOrigin + rows) & (RAM_ROWS - 1);
+#if OLEDC_FRAMEBUFFER_BPP
+    oledC_fbScroll(rows);
+#endif
+    oledC_shadowStale();
+    if(render)
+    {
+        oledC_RenderWindow(0, y0, 95, y0 + count - 1, render, context);
+    }
+    else
+    {
+        oledC_FillWindow(0, y0, 95, y0 + count - 1, 0x0000, 96U * count);
+    }
+    oledC_flush();
+    payload[0] = (START_LINE_HOME + rowOrigin) % RAM_ROWS;
     oledC_sendCommand(OLEDC_CMD_SET_DISPLAY_START_LINE, payload, 1);
+    oledC_endTransaction();
+}
+
+void oledC_setDisplayOffset(int8_t rows)
+{
+    uint8_t payload[1];
+    payload[0] = (DISPLAY_OFFSET_HOME + rows) & (RAM_ROWS - 1);
+    oledC_sendCommand(OLEDC_CMD_SET_DISPLAY_OFFSET, payload, 1);
+}
+
+/*
+ * The scroll wraps whole RAM rows, so the 32 hidden columns pass through the
+ * picture; they are cleared first. RAM cannot be written while the
+ * controller scrolls, so any window stops it.
+ */
+void oledC_startHorizontalScroll(int8_t columns, uint8_t y0, uint8_t y1, uint8_t interval)
+{
+    uint8_t payload[5];
+    uint8_t row0, row1;
+
+    y0 = y0 > 95 ? 95 : y0;
+    y1 = y1 > 95 ? 95 : y1;
+    if(y0 > y1 || columns == 0 || !oledC_beginTransaction())
+    {
+        return;
+    }
+    oledC_stopHorizontalScroll();
+    row0 = (y0 + rowOrigin) % RAM_ROWS;
+    row1 = (y1 + rowOrigin) % RAM_ROWS;
+    row1 = row1 < row0 ? RAM_ROWS - 1 : row1;
+    if(openRamWindow(0, row0, COLUMN_OFFSET - 1, row1))
+    {
+        dataPhaseOn();
+        spi1_writeRepeat16(0x0000, (uint16_t)COLUMN_OFFSET * (row1 - row0 + 1));
+        busStats.bytes += 2UL * COLUMN_OFFSET * (row1 - row0 + 1);
+    }
+    if(openRamWindow(COLUMN_OFFSET + 96, row0, RAM_COLUMNS - 1, row1))
+    {
+        dataPhaseOn();
+        spi1_writeRepeat16(0x0000, (uint16_t)COLUMN_OFFSET * (row1 - row0 + 1));
+        busStats.bytes += 2UL * COLUMN_OFFSET * (row1 - row0 + 1);
+    }
+    columns = columns > 63 ? 63 : columns;
+    payload[0] = (uint8_t)columns;
+    payload[1] = row0;
+    payload[2] = row1 - row0 + 1;
+    payload[3] = 0;
+    payload[4] = interval;
+    oledC_sendCommand(OLEDC_CMD_HORIZONTAL_SCROLL, payload, 5);
+    oledC_sendCommand(OLEDC_CMD_START_SCROLL, NULL, 0);
+    horizontalScroll = true;
+    oledC_shadowStale();
+    oledC_endTransaction();
+}
+
+void oledC_stopHorizontalScroll(void)
+{
+    if(horizontalScroll)
+    {
+        horizontalScroll = false;
+        oledC_sendCommand(OLEDC_CMD_STOP_SCROLL, NULL, 0);
+    }
 }
 
 void oledC_startReadingDisplay(void)
 {
-    oledC_sendCommand(OLEDC_CMD_READ_RAM, NULL, 0);    
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 1; /* set oledC_DC output high */
+    oledC_stopHorizontalScroll();
+    stopStreaming();
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
+    commandByte(OLEDC_CMD_READ_RAM);
+    streamingMode = READSTREAM;
 }
 
 void oledC_stopReadingDisplay(void)
@@ -169,15 +373,18 @@ uint16_t oledC_readColor(void)
 
 void oledC_startWritingDisplay(void)
 {
-    oledC_sendCommand(OLEDC_CMD_WRITE_RAM, NULL, 0);    
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 1; /* set oledC_DC output high */
+    oledC_stopHorizontalScroll();
+    stopStreaming();
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
+    commandByte(OLEDC_CMD_WRITE_RAM);
+    streamingMode = WRITESTREAM;
 }
 
 void oledC_stopWritingDisplay(void)
 {
-    LATCbits.LATC9 = 1; /* set oledC_nCS output high */
-    LATCbits.LATC3 = 0; /* set oledC_DC output low */
     stopStreaming();
 }
 
@@ -199,6 +406,184 @@ void oledC_sendColorInt(uint16_t raw)
     exchangeTwoBytes(raw >> 8, raw & 0x00FF);
 }
 
+/* Column, row and WRITE_RAM in one transaction, left in the data phase for the pixels */
+static bool openRamWindow(uint8_t column0, uint8_t row0, uint8_t column1, uint8_t row1)
+{
+    oledC_stopHorizontalScroll();
+    stopStreaming();
+    if(!oledC_beginTransaction())
+    {
+        return false;
+    }
+    commandByte(OLEDC_CMD_SET_COLUMN_ADDRESS);
+    dataByte(column0);
+    dataByte(column1);
+    commandByte(OLEDC_CMD_SET_ROW_ADDRESS);
+    dataByte(row0);
+    dataByte(row1);
+    commandByte(OLEDC_CMD_WRITE_RAM);
+    return true;
+}
+
+/* A window in panel coordinates; callers split the ones that cross the end of RAM */
+static bool openWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    x0 = x0 > 95 ? 95 : x0;
+    y0 = y0 > 95 ? 95 : y0;
+    x1 = x1 > 95 ? 95 : x1;
+    y1 = y1 > 95 ? 95 : y1;
+    if(x0 > x1 || y0 > y1)
+    {
+        return false;
+    }
+    return openRamWindow(COLUMN_OFFSET + x0, (y0 + rowOrigin) % RAM_ROWS,
+                         COLUMN_OFFSET + x1, (y1 + rowOrigin) % RAM_ROWS);
+}
+
+/* The first row of y0..y1 that lands on RAM row 0, or 0 when the window does not wrap */
+static uint8_t wrapRow(uint8_t y0, uint8_t y1)
+{
+    uint8_t wrap = RAM_ROWS - rowOrigin;
+    y1 = y1 > 95 ? 95 : y1;
+    return (rowOrigin && y0 < wrap && wrap <= y1) ? wrap : 0;
+}
+
+#if !OLEDC_FRAMEBUFFER_BPP
+/* Pixels in the rows of x0..x1 above row wrap */
+static uint16_t pixelsBefore(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t wrap)
+{
+    x0 = x0 > 95 ? 95 : x0;
+    x1 = x1 > 95 ? 95 : x1;
+    return x0 > x1 ? 0 : (uint16_t)(x1 - x0 + 1) * (wrap - y0);
+}
+#endif
+
+static void closeWindow(void)
+{
+    oledC_endTransaction();
+}
+
+void oledC_WriteWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n)
+{
+#if OLEDC_FRAMEBUFFER_BPP
+    oledC_fbWrite(x0, y0, x1, y1, pixels, n);
+#else
+    uint8_t wrap = wrapRow(y0, y1);
+    uint16_t head;
+    if(wrap)
+    {
+        head = pixelsBefore(x0, y0, x1, wrap);
+        head = head > n ? n : head;
+        oledC_WriteWindow(x0, y0, x1, wrap - 1, pixels, head);
+        if(n > head)
+        {
+            oledC_WriteWindow(x0, wrap, x1, y1, pixels + head, n - head);
+        }
+        return;
+    }
+    oledC_shadowWrite(x0, y0, x1, y1, pixels, n);
+    if(!openWindow(x0, y0, x1, y1))
+    {
+        return;
+    }
+    dataPhaseOn();
+    spi1_writeBlock16(pixels, n);
+    busStats.bytes += 2UL * n;
+    closeWindow();
+#endif
+}
+
+void oledC_FillWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n)
+{
+#if OLEDC_FRAMEBUFFER_BPP
+    oledC_fbFill(x0, y0, x1, y1, color, n);
+#else
+    uint8_t wrap = wrapRow(y0, y1);
+    uint16_t head;
+    if(wrap)
+    {
+        head = pixelsBefore(x0, y0, x1, wrap);
+        head = head > n ? n : head;
+        oledC_FillWindow(x0, y0, x1, wrap - 1, color, head);
+        if(n > head)
+        {
+            oledC_FillWindow(x0, wrap, x1, y1, color, n - head);
+        }
+        return;
+    }
+    oledC_shadowFill(x0, y0, x1, y1, color, n);
+    if(!openWindow(x0, y0, x1, y1))
+    {
+        return;
+    }
+    dataPhaseOn();
+    spi1_writeRepeat16(color, n);
+    busStats.bytes += 2UL * n;
+    closeWindow();
+#endif
+}
+
+void oledC_RenderPanelWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oledc_render_t render, void *context)
+{
+    uint8_t width, rows, y;
+    uint8_t tile = 0;
+    uint8_t wrap = wrapRow(y0, y1);
+    if(wrap)
+    {
+        oledC_RenderPanelWindow(x0, y0, x1, wrap - 1, render, context);
+        oledC_RenderPanelWindow(x0, wrap, x1, y1, render, context);
+        return;
+    }
+    x0 = x0 > 95 ? 95 : x0;
+    y0 = y0 > 95 ? 95 : y0;
+    x1 = x1 > 95 ? 95 : x1;
+    y1 = y1 > 95 ? 95 : y1;
+    if(!openWindow(x0, y0, x1, y1))
+    {
+        return;
+    }
+    width = x1 - x0 + 1;
+    dataPhaseOn();
+    for(y = y0; y <= y1; y += rows)
+    {
+        rows = OLEDC_TILE_PIXELS / width;
+        rows = (rows > y1 - y + 1) ? y1 - y + 1 : rows;
+        render(tileBuffer[tile], x0, y, width, rows, context);
+        oledC_shadowWrite(x0, y, x1, y + rows - 1, tileBuffer[tile], (uint16_t)width * rows);
+        spi1_writeBlockDMA(tileBuffer[tile], (uint16_t)width * rows, NULL);
+        busStats.bytes += 2UL * width * rows;
+        tile ^= 1;
+    }
+    spi1_dmaWait();
+    closeWindow();
+}
+
+/* With the shadow built in the bands land in RAM; only its flush streams to the panel */
+void oledC_RenderWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oledc_render_t render, void *context)
+{
+#if OLEDC_FRAMEBUFFER_BPP
+    uint8_t width, rows, y;
+    x0 = x0 > 95 ? 95 : x0;
+    y0 = y0 > 95 ? 95 : y0;
+    x1 = x1 > 95 ? 95 : x1;
+    y1 = y1 > 95 ? 95 : y1;
+    if(x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+    width = x1 - x0 + 1;
+    for(y = y0; y <= y1; y += rows)
+    {
+        rows = OLEDC_TILE_PIXELS / width;
+        rows = (rows > y1 - y + 1) ? y1 - y + 1 : rows;
+        render(tileBuffer[0], x0, y, width, rows, context);
+        oledC_fbWrite(x0, y, x1, y + rows - 1, tileBuffer[0], (uint16_t)width * rows);
+    }
+#else
+    oledC_RenderPanelWindow(x0, y0, x1, y1, render, context);
+#endif
+}
+
 bool oledC_open(void){
     return spi1_open();
 }
@@ -60,10 +60,30 @@ typedef enum OLEDC_CMDS
     OLEDC_CMD_SET_VCOMH_VOLTAGE = 0xBE,
     OLEDC_CMD_SET_CONTRAST_CURRENT = 0xC1,
     OLEDC_CMD_MASTER_CONTRAST_CURRENT_CONTROL = 0xC7,
+    OLEDC_CMD_HORIZONTAL_SCROLL = 0x96,
+    OLEDC_CMD_STOP_SCROLL = 0x9E,
+    OLEDC_CMD_START_SCROLL = 0x9F,
     OLEDC_CMD_SET_MUX_RATIO = 0xCA,
     OLEDC_CMD_SET_COMMAND_LOCK = 0xFD
 } OLEDC_COMMAND;
 
+typedef struct oledc_bus_stats_t
+{
+    uint32_t bytes;         // command and data bytes clocked out
+    uint32_t commands;
+    uint16_t transactions;  // SPI1 configurations, one per outermost transaction
+} oledc_bus_stats_t;
+
+/*
+ * Hold SPI1, nCS and DC across several commands and pixel streams.
+ * Transactions nest; only the outermost one opens and closes SPI1.
+ * Every oledC and oledC_shapes call runs inside one of its own.
+ */
+bool oledC_beginTransaction(void);
+void oledC_endTransaction(void);
+void oledC_getBusStats(oledc_bus_stats_t *stats);
+void oledC_resetBusStats(void);
+
 void oledC_sendCommand(OLEDC_COMMAND cmd, uint8_t *payload, uint8_t payload_size);
 
 void oledC_setRowAddressBounds(uint8_t min, uint8_t max);
@@ -77,9 +97,65 @@ uint16_t oledC_readColor(void);
 
 bool oledC_open(void);
 void oledC_setup(void);
+oledc_color_t oledC_parseIntToRGB(uint16_t raw);
+uint16_t oledC_parseRGBToInt(uint8_t red, uint8_t green, uint8_t blue);
 void oledC_sendColor(uint8_t r, uint8_t g, uint8_t b);
 void oledC_sendColorInt(uint16_t raw);
 void oledC_startWritingDisplay(void);
 void oledC_stopWritingDisplay(void);
 
+/*
+ * Set the window x0..x1, y0..y1 once and stream n pixels into it, row by row.
+ * With the shadow framebuffer built in they are drawn to RAM instead.
+ */
+void oledC_WriteWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n);
+void oledC_FillWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n);
+
+/*
+ * Stream a window produced band by band. render() fills rows y .. y+rows-1
+ * (width pixels each, row by row) while the band before it is still going
+ * out by DMA; two tile buffers of OLEDC_TILE_PIXELS take turns.
+ * oledC_RenderWindow draws into the shadow framebuffer when it is built in;
+ * oledC_RenderPanelWindow always streams to the panel.
+ */
+#define OLEDC_TILE_PIXELS 192
+
+typedef void (*oledc_render_t)(uint16_t *pixels, uint8_t x0, uint8_t y, uint8_t width, uint8_t rows, void *context);
+
+void oledC_RenderWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oledc_render_t render, void *context);
+void oledC_RenderPanelWindow(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, oledc_render_t render, void *context);
+
+/*
+ * Move the picture up by rows (down when negative) with one start line
+ * command instead of redrawing it. Coordinates keep meaning the panel as
+ * shown, so the rows that come in are drawn at the bottom (top) by
+ * render(), or cleared to black when it is NULL; that happens in RAM off
+ * the panel before the picture moves. At most OLEDC_SCROLL_MAX_ROWS rows
+ * per call. The compositor does not know the picture moved: call
+ * oledC_frameInvalidate() afterwards when it is in use.
+ */
+#define OLEDC_SCROLL_MAX_ROWS 32
+
+void oledC_scrollRows(int8_t rows, oledc_render_t render, void *context);
+
+/*
+ * Shift the whole picture by rows without moving what coordinates address,
+ * for short effects such as a nudge at the end of a list; 0 puts it back.
+ * The rows it uncovers show the RAM off the panel.
+ */
+void oledC_setDisplayOffset(int8_t rows);
+
+/*
+ * Let the controller rotate rows y0..y1 sideways by columns per step, at
+ * the pace interval picks (positive and negative run in opposite
+ * directions), until it is stopped; nothing goes over the bus meanwhile. Any pixel write stops
+ * it, and the rows stay where the scroll left them, so redraw them after.
+ */
+#define OLEDC_SCROLL_FAST    1
+#define OLEDC_SCROLL_SLOW    2
+#define OLEDC_SCROLL_SLOWEST 3
+
+void oledC_startHorizontalScroll(int8_t columns, uint8_t y0, uint8_t y1, uint8_t interval);
+void oledC_stopHorizontalScroll(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,563 @@
+/*
+ * File:   oledC_compositor.c
+ *
+ * Per-frame widget diffing, damage merging and repaint.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC.h"
+#include "oledC_shapes.h"
+#include "oledC_framebuffer.h"
+#include "oledC_segments.h"
+#include "oledC_compositor.h"
+
+#define PANEL_MAX       95
+#define FONT_WIDTH      5
+#define FONT_ROWS       9       // blank top row and eight font rows
+#define ICON_COLORS     4
+
+enum WIDGET_KIND
+{
+    WIDGET_NONE, WIDGET_TEXT, WIDGET_BOX, WIDGET_OUTLINE, WIDGET_ICON, WIDGET_DIGIT
+};
+
+typedef struct
+{
+    uint8_t x0, y0, x1, y1;     // inclusive
+} area_t;
+
+typedef struct
+{
+    area_t bounds;
+    uint8_t kind;
+    uint8_t scale;
+    bool opaque;                // paints every pixel of its bounds
+    uint16_t color;
+    uint16_t background;        // under opaque text and icons
+    union
+    {
+        char text[OLEDC_WIDGET_TEXT_MAX + 1];
+        const oledc_rle_image_t *icon;
+        struct
+        {
+            const oledc_segment_style_t *style;
+            uint8_t segments;
+        } digit;
+    } content;
+} widget_t;
+
+/* What the panel shows: enough to diff against, not to redraw */
+typedef struct
+{
+    area_t bounds;
+    uint8_t kind;
+    uint8_t segments;           // lit on the panel, for digits
+    uint16_t signature;
+} drawn_t;
+
+static widget_t widgets[OLEDC_FRAME_WIDGETS];
+static uint8_t widgetCount;
+static drawn_t drawn[OLEDC_FRAME_WIDGETS];
+static uint8_t drawnCount;
+static uint16_t background;
+static uint16_t drawnBackground;
+static bool invalid = true;
+
+static area_t damage[OLEDC_DAMAGE_RECTS];
+static uint8_t damageCount;
+
+static uint8_t clampEnd(uint16_t v)
+{
+    return v > PANEL_MAX ? PANEL_MAX : (uint8_t)v;
+}
+
+static bool overlaps(const area_t *a, const area_t *b)
+{
+    return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+/* Overlapping or edge to edge */
+static bool touches(const area_t *a, const area_t *b)
+{
+    return a->x0 <= b->x1 + 1 && b->x0 <= a->x1 + 1 && a->y0 <= b->y1 + 1 && b->y0 <= a->y1 + 1;
+}
+
+static bool contains(const area_t *a, const area_t *b)
+{
+    return a->x0 <= b->x0 && a->y0 <= b->y0 && a->x1 >= b->x1 && a->y1 >= b->y1;
+}
+
+static void unite(area_t *a, const area_t *b)
+{
+    a->x0 = b->x0 < a->x0 ? b->x0 : a->x0;
+    a->y0 = b->y0 < a->y0 ? b->y0 : a->y0;
+    a->x1 = b->x1 > a->x1 ? b->x1 : a->x1;
+    a->y1 = b->y1 > a->y1 ? b->y1 : a->y1;
+}
+
+static uint16_t unitedArea(const area_t *a, const area_t *b)
+{
+    area_t u = *a;
+    unite(&u, b);
+    return (uint16_t)(u.x1 - u.x0 + 1) * (u.y1 - u.y0 + 1);
+}
+
+static void dropDamage(uint8_t i)
+{
+    damage[i] = damage[--damageCount];
+}
+
+/* Fold touching rectangles together until none touch */
+static void mergeDamage(void)
+{
+    uint8_t i, j;
+
+    for(i = 0; i < damageCount; i++)
+    {
+        for(j = i + 1; j < damageCount; j++)
+        {
+            if(touches(&damage[i], &damage[j]))
+            {
+                unite(&damage[i], &damage[j]);
+                dropDamage(j);
+                j = i;
+            }
+        }
+    }
+}
+
+/* A full list takes the rectangle in whichever entry grows least */
+static void addDamage(const area_t *a)
+{
+    uint8_t i, best = 0;
+    uint16_t area, bestArea = 0xFFFF;
+
+    if(damageCount < OLEDC_DAMAGE_RECTS)
+    {
+        damage[damageCount++] = *a;
+    }
+    else
+    {
+        for(i = 0; i < damageCount; i++)
+        {
+            area = unitedArea(&damage[i], a);
+            if(area < bestArea)
+            {
+                bestArea = area;
+                best = i;
+            }
+        }
+        unite(&damage[best], a);
+    }
+    mergeDamage();
+}
+
+/* Grow every rectangle over the widgets it cuts, since widgets repaint whole */
+static void closeDamage(void)
+{
+    uint8_t i, w;
+    bool grown = true;
+
+    while(grown)
+    {
+        grown = false;
+        for(i = 0; i < damageCount; i++)
+        {
+            for(w = 0; w < widgetCount; w++)
+            {
+                if(widgets[w].kind != WIDGET_NONE && overlaps(&damage[i], &widgets[w].bounds)
+                   && !contains(&damage[i], &widgets[w].bounds))
+                {
+                    unite(&damage[i], &widgets[w].bounds);
+                    grown = true;
+                }
+            }
+        }
+        mergeDamage();
+    }
+}
+
+static uint16_t hashBytes(uint16_t h, const void *data, uint8_t n)
+{
+    const uint8_t *p = data;
+
+    while(n--)
+    {
+        h = (h ^ *p++) * 0x0193;
+    }
+    return h;
+}
+
+static uint16_t signature(const widget_t *w)
+{
+    uint16_t h = 0x811C;
+    uint8_t n = 0;
+
+    h = hashBytes(h, &w->bounds, sizeof(w->bounds));
+    h = hashBytes(h, &w->kind, 1);
+    h = hashBytes(h, &w->scale, 1);
+    h = hashBytes(h, &w->color, sizeof(w->color));
+    if(w->kind == WIDGET_TEXT)
+    {
+        while(w->content.text[n])
+        {
+            n++;
+        }
+        h = hashBytes(h, w->content.text, n);
+    }
+    else if(w->kind == WIDGET_ICON)
+    {
+        h = hashBytes(h, &w->content.icon, sizeof(w->content.icon));
+    }
+    else if(w->kind == WIDGET_DIGIT)
+    {
+        // Not the segments: a digit that only changed value is updated in place
+        h = hashBytes(h, w->content.digit.style, sizeof(*w->content.digit.style));
+    }
+    return h;
+}
+
+/* The next slot, or NULL once the frame is full */
+static widget_t *newWidget(uint8_t kind, uint8_t x0, uint8_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+{
+    widget_t *w;
+
+    if(widgetCount == OLEDC_FRAME_WIDGETS)
+    {
+        return NULL;
+    }
+    w = &widgets[widgetCount++];
+    w->kind = (x0 > PANEL_MAX || y0 > PANEL_MAX || x1 < x0 || y1 < y0) ? WIDGET_NONE : kind;
+    w->bounds.x0 = x0;
+    w->bounds.y0 = y0;
+    w->bounds.x1 = clampEnd(x1);
+    w->bounds.y1 = clampEnd(y1);
+    w->scale = 1;
+    w->color = color;
+    return w;
+}
+
+void oledC_frameBegin(uint16_t color)
+{
+    widgetCount = 0;
+    background = color;
+}
+
+void oledC_frameText(uint8_t x, uint8_t y, uint8_t scale, const char *text, uint16_t color)
+{
+    uint8_t n = 0;
+    widget_t *w;
+
+    scale = scale ? scale : 1;
+    while(text[n] && n < OLEDC_WIDGET_TEXT_MAX)
+    {
+        n++;
+    }
+    w = newWidget(WIDGET_TEXT, x, y,
+                  (uint16_t)x + n * (FONT_WIDTH * scale + 1) - 2,
+                  (uint16_t)y + FONT_ROWS * scale - 1, color);
+    if(w == NULL)
+    {
+        return;
+    }
+    if(n == 0)
+    {
+        w->kind = WIDGET_NONE;
+    }
+    w->scale = scale;
+    w->content.text[n] = '\0';
+    while(n--)
+    {
+        w->content.text[n] = text[n];
+    }
+}
+
+void oledC_frameBox(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color)
+{
+    newWidget(WIDGET_BOX, x0, y0, x1, y1, color);
+}
+
+void oledC_frameOutline(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t color)
+{
+    if(width && height)
+    {
+        newWidget(WIDGET_OUTLINE, x, y, (uint16_t)x + width - 1, (uint16_t)y + height - 1, color);
+    }
+    else
+    {
+        newWidget(WIDGET_NONE, x, y, x, y, color);
+    }
+}
+
+void oledC_frameIcon(uint8_t x, uint8_t y, const oledc_rle_image_t *image, uint16_t color)
+{
+    widget_t *w;
+
+    if(image == NULL || image->colorCount > ICON_COLORS)
+    {
+        newWidget(WIDGET_NONE, x, y, x, y, color);
+        return;
+    }
+    w = newWidget(WIDGET_ICON, x, y, (uint16_t)x + image->width - 1, (uint16_t)y + image->height - 1, color);
+    if(w != NULL)
+    {
+        w->content.icon = image;
+    }
+}
+
+void oledC_frameDigit(uint8_t x, uint8_t y, const oledc_segment_style_t *style, uint8_t digit, uint16_t color)
+{
+    widget_t *w;
+
+    if(style == NULL)
+    {
+        newWidget(WIDGET_NONE, x, y, x, y, color);
+        return;
+    }
+    w = newWidget(WIDGET_DIGIT, x, y, (uint16_t)x + style->width - 1, (uint16_t)y + style->height - 1, color);
+    if(w != NULL)
+    {
+        w->content.digit.style = style;
+        w->content.digit.segments = oledC_segmentMask(digit);
+    }
+}
+
+/*
+ * Text and icons are drawn opaque over the frame background, or over the
+ * box right under them when that box holds them whole; over anything else
+ * they stay transparent.
+ */
+static void resolveOpacity(uint8_t index)
+{
+    widget_t *t = &widgets[index];
+    uint8_t w;
+
+    t->opaque = (t->kind == WIDGET_BOX);
+    if(t->kind != WIDGET_TEXT && t->kind != WIDGET_ICON && t->kind != WIDGET_DIGIT)
+    {
+        return;
+    }
+    t->background = background;
+    t->opaque = (t->kind != WIDGET_DIGIT);     // unlit bars are left to the clear
+    for(w = index; w-- > 0;)
+    {
+        if(widgets[w].kind == WIDGET_NONE || !overlaps(&widgets[w].bounds, &t->bounds))
+        {
+            continue;
+        }
+        if(widgets[w].kind == WIDGET_BOX && contains(&widgets[w].bounds, &t->bounds))
+        {
+            t->background = widgets[w].color;
+        }
+        else
+        {
+            t->opaque = false;
+        }
+        return;
+    }
+}
+
+/* Colour 0 becomes the background the icon sits on, colour 1 the widget colour */
+static void drawIcon(const widget_t *w)
+{
+    const oledc_rle_image_t *image = w->content.icon;
+    uint16_t colors[ICON_COLORS];
+    uint8_t i;
+
+    for(i = 0; i < image->colorCount; i++)
+    {
+        colors[i] = image->colors[i];
+    }
+    colors[0] = w->background;
+    colors[1] = w->color;
+    if(w->opaque)
+    {
+        oledC_DrawRLE(w->bounds.x0, w->bounds.y0, 1, 1, image, colors);
+    }
+    else
+    {
+        oledC_DrawRLEMasked(w->bounds.x0, w->bounds.y0, 1, 1, image, colors);
+    }
+}
+
+static void drawWidget(const widget_t *w)
+{
+    const area_t *b = &w->bounds;
+
+    switch(w->kind)
+    {
+        case WIDGET_TEXT:
+            if(w->opaque)
+            {
+                oledC_DrawStringOpaque(b->x0, b->y0, w->scale, w->scale, (uint8_t *)w->content.text,
+                                       w->color, w->background);
+            }
+            else
+            {
+                oledC_DrawString(b->x0, b->y0, w->scale, w->scale, (uint8_t *)w->content.text, w->color);
+            }
+            break;
+        case WIDGET_BOX:
+            oledC_DrawRectangle(b->x0, b->y0, b->x1, b->y1, w->color);
+            break;
+        case WIDGET_OUTLINE:
+            oledC_DrawRectangle(b->x0, b->y0, b->x1, b->y0, w->color);
+            oledC_DrawRectangle(b->x0, b->y1, b->x1, b->y1, w->color);
+            oledC_DrawRectangle(b->x0, b->y0, b->x0, b->y1, w->color);
+            oledC_DrawRectangle(b->x1, b->y0, b->x1, b->y1, w->color);
+            break;
+        case WIDGET_ICON:
+            drawIcon(w);
+            break;
+        case WIDGET_DIGIT:
+            oledC_DrawSegments(b->x0, b->y0, w->content.digit.style, w->content.digit.segments,
+                               OLEDC_SEGMENTS_NONE, w->color, w->background);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * A digit whose value alone changed, with nothing over or under it but the
+ * background or boxes holding it whole, has its toggled bars filled where
+ * it stands instead of becoming damage.
+ */
+static bool updatesInPlace(uint8_t index)
+{
+    const widget_t *t = &widgets[index];
+    uint8_t w;
+
+    for(w = 0; w < widgetCount; w++)
+    {
+        if(w == index || widgets[w].kind == WIDGET_NONE || !overlaps(&widgets[w].bounds, &t->bounds))
+        {
+            continue;
+        }
+        if(w > index || widgets[w].kind != WIDGET_BOX || !contains(&widgets[w].bounds, &t->bounds))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t oledC_frameEnd(void)
+{
+    area_t whole = { 0, 0, PANEL_MAX, PANEL_MAX };
+    uint16_t sig[OLEDC_FRAME_WIDGETS];
+    bool inPlace[OLEDC_FRAME_WIDGETS];
+    uint8_t i, w, first, repainted, updates = 0;
+
+    damageCount = 0;
+    for(i = 0; i < widgetCount; i++)
+    {
+        sig[i] = signature(&widgets[i]);
+        inPlace[i] = false;
+        resolveOpacity(i);
+    }
+    if(invalid || background != drawnBackground)
+    {
+        addDamage(&whole);
+    }
+    else
+    {
+        for(i = 0; i < widgetCount || i < drawnCount; i++)
+        {
+            if(i < widgetCount && i < drawnCount && sig[i] == drawn[i].signature)
+            {
+                if(widgets[i].kind != WIDGET_DIGIT || widgets[i].content.digit.segments == drawn[i].segments)
+                {
+                    continue;
+                }
+                if(updatesInPlace(i))
+                {
+                    inPlace[i] = true;
+                    updates++;
+                    continue;
+                }
+            }
+            if(i < drawnCount && drawn[i].kind != WIDGET_NONE)
+            {
+                addDamage(&drawn[i].bounds);
+            }
+            if(i < widgetCount && widgets[i].kind != WIDGET_NONE)
+            {
+                addDamage(&widgets[i].bounds);
+            }
+        }
+    }
+    closeDamage();
+
+    /* Damage grown over a digit repaints it whole */
+    for(i = 0; i < widgetCount; i++)
+    {
+        for(w = 0; w < damageCount && inPlace[i]; w++)
+        {
+            if(overlaps(&damage[w], &widgets[i].bounds))
+            {
+                inPlace[i] = false;
+                updates--;
+            }
+        }
+    }
+
+    repainted = damageCount + updates;
+    if(repainted && oledC_beginTransaction())
+    {
+        for(i = 0; i < damageCount; i++)
+        {
+            /* The topmost opaque widget covering the rectangle replaces the clear */
+            for(first = widgetCount; first-- > 0;)
+            {
+                if(widgets[first].kind != WIDGET_NONE && widgets[first].opaque
+                   && contains(&widgets[first].bounds, &damage[i]))
+                {
+                    break;
+                }
+            }
+            if(first == 0xFF)
+            {
+                oledC_DrawRectangle(damage[i].x0, damage[i].y0, damage[i].x1, damage[i].y1, background);
+                first = 0;
+            }
+            for(w = first; w < widgetCount; w++)
+            {
+                if(widgets[w].kind != WIDGET_NONE && overlaps(&damage[i], &widgets[w].bounds))
+                {
+                    drawWidget(&widgets[w]);
+                }
+            }
+        }
+        for(i = 0; i < widgetCount; i++)
+        {
+            if(inPlace[i])
+            {
+                oledC_DrawSegments(widgets[i].bounds.x0, widgets[i].bounds.y0, widgets[i].content.digit.style,
+                                   widgets[i].content.digit.segments, drawn[i].segments,
+                                   widgets[i].color, widgets[i].background);
+            }
+        }
+        oledC_endTransaction();
+    }
+
+    for(i = 0; i < widgetCount; i++)
+    {
+        drawn[i].bounds = widgets[i].bounds;
+        drawn[i].kind = widgets[i].kind;
+        drawn[i].segments = widgets[i].kind == WIDGET_DIGIT ? widgets[i].content.digit.segments : 0;
+        drawn[i].signature = sig[i];
+    }
+    drawnCount = widgetCount;
+    drawnBackground = background;
+    invalid = false;
+    oledC_flush();
+    return repainted;
+}
+
+void oledC_frameInvalidate(void)
+{
+    invalid = true;
+}
@@ -0,0 +1,54 @@
+/*
+ * File:   oledC_compositor.h
+ *
+ * Damage-tracking compositor for widget-based screens.
+ *
+ * A screen declares its whole content every frame, between
+ * oledC_frameBegin() and oledC_frameEnd(), in the same order each time.
+ * Widget n of the frame is compared with widget n of the frame on the
+ * panel by bounds and a content signature. The old and new bounds of
+ * every changed widget become damage. Damaged rectangles are merged and
+ * grown to cover any widget they cut, then each one is cleared to the
+ * background and repainted with the widgets inside it, in one
+ * transaction per frame. Unchanged frames cost a few hashes and no bus
+ * traffic. A seven-segment digit that only changed value, with nothing
+ * but the background or a box under it, is not damage: just the bars
+ * that toggled are filled.
+ *
+ * A widget that is only sometimes shown keeps its slot: declare it with
+ * an empty text or a NULL icon. Code that draws on the panel directly
+ * calls oledC_frameInvalidate() so the next frame repaints everything.
+ */
+
+#ifndef OLEDC_COMPOSITOR_H
+#define	OLEDC_COMPOSITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC_shapes.h"
+#include "oledC_segments.h"
+
+#define OLEDC_FRAME_WIDGETS     16
+#define OLEDC_WIDGET_TEXT_MAX   16
+#define OLEDC_DAMAGE_RECTS      6
+
+void oledC_frameBegin(uint16_t background);
+
+/* Text in the 5x8 font; the widget covers the full character cells */
+void oledC_frameText(uint8_t x, uint8_t y, uint8_t scale, const char *text, uint16_t color);
+/* Filled rectangle, corners inclusive */
+void oledC_frameBox(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color);
+/* One-pixel outline of a width x height rectangle */
+void oledC_frameOutline(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint16_t color);
+/* RLE image; color replaces its colour 1, colour 0 is left to what is under it */
+void oledC_frameIcon(uint8_t x, uint8_t y, const oledc_rle_image_t *image, uint16_t color);
+/* Seven-segment digit 0-9 in a style->width x style->height cell; others blank */
+void oledC_frameDigit(uint8_t x, uint8_t y, const oledc_segment_style_t *style, uint8_t digit, uint16_t color);
+
+/* Repaint the damage and flush; returns the rectangles repainted plus digits updated */
+uint8_t oledC_frameEnd(void);
+
+/* Forget what is on the panel; the next frame repaints it whole */
+void oledC_frameInvalidate(void);
+
+#endif	/* OLEDC_COMPOSITOR_H */
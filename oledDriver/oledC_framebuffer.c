@@ -0,0 +1,319 @@
+/*
+ * File:   oledC_framebuffer.c
+ *
+ * Palette-indexed shadow framebuffer with dirty-tile flushing.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "oledC.h"
+#include "oledC_framebuffer.h"
+
+#if OLEDC_FRAMEBUFFER_BPP
+
+#define BPP             OLEDC_FRAMEBUFFER_BPP
+#define PANEL           96
+#define PIXELS_PER_BYTE (8 / BPP)
+#define ROW_BYTES       (PANEL / PIXELS_PER_BYTE)
+#define INDEX_MASK      ((1 << BPP) - 1)
+#define PALETTE_SIZE    (1 << BPP)
+#define TILES           (PANEL / OLEDC_FB_TILE)
+#define ALL_TILES       ((1U << TILES) - 1)
+
+typedef char oledcFramebufferDepthCheck[(BPP == 2 || BPP == 4) ? 1 : -1];
+
+/* Pixel x of a row sits in byte x / PIXELS_PER_BYTE, lowest bits first */
+static uint8_t frame[PANEL * ROW_BYTES];
+
+/* One bit per tile column, one word per tile row; the panel starts unknown */
+static uint16_t dirty[TILES] = {
+    ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES,
+    ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES, ALL_TILES
+};
+
+/* Entry 0 is black, matching the cleared shadow */
+static uint16_t palette[PALETTE_SIZE];
+static uint8_t paletteUsed = 1;
+
+static uint16_t lastColor;
+static uint8_t lastIndex;
+
+static uint8_t channelDistance(uint8_t a, uint8_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+static uint8_t colorIndex(uint16_t color)
+{
+    uint8_t i, best = 0;
+    uint8_t distance, bestDistance = 0xFF;
+    oledc_color_t want, have;
+
+    if(color == lastColor)
+    {
+        return lastIndex;
+    }
+    for(i = 0; i < paletteUsed; i++)
+    {
+        if(palette[i] == color)
+        {
+            break;
+        }
+    }
+    if(i == paletteUsed && paletteUsed < PALETTE_SIZE)
+    {
+        palette[paletteUsed++] = color;
+    }
+    else if(i == paletteUsed)
+    {
+        /* Full: nearest entry, green halved to the 5-bit scale of red and blue */
+        want = oledC_parseIntToRGB(color);
+        for(i = 0; i < PALETTE_SIZE; i++)
+        {
+            have = oledC_parseIntToRGB(palette[i]);
+            distance = channelDistance(want.red, have.red)
+                     + (channelDistance(want.green, have.green) >> 1)
+                     + channelDistance(want.blue, have.blue);
+            if(distance < bestDistance)
+            {
+                bestDistance = distance;
+                best = i;
+            }
+        }
+        i = best;
+    }
+    lastColor = color;
+    lastIndex = i;
+    return i;
+}
+
+static uint8_t getIndex(uint8_t x, uint8_t y)
+{
+    return (frame[(uint16_t)y * ROW_BYTES + x / PIXELS_PER_BYTE] >> ((x % PIXELS_PER_BYTE) * BPP)) & INDEX_MASK;
+}
+
+static bool setIndex(uint8_t x, uint8_t y, uint8_t index)
+{
+    uint8_t *b = &frame[(uint16_t)y * ROW_BYTES + x / PIXELS_PER_BYTE];
+    uint8_t shift = (x % PIXELS_PER_BYTE) * BPP;
+    uint8_t v = (*b & ~(INDEX_MASK << shift)) | (index << shift);
+
+    if(v == *b)
+    {
+        return false;
+    }
+    *b = v;
+    return true;
+}
+
+static void markDirty(uint8_t x0, uint8_t x1, uint8_t y)
+{
+    dirty[y / OLEDC_FB_TILE] |= (2U << (x1 / OLEDC_FB_TILE)) - (1U << (x0 / OLEDC_FB_TILE));
+}
+
+/* Ragged ends pixel by pixel, whole bytes in between */
+static void fillSpan(uint8_t x0, uint8_t x1, uint8_t y, uint8_t index)
+{
+    uint8_t pattern = (0xFF / INDEX_MASK) * index;
+    uint8_t *b;
+    bool changed = false;
+    uint8_t x = x0;
+
+    while(x <= x1 && x % PIXELS_PER_BYTE)
+    {
+        changed |= setIndex(x++, y, index);
+    }
+    b = &frame[(uint16_t)y * ROW_BYTES + x / PIXELS_PER_BYTE];
+    while(x + PIXELS_PER_BYTE - 1 <= x1)
+    {
+        if(*b != pattern)
+        {
+            *b = pattern;
+            changed = true;
+        }
+        b++;
+        x += PIXELS_PER_BYTE;
+    }
+    while(x <= x1)
+    {
+        changed |= setIndex(x++, y, index);
+    }
+    if(changed)
+    {
+        markDirty(x0, x1, y);
+    }
+}
+
+/* Same clamping as the panel window; false if nothing is left */
+static bool clampWindow(uint8_t *x0, uint8_t *y0, uint8_t *x1, uint8_t *y1)
+{
+    *x0 = *x0 > 95 ? 95 : *x0;
+    *y0 = *y0 > 95 ? 95 : *y0;
+    *x1 = *x1 > 95 ? 95 : *x1;
+    *y1 = *y1 > 95 ? 95 : *y1;
+    return *x0 <= *x1 && *y0 <= *y1;
+}
+
+/* The first n pixels of the window, row by row, as the panel would take them */
+void oledC_fbFill(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n)
+{
+    uint8_t index, y, width, span;
+
+    if(!clampWindow(&x0, &y0, &x1, &y1))
+    {
+        return;
+    }
+    index = colorIndex(color);
+    width = x1 - x0 + 1;
+    for(y = y0; y <= y1 && n; y++)
+    {
+        span = (n < width) ? (uint8_t)n : width;
+        fillSpan(x0, x0 + span - 1, y, index);
+        n -= span;
+    }
+}
+
+void oledC_fbWrite(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n)
+{
+    uint8_t x, y;
+    bool changed;
+
+    if(!clampWindow(&x0, &y0, &x1, &y1))
+    {
+        return;
+    }
+    for(y = y0; y <= y1 && n; y++)
+    {
+        changed = false;
+        for(x = x0; x <= x1 && n; x++, n--)
+        {
+            changed |= setIndex(x, y, colorIndex(*pixels++));
+        }
+        if(changed)
+        {
+            markDirty(x0, x - 1, y);
+        }
+    }
+}
+
+uint16_t oledC_fbReadPoint(uint8_t x, uint8_t y)
+{
+    if(x > 95 || y > 95)
+    {
+        return 0;
+    }
+    return palette[getIndex(x, y)];
+}
+
+/* The panel moved, not the content: shift the rows to match what is shown */
+void oledC_fbScroll(int8_t rows)
+{
+    uint8_t count = rows < 0 ? -rows : rows;
+    uint8_t y0 = rows < 0 ? 0 : PANEL - count;
+    uint8_t row;
+
+    if(count == 0 || count >= PANEL)
+    {
+        return;
+    }
+    if(rows > 0)
+    {
+        memmove(frame, frame + count * ROW_BYTES, (PANEL - count) * ROW_BYTES);
+    }
+    else
+    {
+        memmove(frame + count * ROW_BYTES, frame, (PANEL - count) * ROW_BYTES);
+    }
+    memset(frame + y0 * ROW_BYTES, 0, count * ROW_BYTES);
+    for(row = y0 / OLEDC_FB_TILE; row <= (y0 + count - 1) / OLEDC_FB_TILE; row++)
+    {
+        dirty[row] = ALL_TILES;
+    }
+}
+
+static void expandIndices(uint16_t *pixels, uint8_t x0, uint8_t y, uint8_t width, uint8_t rows, void *context)
+{
+    uint8_t x;
+
+    while(rows--)
+    {
+        for(x = x0; x < x0 + width; x++)
+        {
+            *pixels++ = palette[getIndex(x, y)];
+        }
+        y++;
+    }
+}
+
+/* Each run of dirty tiles in a tile row goes out as one window */
+void oledC_flush(void)
+{
+    uint8_t row, first, last;
+    uint16_t bits;
+
+    for(row = 0; row < TILES && !dirty[row]; row++)
+    {
+    }
+    if(row == TILES || !oledC_beginTransaction())
+    {
+        return;
+    }
+    for(; row < TILES; row++)
+    {
+        bits = dirty[row];
+        first = 0;
+        while(bits)
+        {
+            while(!(bits & (1U << first)))
+            {
+                first++;
+            }
+            for(last = first; last + 1 < TILES && (bits & (2U << last)); last++)
+            {
+            }
+            oledC_RenderPanelWindow(first * OLEDC_FB_TILE, row * OLEDC_FB_TILE,
+                                    last * OLEDC_FB_TILE + OLEDC_FB_TILE - 1,
+                                    row * OLEDC_FB_TILE + OLEDC_FB_TILE - 1,
+                                    expandIndices, NULL);
+            bits &= ~((2U << last) - (1U << first));
+            first = last + 1;
+        }
+        dirty[row] = 0;
+    }
+    oledC_endTransaction();
+}
+
+void oledC_setPaletteColor(uint8_t index, uint16_t color)
+{
+    uint8_t row;
+
+    if(index >= PALETTE_SIZE || (index < paletteUsed && palette[index] == color))
+    {
+        return;
+    }
+    palette[index] = color;
+    if(index >= paletteUsed)
+    {
+        paletteUsed = index + 1;
+    }
+    lastColor = palette[0];
+    lastIndex = 0;
+    for(row = 0; row < TILES; row++)
+    {
+        dirty[row] = ALL_TILES;
+    }
+}
+
+#else
+
+void oledC_flush(void)
+{
+}
+
+void oledC_setPaletteColor(uint8_t index, uint16_t color)
+{
+}
+
+#endif
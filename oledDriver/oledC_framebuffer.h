@@ -0,0 +1,50 @@
+/*
+ * File:   oledC_framebuffer.h
+ *
+ * Optional palette-indexed shadow of the 96x96 panel.
+ *
+ * Built with OLEDC_FRAMEBUFFER_BPP set to 2 (4 colours, 2304 bytes) or
+ * 4 (16 colours, 4608 bytes), oledC_FillWindow / oledC_WriteWindow and
+ * everything drawn through them land in RAM instead of on the bus. The
+ * panel is split into 8x8 tiles; a tile is marked dirty only when a pixel
+ * in it actually changes. oledC_flush() sends the dirty tiles, expanding
+ * palette indices to RGB565 band by band into the SPI stream, so overdraw
+ * such as "clear rect, then draw text" costs nothing on the bus.
+ *
+ * Colours are mapped to palette entries on first use; once the palette is
+ * full the nearest entry is used. Pin the entries up front with
+ * oledC_setPaletteColor() when a screen needs more than the depth gives.
+ * With everything else in RAM, 2bpp is the depth that leaves room for the
+ * stack on the 16 KB part.
+ *
+ * Raw RAM streams (oledC_sendColorInt, oledC_RenderPanelWindow) still go
+ * straight to the panel and are not seen by the shadow.
+ */
+
+#ifndef OLEDC_FRAMEBUFFER_H
+#define	OLEDC_FRAMEBUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef OLEDC_FRAMEBUFFER_BPP
+#define OLEDC_FRAMEBUFFER_BPP 0     // 0: draw straight to the panel
+#endif
+
+#define OLEDC_FB_TILE 8
+
+/* Send the dirty tiles; a no-op when the shadow is not built in */
+void oledC_flush(void);
+
+/* Set a palette entry; tiles already using it are redrawn on the next flush */
+void oledC_setPaletteColor(uint8_t index, uint16_t color);
+
+/* Used by oledC in place of its panel writes */
+void oledC_fbFill(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n);
+void oledC_fbWrite(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n);
+uint16_t oledC_fbReadPoint(uint8_t x, uint8_t y);
+
+/* Follow oledC_scrollRows() after a flush: the rows that came in are cleared and dirty */
+void oledC_fbScroll(int8_t rows);
+
+#endif	/* OLEDC_FRAMEBUFFER_H */
@@ -0,0 +1,107 @@
+/*
+ * File:   oledC_renderTask.c
+ *
+ * Frame pacing, change coalescing and frame statistics.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC_framebuffer.h"
+#include "oledC_compositor.h"
+#include "oledC_renderTask.h"
+
+static oledc_clock_t millisClock;
+static oledc_compose_t screen;
+static uint16_t interval = OLEDC_RENDER_DEFAULT_MS;
+static uint32_t frameStart;     // start of the current frame slot
+static uint16_t posted;
+static oledc_render_stats_t renderStats;
+
+void oledC_renderInit(oledc_clock_t millis, uint16_t frameMs)
+{
+    millisClock = millis;
+    oledC_renderSetFrameInterval(frameMs);
+    frameStart = millisClock() - interval;    // first frame is due at once
+    posted = 0;
+    oledC_resetRenderStats();
+}
+
+void oledC_renderSetFrameInterval(uint16_t frameMs)
+{
+    interval = frameMs ? frameMs : 1;
+}
+
+void oledC_renderSetScreen(oledc_compose_t compose)
+{
+    screen = compose;
+    posted = OLEDC_RENDER_ALL;
+}
+
+void oledC_renderPost(uint16_t changes)
+{
+    posted |= changes;
+}
+
+void oledC_renderInvalidate(void)
+{
+    oledC_frameInvalidate();
+    posted = OLEDC_RENDER_ALL;
+}
+
+bool oledC_renderService(void)
+{
+    uint32_t now, elapsed, took;
+    uint16_t changes;
+
+    if(millisClock == NULL || screen == NULL)
+    {
+        return false;
+    }
+    now = millisClock();
+    elapsed = now - frameStart;
+    if(elapsed < interval)
+    {
+        return false;
+    }
+    // Slots missed while the caller was busy are skipped, not caught up
+    renderStats.skipped += elapsed / interval - 1;
+    frameStart = now - elapsed % interval;
+    if(posted == 0)
+    {
+        renderStats.skipped++;
+        return false;
+    }
+
+    changes = posted;
+    posted = 0;
+    screen(changes);
+    oledC_flush();
+
+    took = millisClock() - now;
+    renderStats.frames++;
+    renderStats.lastMs = took > 0xFFFF ? 0xFFFF : (uint16_t)took;
+    if(renderStats.lastMs > renderStats.maxMs)
+    {
+        renderStats.maxMs = renderStats.lastMs;
+    }
+    if(took > interval)
+    {
+        renderStats.overBudget++;
+    }
+    return true;
+}
+
+void oledC_getRenderStats(oledc_render_stats_t *stats)
+{
+    *stats = renderStats;
+}
+
+void oledC_resetRenderStats(void)
+{
+    renderStats.frames = 0;
+    renderStats.skipped = 0;
+    renderStats.overBudget = 0;
+    renderStats.lastMs = 0;
+    renderStats.maxMs = 0;
+}
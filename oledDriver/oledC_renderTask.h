@@ -0,0 +1,58 @@
+/*
+ * File:   oledC_renderTask.h
+ *
+ * Frame-paced rendering for the screen that owns the display.
+ *
+ * The screen registers a compose callback with oledC_renderSetScreen().
+ * Producers (timers, sensors, buttons) do not draw; they post what changed
+ * with oledC_renderPost(). oledC_renderService(), called from every loop
+ * that can hold the display, runs the callback at most once per frame
+ * interval with all the changes posted since the last frame, then flushes.
+ * A frame with nothing posted is skipped without calling the screen or
+ * touching the bus.
+ *
+ * Change bits are the application's; OLEDC_RENDER_ALL is posted when a
+ * screen is entered or invalidated and asks for a whole repaint.
+ */
+
+#ifndef OLEDC_RENDERTASK_H
+#define	OLEDC_RENDERTASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define OLEDC_RENDER_ALL            0xFFFF
+#define OLEDC_RENDER_DEFAULT_MS     50      // 20 frames per second
+
+typedef void (*oledc_compose_t)(uint16_t changes);
+typedef uint32_t (*oledc_clock_t)(void);
+
+typedef struct oledc_render_stats_t
+{
+    uint32_t frames;        // composed and flushed
+    uint32_t skipped;       // frame slots that passed without a frame
+    uint32_t overBudget;    // frames that took longer than the interval
+    uint16_t lastMs;        // compose and flush time of the last frame
+    uint16_t maxMs;
+} oledc_render_stats_t;
+
+/* millis is the free-running millisecond clock frames are paced by */
+void oledC_renderInit(oledc_clock_t millis, uint16_t frameMs);
+void oledC_renderSetFrameInterval(uint16_t frameMs);
+
+/* Hand the display to another screen; its first frame repaints it whole */
+void oledC_renderSetScreen(oledc_compose_t compose);
+
+/* Coalesced until the next frame */
+void oledC_renderPost(uint16_t changes);
+
+/* After drawing outside the compositor: forget the panel and repaint it whole */
+void oledC_renderInvalidate(void);
+
+/* Run a frame if one is due and something was posted; returns whether it did */
+bool oledC_renderService(void);
+
+void oledC_getRenderStats(oledc_render_stats_t *stats);
+void oledC_resetRenderStats(void);
+
+#endif	/* OLEDC_RENDERTASK_H */
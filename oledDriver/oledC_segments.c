@@ -0,0 +1,84 @@
+/*
+ * File:   oledC_segments.c
+ *
+ * Seven-segment bar geometry and toggled-segment fills.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC.h"
+#include "oledC_shapes.h"
+#include "oledC_segments.h"
+
+#define SEGMENT_COUNT   7
+
+static const uint8_t digitMasks[10] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+};
+
+uint8_t oledC_segmentMask(uint8_t digit)
+{
+    return digit < 10 ? digitMasks[digit] : OLEDC_SEGMENTS_NONE;
+}
+
+/* Corners inclusive; the corner squares belong to no bar */
+static void segmentBounds(uint8_t segment, const oledc_segment_style_t *s,
+                          uint8_t *x0, uint8_t *y0, uint8_t *x1, uint8_t *y1)
+{
+    uint8_t t = s->thickness;
+    uint8_t right = s->width - t;
+    uint8_t middle = (s->height - t) / 2;
+    uint8_t bottom = s->height - t;
+
+    switch(segment)
+    {
+        case 0:     // a
+            *x0 = t;        *y0 = 0;            *x1 = right - 1;    *y1 = t - 1;
+            break;
+        case 1:     // b
+            *x0 = right;    *y0 = t;            *x1 = s->width - 1; *y1 = middle - 1;
+            break;
+        case 2:     // c
+            *x0 = right;    *y0 = middle + t;   *x1 = s->width - 1; *y1 = bottom - 1;
+            break;
+        case 3:     // d
+            *x0 = t;        *y0 = bottom;       *x1 = right - 1;    *y1 = s->height - 1;
+            break;
+        case 4:     // e
+            *x0 = 0;        *y0 = middle + t;   *x1 = t - 1;        *y1 = bottom - 1;
+            break;
+        case 5:     // f
+            *x0 = 0;        *y0 = t;            *x1 = t - 1;        *y1 = middle - 1;
+            break;
+        default:    // g
+            *x0 = t;        *y0 = middle;       *x1 = right - 1;    *y1 = middle + t - 1;
+            break;
+    }
+}
+
+void oledC_DrawSegments(uint8_t x, uint8_t y, const oledc_segment_style_t *style,
+                        uint8_t mask, uint8_t shown, uint16_t color, uint16_t background)
+{
+    uint8_t segment, x0, y0, x1, y1;
+    uint8_t toggled = (mask ^ shown) & 0x7F;
+
+    if(toggled == 0 || style->thickness == 0 || style->width < 2 * style->thickness + 1
+       || style->height < 3 * style->thickness + 2)
+    {
+        return;
+    }
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
+    for(segment = 0; segment < SEGMENT_COUNT; segment++)
+    {
+        if(toggled & (1 << segment))
+        {
+            segmentBounds(segment, style, &x0, &y0, &x1, &y1);
+            oledC_DrawRectangle(x + x0, y + y0, x + x1, y + y1,
+                                (mask & (1 << segment)) ? color : background);
+        }
+    }
+    oledC_endTransaction();
+}
@@ -0,0 +1,46 @@
+/*
+ * File:   oledC_segments.h
+ *
+ * Seven-segment digits drawn as filled rectangles.
+ *
+ * A digit is up to seven bars, each one window fill, inside a width x
+ * height cell. Horizontal and vertical bars meet at notched corners and
+ * never overlap, so a single bar can be lit or cleared without touching
+ * its neighbours: oledC_DrawSegments() is given the segments the panel
+ * shows and fills only the ones that differ, in the lit colour or the
+ * background. Going from 8 to 9 is one bar; the worst case is five.
+ *
+ * The cell needs a width of at least 2 * thickness + 1 and a height of
+ * at least 3 * thickness + 2; a smaller one draws nothing.
+ */
+
+#ifndef OLEDC_SEGMENTS_H
+#define	OLEDC_SEGMENTS_H
+
+#include <stdint.h>
+
+/* Segment bits, a (top) clockwise to f, then g (middle) */
+#define OLEDC_SEGMENT_A     0x01
+#define OLEDC_SEGMENT_B     0x02
+#define OLEDC_SEGMENT_C     0x04
+#define OLEDC_SEGMENT_D     0x08
+#define OLEDC_SEGMENT_E     0x10
+#define OLEDC_SEGMENT_F     0x20
+#define OLEDC_SEGMENT_G     0x40
+#define OLEDC_SEGMENTS_NONE 0x00
+
+typedef struct oledc_segment_style_t
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t thickness;      // stroke of every bar
+} oledc_segment_style_t;
+
+/* Segments lit for 0-9; anything else is blank */
+uint8_t oledC_segmentMask(uint8_t digit);
+
+/* Fill the segments of mask that shown lacks and clear those it has extra */
+void oledC_DrawSegments(uint8_t x, uint8_t y, const oledc_segment_style_t *style,
+                        uint8_t mask, uint8_t shown, uint16_t color, uint16_t background);
+
+#endif	/* OLEDC_SEGMENTS_H */
@@ -0,0 +1,213 @@
+/*
+ * File:   oledC_shadow.c
+ *
+ * Shadowed regions: pool allocation, write-through and lazy loading.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC.h"
+#include "oledC_framebuffer.h"
+#include "oledC_shadow.h"
+
+#define PANEL_MAX   95
+
+static oledc_read_stats_t readStats;
+
+#if OLEDC_SHADOW_PIXELS && !OLEDC_FRAMEBUFFER_BPP
+typedef struct
+{
+    uint8_t x0, y0, x1, y1;     // inclusive
+    uint16_t offset;            // first pixel in the pool, row by row
+    bool loaded;
+} region_t;
+
+static region_t regions[OLEDC_SHADOW_REGIONS];
+static uint8_t regionCount;
+static uint16_t poolUsed;
+static uint16_t pool[OLEDC_SHADOW_PIXELS];
+
+/* One window and read stream per row, so rows that wrap in RAM read right */
+static void loadRegion(region_t *r)
+{
+    uint16_t *dst = &pool[r->offset];
+    uint8_t x, y;
+
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
+    for(y = r->y0; y <= r->y1; y++)
+    {
+        oledC_setColumnAddressBounds(r->x0, r->x1);
+        oledC_setRowAddressBounds(y, y);
+        for(x = r->x0; x <= r->x1; x++)
+        {
+            *dst++ = oledC_readColor();
+        }
+        readStats.misses += r->x1 - r->x0 + 1;
+    }
+    oledC_stopReadingDisplay();
+    oledC_endTransaction();
+    r->loaded = true;
+}
+
+/* The first n pixels of the window, row by row, from pixels or all color */
+static void writeThrough(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
+                         const uint16_t *pixels, uint16_t color, uint16_t n)
+{
+    uint8_t i, x, y, cx0, cy0, cx1, cy1, width;
+    uint16_t index, *dst;
+    region_t *r;
+
+    x0 = x0 > PANEL_MAX ? PANEL_MAX : x0;
+    y0 = y0 > PANEL_MAX ? PANEL_MAX : y0;
+    x1 = x1 > PANEL_MAX ? PANEL_MAX : x1;
+    y1 = y1 > PANEL_MAX ? PANEL_MAX : y1;
+    if(x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+    width = x1 - x0 + 1;
+    for(i = 0; i < regionCount; i++)
+    {
+        r = &regions[i];
+        cx0 = x0 > r->x0 ? x0 : r->x0;
+        cy0 = y0 > r->y0 ? y0 : r->y0;
+        cx1 = x1 < r->x1 ? x1 : r->x1;
+        cy1 = y1 < r->y1 ? y1 : r->y1;
+        if(!r->loaded || cx0 > cx1 || cy0 > cy1)
+        {
+            continue;
+        }
+        for(y = cy0; y <= cy1; y++)
+        {
+            index = (uint16_t)(y - y0) * width + (cx0 - x0);
+            if(index >= n)
+            {
+                break;
+            }
+            dst = &pool[r->offset + (uint16_t)(y - r->y0) * (r->x1 - r->x0 + 1) + (cx0 - r->x0)];
+            for(x = cx0; x <= cx1 && index < n; x++, index++)
+            {
+                *dst++ = pixels ? pixels[index] : color;
+            }
+        }
+    }
+}
+#endif
+
+bool oledC_shadowRegion(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+#if OLEDC_FRAMEBUFFER_BPP
+    return true;
+#elif OLEDC_SHADOW_PIXELS
+    uint16_t size;
+    region_t *r;
+
+    x1 = x1 > PANEL_MAX ? PANEL_MAX : x1;
+    y1 = y1 > PANEL_MAX ? PANEL_MAX : y1;
+    if(x0 > x1 || y0 > y1 || regionCount == OLEDC_SHADOW_REGIONS)
+    {
+        return false;
+    }
+    size = (uint16_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+    if(size > OLEDC_SHADOW_PIXELS - poolUsed)
+    {
+        return false;
+    }
+    r = &regions[regionCount++];
+    r->x0 = x0;
+    r->y0 = y0;
+    r->x1 = x1;
+    r->y1 = y1;
+    r->offset = poolUsed;
+    r->loaded = false;
+    poolUsed += size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void oledC_shadowClear(void)
+{
+#if OLEDC_SHADOW_PIXELS && !OLEDC_FRAMEBUFFER_BPP
+    regionCount = 0;
+    poolUsed = 0;
+#endif
+}
+
+void oledC_getReadStats(oledc_read_stats_t *stats)
+{
+    *stats = readStats;
+}
+
+void oledC_resetReadStats(void)
+{
+    readStats.hits = 0;
+    readStats.misses = 0;
+}
+
+void oledC_shadowFill(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n)
+{
+#if OLEDC_SHADOW_PIXELS && !OLEDC_FRAMEBUFFER_BPP
+    writeThrough(x0, y0, x1, y1, NULL, color, n);
+#endif
+}
+
+void oledC_shadowWrite(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n)
+{
+#if OLEDC_SHADOW_PIXELS && !OLEDC_FRAMEBUFFER_BPP
+    writeThrough(x0, y0, x1, y1, pixels, 0, n);
+#endif
+}
+
+/* A miss leaves the panel read to the caller */
+bool oledC_shadowRead(uint8_t x, uint8_t y, uint16_t *color)
+{
+#if OLEDC_FRAMEBUFFER_BPP
+    *color = oledC_fbReadPoint(x, y);
+    readStats.hits++;
+    return true;
+#else
+#if OLEDC_SHADOW_PIXELS
+    uint8_t i;
+    region_t *r;
+
+    for(i = 0; i < regionCount; i++)
+    {
+        r = &regions[i];
+        if(x < r->x0 || x > r->x1 || y < r->y0 || y > r->y1)
+        {
+            continue;
+        }
+        if(!r->loaded)
+        {
+            loadRegion(r);
+        }
+        if(!r->loaded)
+        {
+            break;
+        }
+        *color = pool[r->offset + (uint16_t)(y - r->y0) * (r->x1 - r->x0 + 1) + (x - r->x0)];
+        readStats.hits++;
+        return true;
+    }
+#endif
+    readStats.misses++;
+    return false;
+#endif
+}
+
+void oledC_shadowStale(void)
+{
+#if OLEDC_SHADOW_PIXELS && !OLEDC_FRAMEBUFFER_BPP
+    uint8_t i;
+    for(i = 0; i < regionCount; i++)
+    {
+        regions[i].loaded = false;
+    }
+#endif
+}
@@ -0,0 +1,56 @@
+/*
+ * File:   oledC_shadow.h
+ *
+ * RAM copies of selected panel regions, for pixel read-back.
+ *
+ * Reading a pixel from the panel re-addresses it and turns the bus around.
+ * A region registered with oledC_shadowRegion() keeps an RGB565 copy that
+ * oledC_FillWindow, oledC_WriteWindow and the rendered windows update as
+ * they write, so oledC_ReadPoint() inside it sends nothing. XOR cursors and
+ * inverted bars over such a region (oledC_XorRectangle) are then
+ * read-modify-write in RAM.
+ *
+ * A region is read from the panel the first time a pixel of it is asked
+ * for, and again after a scroll has moved the picture under it. Reads
+ * outside every region still go to the panel; oledC_getReadStats() counts
+ * both kinds. Raw RAM streams (oledC_sendColorInt) are not seen.
+ *
+ * Built with OLEDC_SHADOW_PIXELS set to the pool size; a menu row of
+ * 96x15 takes 1440 pixels, 2880 bytes. With the framebuffer built in,
+ * every read is already served from RAM and no region is needed.
+ */
+
+#ifndef OLEDC_SHADOW_H
+#define	OLEDC_SHADOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef OLEDC_SHADOW_PIXELS
+#define OLEDC_SHADOW_PIXELS 0       // 0: every read goes to the panel
+#endif
+
+#define OLEDC_SHADOW_REGIONS 4
+
+typedef struct oledc_read_stats_t
+{
+    uint32_t hits;          // pixels read from RAM
+    uint32_t misses;        // pixels read from the panel, loads included
+} oledc_read_stats_t;
+
+/* Corners inclusive; false when the pool or the region table is full */
+bool oledC_shadowRegion(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+/* Drop every region and give the pool back */
+void oledC_shadowClear(void);
+
+void oledC_getReadStats(oledc_read_stats_t *stats);
+void oledC_resetReadStats(void);
+
+/* Used by oledC and oledC_ReadPoint */
+void oledC_shadowFill(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint16_t color, uint16_t n);
+void oledC_shadowWrite(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, const uint16_t *pixels, uint16_t n);
+bool oledC_shadowRead(uint8_t x, uint8_t y, uint16_t *color);
+/* The picture moved under the regions; they are read again when next needed */
+void oledC_shadowStale(void);
+
+#endif	/* OLEDC_SHADOW_H */
@@ -22,10 +22,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "oledC.h"
 #include "oledC_shapeHandler.h"
 #include "oledC_shapes.h"
 
 #define MAX_NUMBER_OF_SHAPES 32
+#define MAX_DIRTY_BOXES 8
+#define NO_SLOT 0xFF
 
 static void dummyshape(shape_t *shape)
 {
@@ -33,49 +37,397 @@ static void dummyshape(shape_t *shape)
 
 static shape_t allParsedShapes[MAX_NUMBER_OF_SHAPES];
 
+/*
+ * Slots in use are linked bottom to top through above[] and back through
+ * below[]; free slots are chained through above[] from freeSlot. Slots past
+ * unusedSlot have never been handed out.
+ */
+static uint8_t above[MAX_NUMBER_OF_SHAPES];
+static uint8_t below[MAX_NUMBER_OF_SHAPES];
+static uint8_t generation[MAX_NUMBER_OF_SHAPES];
+static uint32_t liveSlots;
+static uint8_t bottomSlot = NO_SLOT;
+static uint8_t topSlot = NO_SLOT;
+static uint8_t freeSlot = NO_SLOT;
+static uint8_t unusedSlot;
+
+/* Handed out for indices with no shape */
+static shape_t blankShape;
+
+/* Areas to clear before the repaint; past MAX_DIRTY_BOXES the last one grows */
+static oledc_box_t dirtyBoxes[MAX_DIRTY_BOXES];
+static uint8_t dirtyCount;
+static uint16_t background;
+
+/* One bit per slot: shapes to draw without clearing under them first */
+static uint32_t pendingShapes;
+
+static void markDirty(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+
+static void unlinkSlot(uint8_t slot)
+{
+    if(below[slot] != NO_SLOT)
+    {
+        above[below[slot]] = above[slot];
+    }
+    else
+    {
+        bottomSlot = above[slot];
+    }
+    if(above[slot] != NO_SLOT)
+    {
+        below[above[slot]] = below[slot];
+    }
+    else
+    {
+        topSlot = below[slot];
+    }
+}
+
+/* under NO_SLOT puts it at the bottom */
+static void linkAbove(uint8_t slot, uint8_t under)
+{
+    below[slot] = under;
+    above[slot] = under == NO_SLOT ? bottomSlot : above[under];
+    if(above[slot] != NO_SLOT)
+    {
+        below[above[slot]] = slot;
+    }
+    else
+    {
+        topSlot = slot;
+    }
+    if(under != NO_SLOT)
+    {
+        above[under] = slot;
+    }
+    else
+    {
+        bottomSlot = slot;
+    }
+}
+
+static uint8_t allocSlot(void)
+{
+    uint8_t slot = freeSlot;
+    if(slot != NO_SLOT)
+    {
+        freeSlot = above[slot];
+    }
+    else if(unusedSlot < MAX_NUMBER_OF_SHAPES)
+    {
+        slot = unusedSlot++;
+    }
+    else
+    {
+        return NO_SLOT;
+    }
+    generation[slot] = generation[slot] ? generation[slot] : 1;
+    liveSlots |= 1UL << slot;
+    pendingShapes |= 1UL << slot;
+    return slot;
+}
+
+static void freeSlotAt(uint8_t slot)
+{
+    shape_t *shape = &allParsedShapes[slot];
+    if(shape->active)
+    {
+        markDirty(shape->box.x0, shape->box.y0, shape->box.x1, shape->box.y1);
+    }
+    shape->active = false;
+    unlinkSlot(slot);
+    liveSlots &= ~(1UL << slot);
+    pendingShapes &= ~(1UL << slot);
+    generation[slot] = generation[slot] == 0xFF ? 1 : generation[slot] + 1;
+    above[slot] = freeSlot;
+    freeSlot = slot;
+}
+
+static uint8_t slotOf(oledc_shape_handle_t handle)
+{
+    uint8_t slot = handle & 0xFF;
+    if(slot >= MAX_NUMBER_OF_SHAPES || !(liveSlots & (1UL << slot)) || generation[slot] != (handle >> 8))
+    {
+        return NO_SLOT;
+    }
+    return slot;
+}
+
+/* The slot at place index in the draw order, NO_SLOT past the top */
+static uint8_t slotAt(uint8_t index)
+{
+    uint8_t slot = bottomSlot;
+    while(index-- && slot != NO_SLOT)
+    {
+        slot = above[slot];
+    }
+    return slot;
+}
+
 void initShapesMem(void)
 {
-    uint8_t i;
-    for(i = 0; i < MAX_NUMBER_OF_SHAPES; i++)
+    while(bottomSlot != NO_SLOT)
+    {
+        freeSlotAt(bottomSlot);
+    }
+    dirtyCount = 0;
+    pendingShapes = 0;
+}
+
+oledc_shape_handle_t oledC_newShape(enum OLEDC_SHAPE shape_type, shape_params_t *params)
+{
+    uint8_t slot = allocSlot();
+    if(slot == NO_SLOT)
+    {
+        return OLEDC_NO_SHAPE;
+    }
+    oledC_createShape(shape_type, params, &allParsedShapes[slot]);
+    linkAbove(slot, topSlot);
+    return ((uint16_t)generation[slot] << 8) | slot;
+}
+
+void oledC_deleteShape(oledc_shape_handle_t handle)
+{
+    uint8_t slot = slotOf(handle);
+    if(slot != NO_SLOT)
+    {
+        freeSlotAt(slot);
+    }
+}
+
+shape_t* oledC_shapeOf(oledc_shape_handle_t handle)
+{
+    uint8_t slot = slotOf(handle);
+    return slot == NO_SLOT ? NULL : &allParsedShapes[slot];
+}
+
+/* Shapes that end up over it are repainted with it */
+bool oledC_placeShapeAbove(oledc_shape_handle_t handle, oledc_shape_handle_t under)
+{
+    uint8_t slot = slotOf(handle);
+    uint8_t underSlot = slotOf(under);
+    shape_t *shape;
+    if(slot == NO_SLOT || (under != OLEDC_NO_SHAPE && underSlot == NO_SLOT) || slot == underSlot)
+    {
+        return false;
+    }
+    unlinkSlot(slot);
+    linkAbove(slot, underSlot);
+    shape = &allParsedShapes[slot];
+    if(shape->active)
+    {
+        markDirty(shape->box.x0, shape->box.y0, shape->box.x1, shape->box.y1);
+    }
+    return true;
+}
+
+bool oledC_raiseShape(oledc_shape_handle_t handle)
+{
+    uint8_t slot = slotOf(handle);
+    if(slot == NO_SLOT)
+    {
+        return false;
+    }
+    if(slot != topSlot)
+    {
+        unlinkSlot(slot);
+        linkAbove(slot, topSlot);
+        pendingShapes |= 1UL << slot;
+    }
+    return true;
+}
+
+static bool boxEmpty(const oledc_box_t *box)
+{
+    return box->x0 > box->x1 || box->y0 > box->y1;
+}
+
+static bool boxesMeet(const oledc_box_t *a, const oledc_box_t *b)
+{
+    return !boxEmpty(a) && !boxEmpty(b) &&
+           a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+static void markDirty(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    oledc_box_t *box;
+    if(x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+    if(dirtyCount < MAX_DIRTY_BOXES)
+    {
+        box = &dirtyBoxes[dirtyCount++];
+        box->x0 = x0;
+        box->y0 = y0;
+        box->x1 = x1;
+        box->y1 = y1;
+        return;
+    }
+    box = &dirtyBoxes[MAX_DIRTY_BOXES - 1];
+    box->x0 = x0 < box->x0 ? x0 : box->x0;
+    box->y0 = y0 < box->y0 ? y0 : box->y0;
+    box->x1 = x1 > box->x1 ? x1 : box->x1;
+    box->y1 = y1 > box->y1 ? y1 : box->y1;
+}
+
+/* What old covered and now does not: up to four strips around the overlap */
+static void markUncovered(const oledc_box_t *old, const oledc_box_t *now)
+{
+    uint8_t x0, x1;
+    if(!boxesMeet(old, now))
+    {
+        if(!boxEmpty(old))
+        {
+            markDirty(old->x0, old->y0, old->x1, old->y1);
+        }
+        return;
+    }
+    if(old->x0 < now->x0)
+    {
+        markDirty(old->x0, old->y0, now->x0 - 1, old->y1);
+    }
+    if(old->x1 > now->x1)
     {
-        allParsedShapes[i].active = false;
-        allParsedShapes[i].draw = dummyshape;
+        markDirty(now->x1 + 1, old->y0, old->x1, old->y1);
+    }
+    x0 = old->x0 > now->x0 ? old->x0 : now->x0;
+    x1 = old->x1 < now->x1 ? old->x1 : now->x1;
+    if(old->y0 < now->y0)
+    {
+        markDirty(x0, old->y0, x1, now->y0 - 1);
+    }
+    if(old->y1 > now->y1)
+    {
+        markDirty(x0, now->y1 + 1, x1, old->y1);
     }
 }
 
+void oledC_setShapeBackground(uint16_t color)
+{
+    background = color;
+}
+
 void oledC_removeShape(uint8_t drawIndex)
 {
-    uint8_t i;
-    for(i = drawIndex; i < (MAX_NUMBER_OF_SHAPES - 1); i++)
+    uint8_t slot = slotAt(drawIndex);
+    if(slot != NO_SLOT)
     {
-        allParsedShapes[i] = allParsedShapes[i+1];
+        freeSlotAt(slot);
     }
-    allParsedShapes[MAX_NUMBER_OF_SHAPES-1].active = false;
 }
 
 shape_t* oledC_getShape(uint8_t index)
 {
-    index = index > MAX_NUMBER_OF_SHAPES ? MAX_NUMBER_OF_SHAPES : index;
-    return &allParsedShapes[index];
+    uint8_t slot = slotAt(index);
+    if(slot == NO_SLOT)
+    {
+        blankShape.active = false;
+        blankShape.draw = dummyshape;
+        return &blankShape;
+    }
+    return &allParsedShapes[slot];
 }
 
+/* Past the top goes on top; with the pool full nothing is added */
 void oledC_addShape(uint8_t drawIndex, enum OLEDC_SHAPE shape_type, shape_params_t *params)
 {
-    uint8_t i;
-    shape_t *newShape;
-    drawIndex = drawIndex >= MAX_NUMBER_OF_SHAPES ? (MAX_NUMBER_OF_SHAPES-1) : drawIndex;
-    for(i = (MAX_NUMBER_OF_SHAPES-1); i > drawIndex && i > 0; i--)
+    uint8_t slot = allocSlot();
+    uint8_t under;
+    if(slot == NO_SLOT)
     {
-        allParsedShapes[i] = allParsedShapes[i-1];
-    }   
-    
-    newShape = &allParsedShapes[drawIndex];
-    oledC_createShape(shape_type, params, newShape);
+        return;
+    }
+    oledC_createShape(shape_type, params, &allParsedShapes[slot]);
+    under = drawIndex == 0 ? NO_SLOT : slotAt(drawIndex - 1);
+    linkAbove(slot, (drawIndex && under == NO_SLOT) ? topSlot : under);
+}
+
+/*
+ * A shape that paints its whole box only needs the strips it left behind
+ * cleared; any other shape has its new box cleared as well.
+ */
+void oledC_shapeChanged(oledc_shape_handle_t handle)
+{
+    uint8_t slot = slotOf(handle);
+    shape_t *shape;
+    oledc_box_t box;
+    bool covers;
+    if(slot == NO_SLOT)
+    {
+        return;
+    }
+    shape = &allParsedShapes[slot];
+    covers = oledC_shapeBounds(shape, &box);
+    if(shape->active)
+    {
+        markUncovered(&shape->box, &box);
+        if(!covers)
+        {
+            markDirty(box.x0, box.y0, box.x1, box.y1);
+        }
+        pendingShapes |= 1UL << slot;
+    }
+    shape->box = box;
+}
+
+/*
+ * One pass bottom to top: a shape is repainted when it is pending, touches
+ * a cleared area, or touches a shape repainted before it (which would have
+ * covered it).
+ */
+uint8_t oledC_redrawDirty(void)
+{
+    uint32_t drawn = 0;
+    uint8_t i, slot, count = 0;
+    bool redraw;
+    shape_t *shape;
+
+    if((dirtyCount == 0 && pendingShapes == 0) || !oledC_beginTransaction())
+    {
+        return 0;
+    }
+    for(i = 0; i < dirtyCount; i++)
+    {
+        oledC_DrawRectangle(dirtyBoxes[i].x0, dirtyBoxes[i].y0, dirtyBoxes[i].x1, dirtyBoxes[i].y1, background);
+    }
+    for(slot = bottomSlot; slot != NO_SLOT; slot = above[slot])
+    {
+        shape = &allParsedShapes[slot];
+        if(!shape->active || boxEmpty(&shape->box))
+        {
+            continue;
+        }
+        redraw = (pendingShapes >> slot) & 1;
+        for(i = 0; i < dirtyCount && !redraw; i++)
+        {
+            redraw = boxesMeet(&shape->box, &dirtyBoxes[i]);
+        }
+        for(i = 0; i < MAX_NUMBER_OF_SHAPES && !redraw; i++)
+        {
+            redraw = ((drawn >> i) & 1) && boxesMeet(&shape->box, &allParsedShapes[i].box);
+        }
+        if(redraw)
+        {
+            shape->draw(shape);
+            drawn |= 1UL << slot;
+            count++;
+        }
+    }
+    dirtyCount = 0;
+    pendingShapes = 0;
+    oledC_endTransaction();
+    return count;
 }
 
 void oledC_redrawIndex(uint8_t indShape)
 {
-    allParsedShapes[indShape].draw(&allParsedShapes[indShape]);
+    uint8_t slot = slotAt(indShape);
+    if(slot != NO_SLOT)
+    {
+        allParsedShapes[slot].draw(&allParsedShapes[slot]);
+    }
 }
 
 void oledC_redrawTo(uint8_t endInd)
@@ -91,12 +443,13 @@ void oledC_redrawFrom(uint8_t startInd)
 void oledC_redrawSome(uint8_t startInd, uint8_t endInd)
 {
     uint8_t i;
+    uint8_t slot = slotAt(startInd);
     endInd = endInd > MAX_NUMBER_OF_SHAPES ? MAX_NUMBER_OF_SHAPES : endInd;
-    for(i = startInd; i < endInd; i++)
+    for(i = startInd; i < endInd && slot != NO_SLOT; i++, slot = above[slot])
     {
-        if(allParsedShapes[i].active)
+        if(allParsedShapes[slot].active)
         {
-            allParsedShapes[i].draw(&allParsedShapes[i]);
+            allParsedShapes[slot].draw(&allParsedShapes[slot]);
         }
     }
 }
@@ -104,22 +457,29 @@ void oledC_redrawSome(uint8_t startInd, uint8_t endInd)
 void oledC_eraseShape(uint8_t indShape,uint16_t eraseColor)
 {
     shape_t* ourShape = oledC_getShape(indShape);
-    uint16_t saveColor = ourShape->params.point.color;
-    ourShape->params.point.color = eraseColor;
-    ourShape->draw(ourShape);
-    ourShape->params.point.color = saveColor;
+    background = eraseColor;
+    if(ourShape->active)
+    {
+        ourShape->active = false;
+        markDirty(ourShape->box.x0, ourShape->box.y0, ourShape->box.x1, ourShape->box.y1);
+    }
+    oledC_redrawDirty();
 }
 
 void oledC_eraseAll(uint16_t eraseColor)
 {
-    uint8_t i;
-    for(i = 0; i < MAX_NUMBER_OF_SHAPES; i++)
+    uint8_t slot;
+    background = eraseColor;
+    for(slot = bottomSlot; slot != NO_SLOT; slot = above[slot])
     {
-        if(allParsedShapes[i].active)
+        if(allParsedShapes[slot].active)
         {
-            oledC_eraseShape(i,eraseColor);
+            allParsedShapes[slot].active = false;
+            markDirty(allParsedShapes[slot].box.x0, allParsedShapes[slot].box.y0,
+                      allParsedShapes[slot].box.x1, allParsedShapes[slot].box.y1);
         }
     }
+    oledC_redrawDirty();
 }
 
 void oledC_redrawAll(void)
@@ -26,6 +26,43 @@
 #include <stdint.h>
 #include "oledC_shapes.h"
 
+/*
+ * Shapes live in a fixed pool of slots and are named by handles: the slot
+ * in the low byte, the slot's generation in the high byte. Deleting a shape
+ * bumps the generation, so a handle kept past that finds nothing instead of
+ * another shape. Draw order is a separate linked list, bottom to top, so
+ * adding, deleting and reordering move no shapes.
+ */
+typedef uint16_t oledc_shape_handle_t;
+
+#define OLEDC_NO_SHAPE 0
+
+/* Returns OLEDC_NO_SHAPE when the pool is full; the new shape goes on top */
+oledc_shape_handle_t oledC_newShape(enum OLEDC_SHAPE shape_type, shape_params_t *params);
+void oledC_deleteShape(oledc_shape_handle_t handle);
+/* NULL once the shape has been deleted */
+shape_t* oledC_shapeOf(oledc_shape_handle_t handle);
+/* Just above under, or at the bottom when under is OLEDC_NO_SHAPE */
+bool oledC_placeShapeAbove(oledc_shape_handle_t handle, oledc_shape_handle_t under);
+bool oledC_raiseShape(oledc_shape_handle_t handle);
+
+/*
+ * Retained display list: each shape keeps the box it covers. Changes only
+ * mark areas dirty; oledC_redrawDirty() clears those to the list background
+ * and repaints, bottom to top, the shapes that touch them, plus any shape
+ * above one it repaints.
+ */
+void oledC_setShapeBackground(uint16_t color);
+/* After editing a shape's params in place: its uncovered area and new box become dirty */
+void oledC_shapeChanged(oledc_shape_handle_t handle);
+/* Returns the number of shapes repainted */
+uint8_t oledC_redrawDirty(void);
+
+/*
+ * Index calls address shapes by their place in the draw order, 0 at the
+ * bottom; they walk the list, and a shape's index changes as others come
+ * and go.
+ */
 void oledC_redrawAll(void);
 void oledC_redrawTo(uint8_t endInd);
 void oledC_redrawSome(uint8_t startInd, uint8_t endInd);
@@ -33,8 +70,10 @@ void oledC_redrawFrom(uint8_t startInd);
 void oledC_redrawIndex(uint8_t indShape);
 void oledC_addShape(uint8_t drawIndex, enum OLEDC_SHAPE shape_type, shape_params_t *params);
 void oledC_removeShape(uint8_t drawIndex);
+/* Take the shape off the panel and out of the redraws; eraseColor becomes the background */
 void oledC_eraseShape(uint8_t indShape, uint16_t eraseColor);
 void oledC_eraseAll(uint16_t eraseColor);
+/* Indices past the top shape get a blank shape that is never drawn */
 shape_t* oledC_getShape(uint8_t index);
 
 #endif	/* OLEDC_SHAPE_HANDLER_H */
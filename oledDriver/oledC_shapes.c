@@ -20,10 +20,15 @@
     TERMS.
  */
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "oledC_shapes.h"
 #include "oledC.h"
+#include "oledC_framebuffer.h"
+#include "oledC_shadow.h"
+#include "oledC_font.h"
+#include "oledC_sprites.h"
 
 static const uint8_t OLED_DIM_WIDTH = 0x5F;
 static const uint8_t OLED_DIM_HEIGHT = 0x5F;
@@ -39,6 +44,7 @@ static void drawCharacter(shape_t *shape);
 static void drawString(shape_t *shape);
 //static void drawString(shape_t *shape);
 static void drawBitmap(shape_t *shape);
+static void drawRLE(shape_t *shape);
 
 
 void oledC_createShape(enum OLEDC_SHAPE shape_type, shape_params_t *params, shape_t *newShape)
@@ -77,50 +83,112 @@ void oledC_createShape(enum OLEDC_SHAPE shape_type, shape_params_t *params, shap
             newShape->params.bitmap = params->bitmap;
             newShape->draw = drawBitmap;
             break;
+        case OLED_SHAPE_RLE:
+            newShape->params.rle = params->rle;
+            newShape->draw = drawRLE;
+            break;
         default: 
             newShape->draw = drawPoint;
             break;
     }
+    oledC_shapeBounds(newShape, &newShape->box);
+}
+
+/* Signed edges, so shapes hanging off the top or left still get a box */
+static void setBox(oledc_box_t *box, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : x1;
+    y1 = y1 > OLED_DIM_HEIGHT ? OLED_DIM_HEIGHT : y1;
+    if(x0 > x1 || y0 > y1)
+    {
+        box->x0 = 1;    // empty
+        box->x1 = 0;
+        box->y0 = 1;
+        box->y1 = 0;
+        return;
+    }
+    box->x0 = x0;
+    box->y0 = y0;
+    box->x1 = x1;
+    box->y1 = y1;
+}
+
+/* The extents follow the drawing routines below, character cells included */
+bool oledC_shapeBounds(const shape_t *shape, oledc_box_t *box)
+{
+    const shape_params_t *p = &shape->params;
+    int16_t r, a, b, sx, sy, n;
+    uint8_t *ch;
+
+    switch(shape->_type)
+    {
+        case OLED_SHAPE_CIRCLE:
+            r = p->circle.radius <= 1 ? 1 : p->circle.radius;
+            setBox(box, p->circle.xc - r, p->circle.yc - r, p->circle.xc + r, p->circle.yc + r);
+            return false;
+        case OLED_SHAPE_RING:
+            r = p->ring.radius + (p->ring.width >> 1);
+            setBox(box, p->ring.x0 - r, p->ring.y0 - r, p->ring.x0 + r, p->ring.y0 + r);
+            return false;
+        case OLED_SHAPE_RECTANGLE:
+            setBox(box, p->rectangle.xs, p->rectangle.ys, p->rectangle.xe, p->rectangle.ye);
+            return true;
+        case OLED_SHAPE_LINE:
+            a = p->line.width <= 1 ? 0 : (p->line.width - 1) / 2;
+            b = p->line.width <= 1 ? 0 : p->line.width / 2;
+            setBox(box, (p->line.xs < p->line.xe ? p->line.xs : p->line.xe) - a,
+                   (p->line.ys < p->line.ye ? p->line.ys : p->line.ye) - a,
+                   (p->line.xs > p->line.xe ? p->line.xs : p->line.xe) + b,
+                   (p->line.ys > p->line.ye ? p->line.ys : p->line.ye) + b);
+            return false;
+        case OLED_SHAPE_CHARACTER:
+            sx = p->character.scale_x;
+            sy = p->character.scale_y;
+            setBox(box, p->character.x, p->character.y,
+                   p->character.x + OLED_FONT_WIDTH * sx - 1,
+                   p->character.y + (OLED_FONT_HEIGHT + 1) * sy - 1);
+            return false;
+        case OLED_SHAPE_STRING:
+            sx = p->string.scale_x;
+            sy = p->string.scale_y;
+            for(n = 0, ch = p->string.string; ch && *ch; ch++)
+            {
+                n++;
+            }
+            setBox(box, p->string.x, p->string.y,
+                   p->string.x + n * (OLED_FONT_WIDTH * sx + 1) - 2,
+                   p->string.y + (OLED_FONT_HEIGHT + 1) * sy - 1);
+            return false;
+        case OLED_SHAPE_BITMAP:
+            sx = p->bitmap.sx ? p->bitmap.sx : 1;
+            sy = p->bitmap.sy ? p->bitmap.sy : 1;
+            setBox(box, p->bitmap.x + sx, p->bitmap.y, p->bitmap.x + 33 * sx - 1,
+                   p->bitmap.y + p->bitmap.array_length * sy - 1);
+            return false;
+        case OLED_SHAPE_RLE:
+            if(p->rle.image == NULL)
+            {
+                setBox(box, 1, 1, 0, 0);
+                return false;
+            }
+            sx = p->rle.sx ? p->rle.sx : 1;
+            sy = p->rle.sy ? p->rle.sy : 1;
+            if(p->rle.x > OLED_DIM_WIDTH || p->rle.y > OLED_DIM_HEIGHT)
+            {
+                setBox(box, 1, 1, 0, 0); // oledC_DrawRLE does not draw these
+                return false;
+            }
+            setBox(box, p->rle.x, p->rle.y, p->rle.x + p->rle.image->width * sx - 1,
+                   p->rle.y + p->rle.image->height * sy - 1);
+            return true;
+        default:
+            setBox(box, p->point.x, p->point.y, p->point.x, p->point.y);
+            return true;
+    }
 }
 
-static const uint8_t font[] = 
-    { // compact 5x8 font
-    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFA,0x00,0x00,0x00,0xE0,0x00,0xE0,0x00, //	'sp,!,"
-    0x28,0xFE,0x28,0xFE,0x28, // #
-    0x24,0x54,0xFE,0x54,0x48,0xC4,0xC8,0x10,0x26,0x46,0x6C,0x92,0x6A,0x04,0x0A, //	'$,%,&
-    0x00,0x10,0xE0,0xC0,0x00,0x00,0x38,0x44,0x82,0x00,0x00,0x82,0x44,0x38,0x00, //	'',(,)
-    0x54,0x38,0xFE,0x38,0x54,0x10,0x10,0x7C,0x10,0x10,0x00,0x00,0x0E,0x0C,0x00, //	'*,+,,
-    0x10,0x10,0x10,0x10,0x10,0x00,0x00,0x06,0x06,0x00,0x04,0x08,0x10,0x20,0x40, //	'-,.,/
-    0x7C,0x8A,0x92,0xA2,0x7C,0x00,0x42,0xFE,0x02,0x00,0x4E,0x92,0x92,0x92,0x62, //	'0,1,2
-    0x84,0x82,0x92,0xB2,0xCC,0x18,0x28,0x48,0xFE,0x08,0xE4,0xA2,0xA2,0xA2,0x9C, //	'3,4,5
-    0x3C,0x52,0x92,0x92,0x8C,0x82,0x84,0x88,0x90,0xE0,0x6C,0x92,0x92,0x92,0x6C, //	'6,7,8
-    0x62,0x92,0x92,0x94,0x78,0x00,0x00,0x28,0x00,0x00,0x00,0x02,0x2C,0x00,0x00, //	'9,:,;
-    0x00,0x10,0x28,0x44,0x82,0x28,0x28,0x28,0x28,0x28,0x00,0x82,0x44,0x28,0x10, //	'<,=,>
-    0x40,0x80,0x9A,0x90,0x60,0x7C,0x82,0xBA,0x9A,0x72,                          //  '?,@
-    0x3E,0x48,0x88,0x48,0x3E,                                                   //	'A
-    0xFE,0x92,0x92,0x92,0x6C,0x7C,0x82,0x82,0x82,0x44,0xFE,0x82,0x82,0x82,0x7C, //	'B,C,D
-    0xFE,0x92,0x92,0x92,0x82,0xFE,0x90,0x90,0x90,0x80,0x7C,0x82,0x82,0x8A,0xCE, //	'E,F,G
-    0xFE,0x10,0x10,0x10,0xFE,0x00,0x82,0xFE,0x82,0x00,0x04,0x02,0x82,0xFC,0x80, //	'H,I,J
-    0xFE,0x10,0x28,0x44,0x82,0xFE,0x02,0x02,0x02,0x02,0xFE,0x40,0x38,0x40,0xFE, //	'K,L,M
-    0xFE,0x20,0x10,0x08,0xFE,0x7C,0x82,0x82,0x82,0x7C,0xFE,0x90,0x90,0x90,0x60, //	'N,O,P
-    0x7C,0x82,0x8A,0x84,0x7A,0xFE,0x90,0x98,0x94,0x62,0x64,0x92,0x92,0x92,0x4C, //	'Q,R,S
-    0xC0,0x80,0xFE,0x80,0xC0,0xFC,0x02,0x02,0x02,0xFC,0xF8,0x04,0x02,0x04,0xF8, //	'T,U,V
-    0xFC,0x02,0x1C,0x02,0xFC,0xC6,0x28,0x10,0x28,0xC6,0xC0,0x20,0x1E,0x20,0xC0, //	'W,X,Y
-    0x86,0x9A,0x92,0xB2,0xC2,                                                   //  'Z
-    0x00,0xFE,0x82,0x82,0x82,0x40,0x20,0x10,0x08,0x04,                          //	'[,'\' 
-    0x00,0x82,0x82,0x82,0xFE,0x20,0x40,0x80,0x40,0x20,0x02,0x02,0x02,0x02,0x02, //	'],^,_
-    0x00,0xC0,0xE0,0x10,0x00,0x04,0x2A,0x2A,0x1C,0x02,0xFE,0x14,0x22,0x22,0x1C, //	'`,a,b
-    0x1C,0x22,0x22,0x22,0x14,0x1C,0x22,0x22,0x14,0xFE,0x1C,0x2A,0x2A,0x2A,0x18, //	'c,d,e
-    0x00,0x10,0x7E,0x90,0x40,0x30,0x4A,0x4A,0x52,0x3C,0xFE,0x10,0x20,0x20,0x1E, //	'f,g,h
-    0x00,0x22,0xBE,0x02,0x00,0x04,0x02,0x02,0xBC,0x00,0xFE,0x08,0x14,0x22,0x00, //	'i,j,k
-    0x00,0x82,0xFE,0x02,0x00,0x3E,0x20,0x1E,0x20,0x1E,0x3E,0x10,0x20,0x20,0x1E, //	'l,m,n
-    0x1C,0x22,0x22,0x22,0x1C,0x3E,0x18,0x24,0x24,0x18,0x18,0x24,0x24,0x18,0x3E, //	'o,p,q
-    0x3E,0x10,0x20,0x20,0x10,0x12,0x2A,0x2A,0x2A,0x24,0x20,0x20,0xFC,0x22,0x24, //	'r,s,t
-    0x3C,0x02,0x02,0x04,0x3E,0x38,0x04,0x02,0x04,0x38,0x3C,0x02,0x0C,0x02,0x3C, //	'u,v,w
-    0x22,0x14,0x08,0x14,0x22,0x32,0x0A,0x0A,0x0A,0x3C,0x22,0x26,0x2A,0x32,0x22, //	'x,y,z
-    0x00,0x10,0x6C,0x82,0x00,0x00,0x00,0xFE,0x00,0x00,0x00,0x82,0x6C,0x10,0x00, //	'{,|,}
-    0x40,0x80,0x40,0x20,0x40                                                    //  '~
-    };
 static uint8_t coerceAddressAdditionWithinRange(uint8_t base_address, int8_t adder)
 {
     int16_t additionResult = base_address+adder;
@@ -135,12 +203,37 @@ static uint8_t coerceAddressAdditionWithinRange(uint8_t base_address, int8_t add
     return (uint8_t) (base_address+adder);
 }
 
+/* A far edge computed in 16 bits, pulled back onto the panel */
+static uint8_t coerceEnd(uint16_t end)
+{
+    return end > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : (uint8_t)end;
+}
+
+/* One window per rectangle; a start off the panel draws nothing, the end is clipped */
+static void fillRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color)
+{
+    if(start_x > OLED_DIM_WIDTH || start_y > OLED_DIM_HEIGHT || start_x > end_x || start_y > end_y)
+    {
+        return;
+    }
+    end_x = end_x > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : end_x;
+    end_y = end_y > OLED_DIM_HEIGHT ? OLED_DIM_HEIGHT : end_y;
+    oledC_FillWindow(start_x, start_y, end_x, end_y, color,
+                     (uint16_t)(end_x - start_x + 1) * (end_y - start_y + 1));
+}
+
+/* From the framebuffer or a shadowed region when there is one, else from the panel */
 uint16_t oledC_ReadPoint(uint8_t x, uint8_t y)
 {
+    uint16_t color;
     if(x > OLED_DIM_WIDTH || y > OLED_DIM_HEIGHT)
     {
         return 0;
     }
+    if(oledC_shadowRead(x, y, &color))
+    {
+        return color;
+    }
     oledC_setColumnAddressBounds(x,95);
     oledC_setRowAddressBounds(y,95);
     return oledC_readColor();
@@ -152,9 +245,7 @@ void oledC_DrawPoint(uint8_t x, uint8_t y, uint16_t color)
     {
         return;
     }
-    oledC_setColumnAddressBounds(x,95);
-    oledC_setRowAddressBounds(y,95);
-    oledC_sendColorInt(color);
+    oledC_FillWindow(x, y, x, y, color, 1);
 }
 
 void oledC_DrawThickPoint(uint8_t center_x, uint8_t center_y, uint8_t width, uint16_t color)
@@ -166,6 +257,10 @@ void oledC_DrawThickPoint(uint8_t center_x, uint8_t center_y, uint8_t width, uin
         return;
     }
     width = (width <= 1) ? 1 : width;
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     max_x = coerceAddressAdditionWithinRange(center_x, width);
     min_x = coerceAddressAdditionWithinRange(center_x, -(width));
     max_y = coerceAddressAdditionWithinRange(center_y, width);
@@ -183,125 +278,219 @@ void oledC_DrawThickPoint(uint8_t center_x, uint8_t center_y, uint8_t width, uin
             }
         }
     }
+    oledC_endTransaction();
+}
+
+/* One scanline of a disc or ring, clipped to the panel */
+static void fillSpan(int16_t x0, int16_t x1, int16_t y, uint16_t color)
+{
+    if(y < 0 || y > OLED_DIM_HEIGHT || x1 < 0 || x0 > x1)
+    {
+        return;
+    }
+    fillRectangle(x0 < 0 ? 0 : x0, y, coerceEnd(x1), y, color);
+}
+
+/*
+ * Half-widths of a disc row by row, from the middle out. A pixel is inside
+ * when x^2 + y^2 <= r^2 + r, the midpoint test for radius r + 1/2; err
+ * holds r^2 + r - x^2 - y^2 and is only ever adjusted by the differences.
+ */
+typedef struct disc_walk_t
+{
+    int16_t x;
+    int16_t y;
+    int32_t err;
+} disc_walk_t;
+
+static void startDisc(disc_walk_t *walk, int16_t radius)
+{
+    walk->x = radius;
+    walk->y = 0;
+    walk->err = radius;
+}
+
+/* Half-width of the current row, -1 past the top of the disc; then moves a row out */
+static int16_t nextDiscRow(disc_walk_t *walk)
+{
+    int16_t half;
+    while(walk->x >= 0 && walk->err < 0)
+    {
+        walk->err += 2 * walk->x - 1;
+        walk->x--;
+    }
+    half = walk->x;
+    walk->y++;
+    walk->err -= 2 * walk->y - 1;
+    return half;
 }
 
+/* One window per scanline, each pixel written once */
 void oledC_DrawCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint16_t color)
 {
-    int8_t xCurr, yMax = 0, y = 0, x=0;
-    int16_t d = 0;
-   
+    disc_walk_t disc;
+    int16_t dy, half;
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     radius = radius <= 1 ? 1 : radius;
-    xCurr = radius+1;
-    yMax = 0;
-    y = 0;
-    d = 0;
-
-    while (xCurr >= yMax)
+    startDisc(&disc, radius);
+    for(dy = 0; dy <= radius; dy++)
     {
-        d += (2*yMax+1);
-        yMax++;
-        if(d >= 0)
+        half = nextDiscRow(&disc);
+        fillSpan(x0 - half, x0 + half, y0 + dy, color);
+        if(dy)
         {
-            for(y = y; y < yMax; y++)
-            {
-                for(x = y; x < xCurr; x++)
-                {
-                    oledC_DrawPoint(x0 + x,y0 + y, color);
-                    oledC_DrawPoint(x0 + x,y0 - y, color);
-                    oledC_DrawPoint(x0 - x,y0 + y, color);
-                    oledC_DrawPoint(x0 - x,y0 - y, color);    
-                    oledC_DrawPoint(x0 + y,y0 + x, color);
-                    oledC_DrawPoint(x0 + y,y0 - x, color);
-                    oledC_DrawPoint(x0 - y,y0 + x, color);
-                    oledC_DrawPoint(x0 - y,y0 - x, color);
-                }
-            }
-            d += -2*xCurr + 1;
-            xCurr--;
+            fillSpan(x0 - half, x0 + half, y0 - dy, color);
         }
     }
+    oledC_endTransaction();
 }
 
+/*
+ * The disc of radius + width/2 less the disc width pixels smaller: rows
+ * that cross the hole are two spans, the rest one.
+ */
 void oledC_DrawRing(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t width, uint16_t color)
 {
-    int8_t x, y;
-    int16_t d;
-    radius += width >> 1;
-    while(width-- > 0)
+    disc_walk_t outer, inner;
+    int16_t outerRadius = radius + (width >> 1);
+    int16_t innerRadius = outerRadius - width;
+    int16_t dy, half, hole;
+    int8_t side;
+    if(width == 0 || !oledC_beginTransaction())
     {
-        x = radius;
-        y = 0;
-        d = 0;
-
-        while (x >= y)
+        return;
+    }
+    startDisc(&outer, outerRadius);
+    startDisc(&inner, innerRadius);
+    for(dy = 0; dy <= outerRadius; dy++)
+    {
+        half = nextDiscRow(&outer);
+        hole = (dy <= innerRadius) ? nextDiscRow(&inner) : -1;
+        for(side = 1; side >= -1; side -= 2)
         {
-            oledC_DrawPoint(x0 + x,y0 + y, color);
-            oledC_DrawPoint(x0 + x,y0 - y, color);
-            oledC_DrawPoint(x0 - x,y0 + y, color);
-            oledC_DrawPoint(x0 - x,y0 - y, color);    
-            oledC_DrawPoint(x0 + y,y0 + x, color);
-            oledC_DrawPoint(x0 + y,y0 - x, color);
-            oledC_DrawPoint(x0 - y,y0 + x, color);
-            oledC_DrawPoint(x0 - y,y0 - x, color);
-            
-            d += (2*y+1);
-            y++;
-            if(d >= 0)
+            if(side < 0 && dy == 0)
             {
-                d += -2*x + 1;
-                x--;
+                break;
+            }
+            if(hole < 0)
+            {
+                fillSpan(x0 - half, x0 + half, y0 + side * dy, color);
+            }
+            else if(hole < half)
+            {
+                fillSpan(x0 - half, x0 - hole - 1, y0 + side * dy, color);
+                fillSpan(x0 + hole + 1, x0 + half, y0 + side * dy, color);
             }
         }
-        radius--;
     }
+    oledC_endTransaction();
 }
 
+/*
+ * One straight run of a line: a0..a1 along the major axis at b across it,
+ * widened to width pixels across, as a single rectangle
+ */
+static void drawLineRun(int16_t a0, int16_t a1, int16_t b, bool steep, uint8_t width, uint16_t color)
+{
+    int16_t b0 = b - (width - 1) / 2;
+    int16_t b1 = b0 + width - 1;
+    int16_t t;
+
+    if(a0 > a1)
+    {
+        t = a0;
+        a0 = a1;
+        a1 = t;
+    }
+    b0 = b0 < 0 ? 0 : b0;
+    if(a0 > OLED_DIM_WIDTH || b0 > OLED_DIM_WIDTH || b1 < 0)
+    {
+        return;
+    }
+    if(steep)
+    {
+        fillRectangle(b0, a0, coerceEnd(b1), coerceEnd(a1), color);
+    }
+    else
+    {
+        fillRectangle(a0, b0, coerceEnd(a1), coerceEnd(b1), color);
+    }
+}
+
+/*
+ * Integer Bresenham in every octant, endpoints included. The line is walked
+ * along its major axis; each stretch that keeps the same minor coordinate
+ * goes out as one window, so horizontal and vertical lines are one fill.
+ */
 void oledC_DrawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t width, uint16_t color)
 {
-    int8_t x, y;
-    int8_t dx, dy, D;
+    int16_t dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int16_t dy = (y1 > y0) ? y1 - y0 : y0 - y1;
+    bool steep = dy > dx;
+    int16_t major = steep ? dy : dx;
+    int16_t minor = steep ? dx : dy;
+    int16_t a = steep ? y0 : x0;
+    int16_t b = steep ? x0 : y0;
+    int16_t aEnd = steep ? y1 : x1;
+    int8_t stepA = (steep ? y1 > y0 : x1 > x0) ? 1 : -1;
+    int8_t stepB = (steep ? x1 > x0 : y1 > y0) ? 1 : -1;
+    int16_t err = major / 2;
+    int16_t runStart = a;
+
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     width = width <= 1 ? 1 : width;
-    
-    dx = x1 - x0;
-    dy = y1 - y0;
-    D = dy - dx;
-    y = y0;
-    
-    for(x = x0; x < x1; x++)
+    while(a != aEnd)
     {
-        if(x <= OLED_DIM_WIDTH && y <= OLED_DIM_HEIGHT)
+        err -= minor;
+        if(err < 0)
         {
-            if(width <= 1)
-            {
-                oledC_DrawPoint(x,y, color);
-            } 
-            else 
-            {
-                oledC_DrawCircle(x, y, width/2, color);
-            }
-        }
-        if(D >= 0)
-        {
-            y = y+1;
-            D = D - dx;
+            drawLineRun(runStart, a, b, steep, width, color);
+            err += major;
+            b += stepB;
+            runStart = a + stepA;
         }
-        D = D + dy;
+        a += stepA;
     }
+    drawLineRun(runStart, a, b, steep, width, color);
+    oledC_endTransaction();
 }
 
 void oledC_DrawRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color)
 {
-    uint8_t x;
-    uint8_t y;
-    oledC_setColumnAddressBounds(start_x,end_x);
-    oledC_setRowAddressBounds(start_y,end_y);
-    for(x = start_x; x < end_x+1; x++)
+    fillRectangle(start_x, start_y, end_x, end_y, color);
+}
+
+/* Read back a row at a time and write it in one window; cheap only where reads hit RAM */
+void oledC_XorRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t mask)
+{
+    uint16_t row[OLED_DIM_WIDTH + 1];
+    uint8_t x, y;
+
+    if(start_x > OLED_DIM_WIDTH || start_y > OLED_DIM_HEIGHT || start_x > end_x || start_y > end_y)
     {
-        for(y = start_y; y < end_y+1; y++)
+        return;
+    }
+    end_x = end_x > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : end_x;
+    end_y = end_y > OLED_DIM_HEIGHT ? OLED_DIM_HEIGHT : end_y;
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
+    for(y = start_y; y <= end_y; y++)
+    {
+        for(x = start_x; x <= end_x; x++)
         {
-            oledC_sendColorInt(color);
+            row[x - start_x] = oledC_ReadPoint(x, y) ^ mask;
         }
+        oledC_WriteWindow(start_x, y, end_x, y, row, end_x - start_x + 1);
     }
+    oledC_endTransaction();
 }
 
 void oledC_DrawCharacter(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t ch, uint16_t color)
@@ -309,28 +498,367 @@ void oledC_DrawCharacter(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t c
     const uint8_t *f = &font[(ch-' ')*OLED_FONT_WIDTH]; // find the char in our font...
     uint16_t i_x;
     uint16_t i_y;
+    uint16_t run_y;
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     
     for(i_x = 0; i_x < OLED_FONT_WIDTH * sx; i_x += sx) // For each line of our text...
     { 
         uint8_t curr_char_byte = *f++;
+        run_y = 0;
         for(i_y = OLED_FONT_HEIGHT*sy; i_y > 0; i_y -= sy)
         {
             if(curr_char_byte & 0x01)
             {
-                oledC_DrawRectangle(x+i_x, y+i_y, x+i_x+sx-1, y+i_y+sy-1, color);
+                run_y = run_y ? run_y : i_y + sy - 1; // bottom of a run of set bits
+            }
+            else if(run_y)
+            {
+                oledC_DrawRectangle(x+i_x, y+i_y+sy, x+i_x+sx-1, y+run_y, color);
+                run_y = 0;
             }
             curr_char_byte >>= 1;
         }
+        if(run_y)
+        {
+            oledC_DrawRectangle(x+i_x, y+sy, x+i_x+sx-1, y+run_y, color);
+        }
     }
+    oledC_endTransaction();
 }
 
 void oledC_DrawString(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t *string, uint16_t color)
 {
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     while(*string)
     {
         oledC_DrawCharacter(x, y, sx, sy, *string++, color);
+        if((uint16_t)x + OLED_FONT_WIDTH * sx + 1 > OLED_DIM_WIDTH)
+        {
+            break; // the next cell starts off the panel; x would wrap
+        }
         x += OLED_FONT_WIDTH * sx + 1;
     }
+    oledC_endTransaction();
+}
+
+typedef struct glyph_run_t
+{
+    const uint8_t *string;
+    uint8_t x;
+    uint8_t y;
+    uint8_t sx;
+    uint8_t sy;
+    uint16_t color;
+    uint16_t background;
+} glyph_run_t;
+
+/*
+ * One row of character cells at a time: a cell is 5*sx columns of glyph and
+ * one gap column, 9*sy rows with the font's blank row on top. Glyph columns
+ * are read once per cell row and widened by repeating the pixel.
+ */
+static void renderGlyphRows(uint16_t *pixels, uint8_t x0, uint8_t y, uint8_t width, uint8_t rows, void *context)
+{
+    const glyph_run_t *run = context;
+    const uint8_t *s;
+    const uint8_t *f;
+    uint8_t left, col, rep, mask, ch;
+    uint16_t pixel;
+
+    while(rows--)
+    {
+        mask = (y - run->y) / run->sy;
+        mask = mask ? 0x80 >> (mask - 1) : 0;
+        left = width;
+        for(s = run->string; *s && left; s++)
+        {
+            ch = (*s < ' ' || *s > '~') ? ' ' : *s;
+            f = &font[(ch - ' ') * OLED_FONT_WIDTH];
+            for(col = 0; col < OLED_FONT_WIDTH && left; col++)
+            {
+                pixel = (f[col] & mask) ? run->color : run->background;
+                for(rep = run->sx; rep && left; rep--, left--)
+                {
+                    *pixels++ = pixel;
+                }
+            }
+            if(left)
+            {
+                *pixels++ = run->background;
+                left--;
+            }
+        }
+        y++;
+    }
+}
+
+/* Cells of one opaque string resolved to sprites: at most 96 / 6 fit the panel */
+#define SPRITE_CELLS 16
+
+#ifndef OLEDC_GLYPH_CACHE
+#define OLEDC_GLYPH_CACHE 0     // expanded RGB565 sprites kept in RAM
+#endif
+
+typedef struct sprite_run_t
+{
+    const oledc_sprite_set_t *set;
+    const uint8_t *cell[SPRITE_CELLS];
+#if OLEDC_GLYPH_CACHE
+    const uint16_t *expanded[SPRITE_CELLS];
+#endif
+    uint8_t cells;
+    uint8_t y;
+    uint16_t color;
+    uint16_t background;
+} sprite_run_t;
+
+static bool useSprites = true;
+
+void oledC_useGlyphSprites(bool enable)
+{
+    useSprites = enable;
+}
+
+#if OLEDC_GLYPH_CACHE
+/*
+ * A glyph at scale 2 is 10x16 pixels, 320 bytes expanded, so only a few
+ * fit beside everything else in 16 KB. Slots are reused round robin, but
+ * never one that a cell of the string being resolved already points to.
+ */
+#define GLYPH_CACHE_PIXELS 160
+
+typedef struct glyph_cache_entry_t
+{
+    const uint8_t *bits;
+    uint16_t color;
+    uint16_t background;
+    uint8_t stamp;
+    uint16_t pixels[GLYPH_CACHE_PIXELS];
+} glyph_cache_entry_t;
+
+static glyph_cache_entry_t glyphCache[OLEDC_GLYPH_CACHE];
+static uint8_t glyphCacheNext;
+static uint8_t glyphCacheStamp;
+
+static const uint16_t *cachedGlyph(const oledc_sprite_set_t *set, const uint8_t *bits, uint16_t color, uint16_t background)
+{
+    glyph_cache_entry_t *entry;
+    uint16_t i;
+    uint8_t n, b;
+
+    if((uint16_t)set->width * set->rows > GLYPH_CACHE_PIXELS)
+    {
+        return NULL;
+    }
+    for(n = 0; n < OLEDC_GLYPH_CACHE; n++)
+    {
+        entry = &glyphCache[n];
+        if(entry->bits == bits && entry->color == color && entry->background == background)
+        {
+            entry->stamp = glyphCacheStamp;
+            return entry->pixels;
+        }
+    }
+    for(n = 0; glyphCache[glyphCacheNext].stamp == glyphCacheStamp; n++)
+    {
+        if(n == OLEDC_GLYPH_CACHE)
+        {
+            return NULL; // every slot is in use by this string
+        }
+        glyphCacheNext = (glyphCacheNext + 1) % OLEDC_GLYPH_CACHE;
+    }
+    entry = &glyphCache[glyphCacheNext];
+    glyphCacheNext = (glyphCacheNext + 1) % OLEDC_GLYPH_CACHE;
+    entry->bits = bits;
+    entry->color = color;
+    entry->background = background;
+    entry->stamp = glyphCacheStamp;
+    for(i = 0; i < (uint16_t)set->width * set->rows; i++)
+    {
+        b = bits[(i / set->width) * set->rowBytes + (i % set->width) / 8];
+        entry->pixels[i] = (b & (0x80 >> (i % set->width % 8))) ? color : background;
+    }
+    return entry->pixels;
+}
+#endif
+
+/* Sprite of ch in the set matching both scales, or NULL */
+static const uint8_t *findSprite(uint8_t ch, uint8_t sx, uint8_t sy, const oledc_sprite_set_t **set)
+{
+    const oledc_sprite_set_t *s;
+    const char *c;
+    uint8_t i;
+
+    for(i = 0; i < oledC_spriteSetCount; i++)
+    {
+        s = &oledC_spriteSets[i];
+        if(s->scale != sx || s->scale != sy)
+        {
+            continue;
+        }
+        for(c = s->chars; *c; c++)
+        {
+            if((uint8_t)*c == ch)
+            {
+                *set = s;
+                return s->bits + (uint16_t)(c - s->chars) * s->rows * s->rowBytes;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Same cells as renderGlyphRows, copied from pre-scaled rows */
+static void renderSpriteRows(uint16_t *pixels, uint8_t x0, uint8_t y, uint8_t width, uint8_t rows, void *context)
+{
+    const sprite_run_t *run = context;
+    const oledc_sprite_set_t *set = run->set;
+    const uint8_t *bits;
+    uint8_t cell, col, left, mask, b, r;
+
+    while(rows--)
+    {
+        left = width;
+        if(y - run->y < set->scale)
+        {
+            while(left--)
+            {
+                *pixels++ = run->background; // the font's blank top row
+            }
+            y++;
+            continue;
+        }
+        r = y - run->y - set->scale;
+        for(cell = 0; cell < run->cells && left; cell++)
+        {
+#if OLEDC_GLYPH_CACHE
+            if(run->expanded[cell])
+            {
+                const uint16_t *src = run->expanded[cell] + (uint16_t)r * set->width;
+                for(col = 0; col < set->width && left; col++, left--)
+                {
+                    *pixels++ = *src++;
+                }
+            }
+            else
+#endif
+            {
+                bits = run->cell[cell] + (uint16_t)r * set->rowBytes;
+                mask = 0;
+                b = 0;
+                for(col = 0; col < set->width && left; col++, left--)
+                {
+                    if(!mask)
+                    {
+                        b = *bits++;
+                        mask = 0x80;
+                    }
+                    *pixels++ = (b & mask) ? run->color : run->background;
+                    mask >>= 1;
+                }
+            }
+            if(left)
+            {
+                *pixels++ = run->background;
+                left--;
+            }
+        }
+        y++;
+    }
+}
+
+/* Fill run with the sprites of string; false if any character has none */
+static bool resolveSprites(sprite_run_t *run, const uint8_t *string, uint8_t sx, uint8_t sy)
+{
+    const oledc_sprite_set_t *set = NULL;
+    uint8_t n;
+
+    if(!useSprites)
+    {
+        return false;
+    }
+#if OLEDC_GLYPH_CACHE
+    if(++glyphCacheStamp == 0)
+    {
+        glyphCacheStamp = 1; // 0 marks a slot never filled
+    }
+#endif
+    for(n = 0; string[n]; n++)
+    {
+        if(n == SPRITE_CELLS)
+        {
+            break; // the rest is off the panel
+        }
+        run->cell[n] = findSprite(string[n], sx, sy, &set);
+        if(!run->cell[n])
+        {
+            return false;
+        }
+#if OLEDC_GLYPH_CACHE
+        run->expanded[n] = cachedGlyph(set, run->cell[n], run->color, run->background);
+#endif
+    }
+    run->set = set;
+    run->cells = n;
+    return true;
+}
+
+/*
+ * One window for the whole run, every pixel of it written: no pre-clear.
+ * Strings made only of pre-rendered characters are copied from the sprite
+ * table instead of being scaled from the font.
+ */
+void oledC_DrawStringOpaque(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t *string, uint16_t color, uint16_t background)
+{
+    glyph_run_t run;
+    sprite_run_t sprites;
+    uint16_t n = 0;
+    uint16_t x1, y1;
+
+    while(string[n])
+    {
+        n++;
+    }
+    if(n == 0 || x > OLED_DIM_WIDTH || y > OLED_DIM_HEIGHT)
+    {
+        return;
+    }
+    run.string = string;
+    run.x = x;
+    run.y = y;
+    run.sx = sx ? sx : 1;
+    run.sy = sy ? sy : 1;
+    run.color = color;
+    run.background = background;
+    x1 = x + n * (OLED_FONT_WIDTH * run.sx + 1) - 2;
+    y1 = y + 9 * run.sy - 1;
+    x1 = x1 > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : x1;
+    y1 = y1 > OLED_DIM_HEIGHT ? OLED_DIM_HEIGHT : y1;
+    sprites.y = y;
+    sprites.color = color;
+    sprites.background = background;
+    if(resolveSprites(&sprites, string, run.sx, run.sy))
+    {
+        oledC_RenderWindow(x, y, x1, y1, renderSpriteRows, &sprites);
+    }
+    else
+    {
+        oledC_RenderWindow(x, y, x1, y1, renderGlyphRows, &run);
+    }
+}
+
+void oledC_DrawCharacterOpaque(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t ch, uint16_t color, uint16_t background)
+{
+    uint8_t string[2];
+    string[0] = ch;
+    string[1] = 0;
+    oledC_DrawStringOpaque(x, y, sx, sy, string, color, background);
 }
 
 void oledC_DrawBitmap(uint8_t x, uint8_t y, uint16_t color, uint8_t sx, uint8_t sy, uint32_t *bitmap, uint8_t bitmap_length)
@@ -338,22 +866,168 @@ void oledC_DrawBitmap(uint8_t x, uint8_t y, uint16_t color, uint8_t sx, uint8_t
     const uint8_t bitmap_width = 32;
     uint8_t rowNum;
     uint8_t bitNum;
+    uint8_t run;
+    if(!oledC_beginTransaction())
+    {
+        return;
+    }
     sx = sx == 0 ? 1 : sx;
     sy = sy == 0 ? 1 : sy;
     for(rowNum = 0; rowNum < bitmap_length; rowNum++)
     {
         uint32_t rowBits = *bitmap++;
         uint8_t curr_y = y + rowNum*sy;
-        for(bitNum = 0; bitNum < bitmap_width; bitNum++)
+        run = 0;
+        for(bitNum = 0; bitNum <= bitmap_width; bitNum++)
         {
-            if(!(rowBits & 0x01))
+            if(bitNum < bitmap_width && !(rowBits & 0x01))
             {
-                uint8_t curr_x = x + (bitmap_width - bitNum)*sx;
-                oledC_DrawRectangle(curr_x, curr_y, curr_x+sx-1, curr_y+sy-1, color);
+                run++; // clear bits are drawn; bit 0 is the rightmost column
+            }
+            else if(run)
+            {
+                uint8_t curr_x = x + (bitmap_width - bitNum + 1)*sx;
+                oledC_DrawRectangle(curr_x, curr_y, curr_x+run*sx-1, curr_y+sy-1, color);
+                run = 0;
             }
             rowBits >>= 0x000001;
         }
     }
+    oledC_endTransaction();
+}
+
+typedef struct rle_run_t
+{
+    const uint8_t *run;         // next run byte
+    const uint16_t *colors;
+    uint8_t width;
+    uint8_t sx;
+    uint8_t sy;
+    uint8_t repeat;             // output rows already made from this image row
+    uint8_t left;               // pixels left in the current run
+    uint8_t index;
+    const uint8_t *rowRun;      // decoder state where the image row began
+    uint8_t rowLeft;
+    uint8_t rowIndex;
+} rle_run_t;
+
+/* Next pixel's colour index, pulling a new run when the current one is used up */
+static uint8_t nextRLEIndex(rle_run_t *run)
+{
+    if(!run->left)
+    {
+        run->index = *run->run >> 6;
+        run->left = (*run->run++ & 0x3F) + 1;
+    }
+    run->left--;
+    return run->index;
+}
+
+/* Image rows are decoded sy times each, from the state saved at their start */
+static void renderRLERows(uint16_t *pixels, uint8_t x0, uint8_t y, uint8_t width, uint8_t rows, void *context)
+{
+    rle_run_t *run = context;
+    uint8_t col, rep, left;
+    uint16_t pixel;
+
+    while(rows--)
+    {
+        if(run->repeat == 0)
+        {
+            run->rowRun = run->run;
+            run->rowLeft = run->left;
+            run->rowIndex = run->index;
+        }
+        else
+        {
+            run->run = run->rowRun;
+            run->left = run->rowLeft;
+            run->index = run->rowIndex;
+        }
+        left = width;
+        for(col = 0; col < run->width; col++)
+        {
+            pixel = run->colors[nextRLEIndex(run)];
+            for(rep = run->sx; rep && left; rep--, left--)
+            {
+                *pixels++ = pixel;
+            }
+        }
+        if(++run->repeat == run->sy)
+        {
+            run->repeat = 0;
+        }
+    }
+}
+
+static bool startRLE(rle_run_t *run, uint8_t sx, uint8_t sy, const oledc_rle_image_t *image, const uint16_t *colors)
+{
+    if(image == NULL || image->width == 0 || image->height == 0)
+    {
+        return false;
+    }
+    run->run = image->runs;
+    run->colors = colors ? colors : image->colors;
+    run->width = image->width;
+    run->sx = sx ? sx : 1;
+    run->sy = sy ? sy : 1;
+    run->repeat = 0;
+    run->left = 0;
+    run->index = 0;
+    return true;
+}
+
+void oledC_DrawRLE(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, const oledc_rle_image_t *image, const uint16_t *colors)
+{
+    rle_run_t run;
+    uint16_t x1, y1;
+
+    if(x > OLED_DIM_WIDTH || y > OLED_DIM_HEIGHT || !startRLE(&run, sx, sy, image, colors))
+    {
+        return;
+    }
+    x1 = x + (uint16_t)image->width * run.sx - 1;
+    y1 = y + (uint16_t)image->height * run.sy - 1;
+    oledC_RenderWindow(x, y, x1 > OLED_DIM_WIDTH ? OLED_DIM_WIDTH : x1,
+                       y1 > OLED_DIM_HEIGHT ? OLED_DIM_HEIGHT : y1,
+                       renderRLERows, &run);
+}
+
+void oledC_DrawRLEMasked(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, const oledc_rle_image_t *image, const uint16_t *colors)
+{
+    rle_run_t run;
+    uint8_t row, col, start, index;
+    uint16_t left, top;
+
+    if(!startRLE(&run, sx, sy, image, colors) || !oledC_beginTransaction())
+    {
+        return;
+    }
+    for(row = 0; row < image->height; row++)
+    {
+        top = y + (uint16_t)row * run.sy;
+        for(col = 0; col < image->width && top <= OLED_DIM_HEIGHT; col = start)
+        {
+            index = nextRLEIndex(&run);
+            start = col + 1;
+            while(start < image->width && run.left)
+            {
+                run.left--; // the rest of this run, as far as the row goes
+                start++;
+            }
+            left = x + (uint16_t)col * run.sx;
+            if(index && left <= OLED_DIM_WIDTH)
+            {
+                oledC_DrawRectangle(left, top, coerceEnd(left + (uint16_t)(start - col) * run.sx - 1),
+                                    coerceEnd(top + run.sy - 1), run.colors[index]);
+            }
+        }
+        if(top > OLED_DIM_HEIGHT)
+        {
+            break;
+        }
+    }
+    oledC_endTransaction();
 }
 
 /* Standardized Shape Drawing */
@@ -446,3 +1120,28 @@ static void drawBitmap(shape_t *shape)
         shape->params.bitmap.array_length
     );
 }
+
+static void drawRLE(shape_t *shape)
+{
+    const oledc_rle_image_t *image = shape->params.rle.image;
+    uint16_t colors[4];
+    uint8_t i;
+
+    if(image == NULL || image->colorCount > 4)
+    {
+        return;
+    }
+    for(i = 0; i < image->colorCount; i++)
+    {
+        colors[i] = image->colors[i];
+    }
+    colors[1] = shape->params.rle.color;
+    oledC_DrawRLE(
+        shape->params.rle.x,
+        shape->params.rle.y,
+        shape->params.rle.sx,
+        shape->params.rle.sy,
+        image,
+        colors
+    );
+}
@@ -36,8 +36,25 @@ enum OLEDC_SHAPE
     OLED_SHAPE_CHARACTER,
     OLED_SHAPE_STRING,
     OLED_SHAPE_BITMAP,
+    OLED_SHAPE_RLE,
 };
 
+/*
+ * Run-length-encoded image: pixels row by row, each byte one run of up to
+ * 64 pixels of one of up to four table colours. Runs may carry on into the
+ * next row. tools/rle_convert.c turns one-bit bitmaps into this format.
+ */
+#define OLEDC_RLE_RUN(index, length) (uint8_t)(((index) << 6) | ((length) - 1))
+
+typedef struct oledc_rle_image_t
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t colorCount;
+    const uint16_t *colors;
+    const uint8_t *runs;
+} oledc_rle_image_t;
+
 typedef union shape_params_t 
 {
     struct 
@@ -106,17 +123,38 @@ typedef union shape_params_t
         uint32_t *bit_array;
         uint8_t array_length;
     } bitmap;
+    struct 
+    {
+        uint16_t color;     // replaces colour 1, the ink of a converted bitmap
+        uint8_t x;
+        uint8_t y;
+        uint8_t sx;
+        uint8_t sy;
+        const oledc_rle_image_t *image;
+    } rle;
 } shape_params_t;
 
+/* Panel area a shape can touch, clipped to the panel; x0 > x1 when none of it is on it */
+typedef struct oledc_box_t
+{
+    uint8_t x0;
+    uint8_t y0;
+    uint8_t x1;
+    uint8_t y1;
+} oledc_box_t;
+
 typedef struct shape 
 {
     uint8_t _type;
     void (*draw)(struct shape*);
     shape_params_t params;
     bool active;
+    oledc_box_t box;    // as of oledC_createShape or the last oledC_shapeBounds
 } shape_t;
 
 void oledC_createShape(enum OLEDC_SHAPE shape_type, shape_params_t *params, shape_t *newShape);
+/* Work out the shape's box from its params; returns whether it paints every pixel of it */
+bool oledC_shapeBounds(const shape_t *shape, oledc_box_t *box);
 
 void oledC_DrawCircle(uint8_t center_x, uint8_t center_y, uint8_t radius, uint16_t color);
 void oledC_DrawRing(uint8_t center_x, uint8_t center_y, uint8_t radius, uint8_t width, uint16_t color);
@@ -124,9 +162,20 @@ void oledC_DrawRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_
 void oledC_DrawLine(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint8_t width, uint16_t color);
 void oledC_DrawPoint(uint8_t x, uint8_t y, uint16_t color);
 uint16_t oledC_ReadPoint(uint8_t x, uint8_t y);
+/* Every pixel of the rectangle XORed with mask: cursors and inverted bars */
+void oledC_XorRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t mask);
 void oledC_DrawThickPoint(uint8_t center_x, uint8_t center_y, uint8_t width, uint16_t color);
 void oledC_DrawCharacter(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t ch, uint16_t color);
 void oledC_DrawString(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t *string, uint16_t color);
+/* Whole character cells, background included, streamed through one window per string */
+void oledC_DrawCharacterOpaque(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t ch, uint16_t color, uint16_t background);
+void oledC_DrawStringOpaque(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t *string, uint16_t color, uint16_t background);
+/* Let opaque strings use the pre-rendered sprites (default on) */
+void oledC_useGlyphSprites(bool enable);
 void oledC_DrawBitmap(uint8_t x, uint8_t y, uint16_t color, uint8_t sx, uint8_t sy, uint32_t *bit_array, uint8_t array_width);
+/* Every pixel of the image through one window; colors NULL uses the image's table */
+void oledC_DrawRLE(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, const oledc_rle_image_t *image, const uint16_t *colors);
+/* Colour 0 left as it is on the panel: a rectangle per run of the others */
+void oledC_DrawRLEMasked(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, const oledc_rle_image_t *image, const uint16_t *colors);
 
 #endif	/* OLEDC_SHAPES_H */
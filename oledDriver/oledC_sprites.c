@@ -0,0 +1,343 @@
+/*
+ * File:   oledC_sprites.c
+ *
+ * Generated by tools/glyph_sprites.c; do not edit.
+ */
+
+#include <stdint.h>
+#include "oledC_sprites.h"
+
+static const uint8_t scale1Bits[] = {
+    // '0'
+    0x70,
+    0x88,
+    0x98,
+    0xA8,
+    0xC8,
+    0x88,
+    0x70,
+    0x00,
+    // '1'
+    0x20,
+    0x60,
+    0x20,
+    0x20,
+    0x20,
+    0x20,
+    0x70,
+    0x00,
+    // '2'
+    0x70,
+    0x88,
+    0x08,
+    0x70,
+    0x80,
+    0x80,
+    0xF8,
+    0x00,
+    // '3'
+    0xF8,
+    0x08,
+    0x10,
+    0x30,
+    0x08,
+    0x88,
+    0x70,
+    0x00,
+    // '4'
+    0x10,
+    0x30,
+    0x50,
+    0x90,
+    0xF8,
+    0x10,
+    0x10,
+    0x00,
+    // '5'
+    0xF8,
+    0x80,
+    0xF0,
+    0x08,
+    0x08,
+    0x88,
+    0x70,
+    0x00,
+    // '6'
+    0x38,
+    0x40,
+    0x80,
+    0xF0,
+    0x88,
+    0x88,
+    0x70,
+    0x00,
+    // '7'
+    0xF8,
+    0x08,
+    0x08,
+    0x10,
+    0x20,
+    0x40,
+    0x80,
+    0x00,
+    // '8'
+    0x70,
+    0x88,
+    0x88,
+    0x70,
+    0x88,
+    0x88,
+    0x70,
+    0x00,
+    // '9'
+    0x70,
+    0x88,
+    0x88,
+    0x78,
+    0x08,
+    0x10,
+    0xE0,
+    0x00,
+    // ':'
+    0x00,
+    0x00,
+    0x20,
+    0x00,
+    0x20,
+    0x00,
+    0x00,
+    0x00,
+    // '/'
+    0x00,
+    0x08,
+    0x10,
+    0x20,
+    0x40,
+    0x80,
+    0x00,
+    0x00,
+    // 'A'
+    0x20,
+    0x50,
+    0x88,
+    0x88,
+    0xF8,
+    0x88,
+    0x88,
+    0x00,
+    // 'M'
+    0x88,
+    0xD8,
+    0xA8,
+    0xA8,
+    0xA8,
+    0x88,
+    0x88,
+    0x00,
+    // 'P'
+    0xF0,
+    0x88,
+    0x88,
+    0xF0,
+    0x80,
+    0x80,
+    0x80,
+    0x00,
+};
+
+static const uint8_t scale2Bits[] = {
+    // '0'
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC3, 0xC0,
+    0xC3, 0xC0,
+    0xCC, 0xC0,
+    0xCC, 0xC0,
+    0xF0, 0xC0,
+    0xF0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '1'
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x3C, 0x00,
+    0x3C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '2'
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0xFF, 0xC0,
+    0xFF, 0xC0,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '3'
+    0xFF, 0xC0,
+    0xFF, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x03, 0x00,
+    0x03, 0x00,
+    0x0F, 0x00,
+    0x0F, 0x00,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '4'
+    0x03, 0x00,
+    0x03, 0x00,
+    0x0F, 0x00,
+    0x0F, 0x00,
+    0x33, 0x00,
+    0x33, 0x00,
+    0xC3, 0x00,
+    0xC3, 0x00,
+    0xFF, 0xC0,
+    0xFF, 0xC0,
+    0x03, 0x00,
+    0x03, 0x00,
+    0x03, 0x00,
+    0x03, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '5'
+    0xFF, 0xC0,
+    0xFF, 0xC0,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0xFF, 0x00,
+    0xFF, 0x00,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '6'
+    0x0F, 0xC0,
+    0x0F, 0xC0,
+    0x30, 0x00,
+    0x30, 0x00,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0xFF, 0x00,
+    0xFF, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '7'
+    0xFF, 0xC0,
+    0xFF, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x03, 0x00,
+    0x03, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x30, 0x00,
+    0x30, 0x00,
+    0xC0, 0x00,
+    0xC0, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '8'
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // '9'
+    0x3F, 0x00,
+    0x3F, 0x00,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0xC0, 0xC0,
+    0x3F, 0xC0,
+    0x3F, 0xC0,
+    0x00, 0xC0,
+    0x00, 0xC0,
+    0x03, 0x00,
+    0x03, 0x00,
+    0xFC, 0x00,
+    0xFC, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    // ':'
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x0C, 0x00,
+    0x0C, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+    0x00, 0x00,
+};
+
+const oledc_sprite_set_t oledC_spriteSets[] = {
+    { 1, 5, 1, 8, "0123456789:/AMP", scale1Bits },
+    { 2, 10, 2, 16, "0123456789:", scale2Bits },
+};
+
+const uint8_t oledC_spriteSetCount = 2;
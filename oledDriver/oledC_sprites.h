@@ -0,0 +1,32 @@
+/*
+ * File:   oledC_sprites.h
+ *
+ * Glyphs of the 5x8 font pre-rendered at the scales the clock uses.
+ *
+ * oledC_sprites.c is generated by tools/glyph_sprites.c (make sprites);
+ * do not edit it by hand. Each set holds the characters in its string,
+ * already widened and heightened by its scale, as 1bpp rows with the most
+ * significant bit leftmost. The blank top row of the font is not stored.
+ * oledC_DrawStringOpaque() uses a set when both scales match it and every
+ * character of the string is in it.
+ */
+
+#ifndef OLEDC_SPRITES_H
+#define	OLEDC_SPRITES_H
+
+#include <stdint.h>
+
+typedef struct oledc_sprite_set_t
+{
+    uint8_t scale;
+    uint8_t width;          // 5 * scale pixels
+    uint8_t rowBytes;
+    uint8_t rows;           // 8 * scale
+    const char *chars;
+    const uint8_t *bits;    // rows * rowBytes per character, in chars order
+} oledc_sprite_set_t;
+
+extern const oledc_sprite_set_t oledC_spriteSets[];
+extern const uint8_t oledC_spriteSetCount;
+
+#endif	/* OLEDC_SPRITES_H */
@@ -104,6 +104,7 @@ void PIN_MANAGER_Initialize (void)
     RPOR7bits.RP14R = 0x0007;    //RB14->SPI1:SDO1
     RPOR7bits.RP15R = 0x0008;    //RB15->SPI1:SCK1OUT
     RPINR20bits.SDI1R = 0x000D;    //RB13->SPI1:SDI1
+    RPINR0bits.INT1R = 0x0017;    //RC7->EXT_INT:INT1
 
     __builtin_write_OSCCONL(OSCCON | 0x40); // lock PPS
 }
@@ -30,23 +30,43 @@
 
 void (*spi1_interruptHandler)(void); 
 
+/*
+ * CHSEL for the SPI1 transmit event, from the DMA channel trigger sources
+ * table of the PIC24FJ256GA705 family data sheet (DS30010118). Not yet run
+ * on hardware: a channel that never completes times out in waitChannel()
+ * and SPI1 falls back to spi1_writeBlock16() for good.
+ */
+#define DMA_TRIGGER_SPI1_TX 0x0B
+#define DMA_RAM_FIRST       0x0800  // DMAL/DMAH: all of data RAM
+#define DMA_RAM_LAST        0x47FF
+#define DMA_SPINS_PER_WORD  32      // a word is 32 Tcy on the wire at BRG 0; a spin takes more than 1
+
+static void (*volatile dmaCallback)(void);
+static volatile bool dmaActive;
+static bool dmaFailed;              // the channel timed out once: no more DMA
+static const uint16_t *dmaBlock;
+static size_t dmaCount;
+static volatile bool dmaSettling;   // channel done, last words may still be shifting in MODE16
+
 void spi1_close(void)
 {
+    spi1_dmaWait();
     SPI1CON1Lbits.SPIEN = 0;
 }
 
 //con == SPIxCONL, brg == SPIxBRGL, operation == Master/Slave
 typedef struct { uint16_t con1; uint16_t brg; uint8_t operation;} spi1_configuration_t;
 static const spi1_configuration_t spi1_configuration[] = {   
-    { 0x0120, 0x0000, 0 },
-    { 0x0120, 0x000F, 0 }
+    { 0x0121, 0x0000, 0 },
+    { 0x0121, 0x000F, 0 }
 };
 
 bool spi1_open(/*spi1_modes spiUniqueConfiguration*/)
 {
     if(!SPI1CON1Lbits.SPIEN)
     {
-        SPI1CON1L = 0x0120;//spi1_configuration[spiUniqueConfiguration].con1;
+        SPI1CON1L = 0x0121;//spi1_configuration[spiUniqueConfiguration].con1;  (master, CKE, ENHBUF)
+        SPI1CON1Hbits.IGNROV = 1; // the fast paths let the receive FIFO overflow
         SPI1BRGL = 0;//spi1_configuration[spiUniqueConfiguration].brg;
         
         TRISBbits.TRISB15 = 0;//spi1_configuration[spiUniqueConfiguration].operation;
@@ -60,7 +80,7 @@ bool spi1_open(/*spi1_modes spiUniqueConfiguration*/)
 uint8_t spi1_exchangeByte(uint8_t b)
 {
     SPI1BUFL = b;
-    while(!SPI1STATLbits.SPIRBF);
+    while(SPI1STATLbits.SPIRBE);
     return SPI1BUFL;
 }
 
@@ -84,6 +104,191 @@ void spi1_writeBlock(void *block, size_t blockSize)
     }
 }
 
+// MODE16 may only change while the module is off; nCS is a GPIO and stays put
+static void setWordMode(bool on)
+{
+    SPI1CON1Lbits.SPIEN = 0;
+    SPI1CON1Lbits.MODE16 = on;
+    SPI1CON1Lbits.SPIEN = 1;
+}
+
+// Wait for the FIFO and the shift register to empty, then drop what was received
+static void finishTransmit(void)
+{
+    while(!SPI1STATLbits.SPITBE);
+    while(!SPI1STATLbits.SRMT);
+    while(!SPI1STATLbits.SPIRBE)
+    {
+        (void) SPI1BUFL;
+    }
+    SPI1STATLbits.SPIROV = 0;
+}
+
+void spi1_writeBlockFast(const void *block, size_t blockSize)
+{
+    const uint8_t *data = block;
+    while(blockSize--)
+    {
+        while(SPI1STATLbits.SPITBF);
+        SPI1BUFL = *data++;
+    }
+    finishTransmit();
+}
+
+void spi1_writeBlock16(const uint16_t *block, size_t count)
+{
+    setWordMode(true);
+    while(count--)
+    {
+        while(SPI1STATLbits.SPITBF);
+        SPI1BUFL = *block++;
+    }
+    finishTransmit();
+    setWordMode(false);
+}
+
+void spi1_writeRepeat16(uint16_t word, size_t count)
+{
+    setWordMode(true);
+    while(count--)
+    {
+        while(SPI1STATLbits.SPITBF);
+        SPI1BUFL = word;
+    }
+    finishTransmit();
+    setWordMode(false);
+}
+
+/* After a DMA transfer, in the caller's context: drain SPI1, back to byte mode */
+static void settleDMA(void)
+{
+    if(dmaSettling)
+    {
+        dmaSettling = false;
+        finishTransmit();
+        setWordMode(false);
+    }
+}
+
+/*
+ * Wait for the running transfer, at most a few times as long as it can
+ * take. On a timeout the channel is stopped, the words it still owed
+ * (DMACNT0 counts down) go out by spi1_writeBlock16() and DMA stays off.
+ */
+static void waitChannel(void)
+{
+    uint32_t spins = (uint32_t)dmaCount * DMA_SPINS_PER_WORD + 256;
+    void (*callback)(void);
+    size_t owed;
+
+    while(dmaActive && --spins);
+    if(!dmaActive)
+    {
+        return;
+    }
+    IEC0bits.DMA0IE = 0;
+    if(!dmaActive)
+    {
+        return;                     // completed after all
+    }
+    DMACH0bits.CHEN = 0;
+    SPI1IMSKLbits.SPITBEN = 0;
+    owed = (DMACNT0 < dmaCount) ? DMACNT0 : dmaCount;
+    callback = dmaCallback;
+    dmaFailed = true;
+    dmaActive = false;
+    dmaSettling = false;
+    finishTransmit();
+    setWordMode(false);
+    spi1_writeBlock16(dmaBlock + dmaCount - owed, owed);
+    if(callback)
+    {
+        callback();
+    }
+}
+
+bool spi1_writeBlockDMA(const uint16_t *block, size_t count, void (*callback)(void))
+{
+    if(count == 0)
+    {
+        return false;
+    }
+    waitChannel();
+    if(!SPI1_USE_DMA || dmaFailed)
+    {
+        settleDMA();
+        spi1_writeBlock16(block, count);
+        if(callback)
+        {
+            callback();
+        }
+        return true;
+    }
+    dmaActive = true;
+    dmaBlock = block;
+    dmaCount = count;
+    dmaCallback = callback;
+    if(dmaSettling)
+    {
+        dmaSettling = false;        // still in MODE16: chain on behind the last words
+    }
+    else
+    {
+        setWordMode(true);
+    }
+    SPI1IMSKLbits.SPITBEN = 1;      // transmit-buffer-empty event paces the channel
+
+    DMACONbits.DMAEN = 1;
+    DMAL = DMA_RAM_FIRST;
+    DMAH = DMA_RAM_LAST;
+    DMACH0 = 0;
+    DMACH0bits.SIZE = 0;            // words
+    DMACH0bits.SAMODE = 1;          // source increments, destination fixed, one-shot
+    DMASRC0 = (uint16_t)block;
+    DMADST0 = (uint16_t)&SPI1BUFL;
+    DMACNT0 = count;
+    DMAINT0 = 0;
+    DMAINT0bits.CHSEL = DMA_TRIGGER_SPI1_TX;
+    IFS0bits.DMA0IF = 0;
+    IEC0bits.DMA0IE = 1;
+    DMACH0bits.CHEN = 1;
+    DMACH0bits.CHREQ = 1;           // first word by hand, the rest on SPI1 events
+    return true;
+}
+
+bool spi1_dmaBusy(void)
+{
+    return dmaActive;
+}
+
+void spi1_dmaWait(void)
+{
+    waitChannel();
+    settleDMA();
+}
+
+/* Last word handed to SPI1: the drain and the switch back to byte mode wait for settleDMA */
+void __attribute__((interrupt, no_auto_psv)) _DMA0Interrupt(void)
+{
+    void (*callback)(void) = dmaCallback;
+
+    IFS0bits.DMA0IF = 0;
+    if(!DMAINT0bits.DONEIF)
+    {
+        return;
+    }
+    DMAINT0bits.DONEIF = 0;
+    DMACH0bits.CHEN = 0;
+    IEC0bits.DMA0IE = 0;
+    SPI1IMSKLbits.SPITBEN = 0;
+    dmaSettling = true;
+    dmaActive = false;
+    if(callback)
+    {
+        callback();
+    }
+}
+
 void spi1_readBlock(void *block, size_t blockSize)
 {
     uint8_t *data = block;
@@ -41,6 +41,39 @@ void spi1_exchangeBlock(void *block, size_t blockSize);
 void spi1_writeBlock(void *block, size_t blockSize);
 void spi1_readBlock(void *block, size_t blockSize);
 
+/*
+ * Transmit-only fast paths. SPI1 runs with the enhanced buffer (FIFO) on;
+ * these keep the FIFO full without waiting on receive flags, drop what
+ * comes back, and return once the last bit has left the shift register.
+ * The 16-bit ones switch SPI1 to MODE16 for the transfer, one FIFO push
+ * per word, MSB first (RGB565 pixels as the SSD1351 expects them).
+ */
+void spi1_writeBlockFast(const void *block, size_t blockSize);
+void spi1_writeBlock16(const uint16_t *block, size_t count);
+void spi1_writeRepeat16(uint16_t word, size_t count);
+
+/*
+ * DMA channel 0 feeds SPI1 (MODE16) from RAM: count 16-bit words, paced
+ * by the SPI1 transmit event. Returns at once; callback (may be NULL)
+ * runs from the DMA interrupt once the last word is in the SPI1 FIFO,
+ * with bits still shifting. A call while a transfer runs first waits for
+ * it, then chains on without draining SPI1; false only for count 0.
+ * spi1_dmaWait() (spi1_close() calls it) waits for the channel, lets the
+ * last bit out and puts SPI1 back in byte mode. Nothing else may use SPI1
+ * until it has returned.
+ *
+ * Waits are bounded: a channel that does not complete in time is stopped,
+ * finished by spi1_writeBlock16() and not used again. Built with
+ * SPI1_USE_DMA 0 every transfer takes that path and returns when done.
+ */
+#ifndef SPI1_USE_DMA
+#define SPI1_USE_DMA 1
+#endif
+
+bool spi1_writeBlockDMA(const uint16_t *block, size_t count, void (*callback)(void));
+bool spi1_dmaBusy(void);
+void spi1_dmaWait(void);
+
 void spi1_writeByte(uint8_t byte);
 uint8_t spi1_readByte(void);
 
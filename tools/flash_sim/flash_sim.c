@@ -0,0 +1,165 @@
+/*
+ * File:   flash_sim.c
+ *
+ * Program flash model for the step journal on the host. Addresses are
+ * program-counter units (two per instruction) from SIM_FLASH_BASE; a row
+ * program takes the device's compressed RAM format and, like the device,
+ * can only clear bits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+#include "flash_sim.h"
+
+#define WORDS               (SIM_FLASH_PAGES * SIM_PAGE_WORDS)
+#define NVMOP_PAGE_ERASE    0x4003
+#define NVMOP_ROW_PROGRAM   0x4202
+#define NO_TEAR             0xFFFF
+
+volatile uint16_t TBLPAG, NVMADR, NVMADRU, NVMCON, NVMSRCADRL, NVMSRCADRH;
+volatile NVMCONBITS NVMCONbits;
+
+static uint16_t flash[WORDS];
+static SimFlashCounts counts;
+static uint16_t tearProgramAt = NO_TEAR;
+static uint16_t tearEraseAt = NO_TEAR;
+static void (*resetHook)(void);
+static void (*programHook)(uint32_t firstWord);
+
+/* Instruction index of a program-counter address; aborts outside the journal */
+static uint32_t wordIndex(uint32_t address)
+{
+    uint32_t index = (address - SIM_FLASH_BASE) / 2;
+
+    if (address < SIM_FLASH_BASE || (address & 1) || index >= WORDS) {
+        fprintf(stderr, "flash access at 0x%05lX outside the journal\n", (unsigned long)address);
+        exit(2);
+    }
+    return index;
+}
+
+void simFlash_format(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < WORDS; i++)
+        flash[i] = 0xFFFF;
+    simFlash_resetCounts();
+    tearProgramAt = NO_TEAR;
+    tearEraseAt = NO_TEAR;
+}
+
+uint16_t simFlash_word(uint32_t index)
+{
+    return (index < WORDS) ? flash[index] : 0xFFFF;
+}
+
+uint16_t simFlash_read(uint16_t page, uint16_t offset)
+{
+    counts.reads++;
+    return flash[wordIndex(((uint32_t)page << 16) | offset)];
+}
+
+void simFlash_tearProgram(uint16_t words)
+{
+    tearProgramAt = words;
+}
+
+void simFlash_tearErase(uint16_t words)
+{
+    tearEraseAt = words;
+}
+
+void simFlash_setResetHook(void (*hook)(void))
+{
+    resetHook = hook;
+}
+
+void simFlash_setProgramHook(void (*hook)(uint32_t firstWord))
+{
+    programHook = hook;
+}
+
+static void tear(void)
+{
+    tearProgramAt = NO_TEAR;
+    tearEraseAt = NO_TEAR;
+    resetHook();
+    fprintf(stderr, "reset hook returned\n");
+    exit(2);
+}
+
+static void erasePage(uint32_t first)
+{
+    uint16_t i;
+
+    if (first % SIM_PAGE_WORDS) {
+        fprintf(stderr, "page erase at word %lu, not a page start\n", (unsigned long)first);
+        exit(2);
+    }
+    for (i = 0; i < SIM_PAGE_WORDS; i++) {
+        if (i == tearEraseAt)
+            tear();
+        flash[first + i] = 0xFFFF;
+    }
+    counts.pagesErased++;
+}
+
+/* Instruction pair n is { LSW(2n), MSB(2n+1):MSB(2n), LSW(2n+1) } */
+static void programRow(uint32_t first, const uint16_t *rowData)
+{
+    uint16_t i, value;
+
+    if (first % SIM_ROW_WORDS) {
+        fprintf(stderr, "row program at word %lu, not a row start\n", (unsigned long)first);
+        exit(2);
+    }
+    for (i = 0; i < SIM_ROW_WORDS; i++) {
+        if (i == tearProgramAt) {
+            if (programHook)
+                programHook(first);
+            tear();
+        }
+        value = rowData[3 * (i >> 1) + ((i & 1) ? 2 : 0)];
+        if (flash[first + i] != 0xFFFF)
+            counts.overwrites++;
+        flash[first + i] &= value;
+    }
+    counts.rowsProgrammed++;
+    if (programHook)
+        programHook(first);
+}
+
+void simFlash_execute(const uint16_t *rowData)
+{
+    uint32_t first = wordIndex(((uint32_t)NVMADRU << 16) | NVMADR);
+
+    switch (NVMCON) {
+    case NVMOP_PAGE_ERASE:
+        erasePage(first);
+        break;
+    case NVMOP_ROW_PROGRAM:
+        programRow(first, rowData);
+        break;
+    default:
+        fprintf(stderr, "unexpected NVMCON 0x%04X\n", NVMCON);
+        exit(2);
+    }
+    NVMCONbits.WR = 0;
+}
+
+void simFlash_getCounts(SimFlashCounts *out)
+{
+    *out = counts;
+}
+
+void simFlash_resetCounts(void)
+{
+    counts.reads = 0;
+    counts.rowsProgrammed = 0;
+    counts.pagesErased = 0;
+    counts.overwrites = 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * File:   flash_sim.h
+ *
+ * Program flash model behind tools/flash_sim/include/xc.h: the journal
+ * pages as 16-bit instruction words, page erase and compressed-format row
+ * program through NVMCON, and faults for the harness to inject.
+ */
+
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t reads;
+    uint32_t rowsProgrammed;
+    uint32_t pagesErased;
+    uint32_t overwrites;     // words programmed that were not erased
+} SimFlashCounts;
+
+/* Every word erased, counts cleared, no fault armed */
+void simFlash_format(void);
+
+/* Word of the journal area by instruction index; 0xFFFF when erased */
+uint16_t simFlash_word(uint32_t index);
+
+/*
+ * Arm a reset inside the next row program (after words of its 128) or the
+ * next page erase (after words of its 1024). The model stops there and
+ * calls the reset hook, which must not return (longjmp).
+ */
+void simFlash_tearProgram(uint16_t words);
+void simFlash_tearErase(uint16_t words);
+void simFlash_setResetHook(void (*hook)(void));
+
+/* Called after each row program, torn or not, with its first word index */
+void simFlash_setProgramHook(void (*hook)(uint32_t firstWord));
+
+void simFlash_getCounts(SimFlashCounts *counts);
+void simFlash_resetCounts(void);
+
+#endif // FLASH_SIM_H
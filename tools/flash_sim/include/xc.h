@@ -0,0 +1,45 @@
+/*
+ * File:   xc.h
+ *
+ * Host stand-in for the device header, for Pedometer/step_journal.c: the
+ * table-read and NVM registers and builtins it uses, backed by the program
+ * flash model in flash_sim.c. Only the journal pages exist; each
+ * instruction keeps the low 16 bits tblrdl returns.
+ *
+ * The RAM source of a row program is a 16-bit address on the device and
+ * cannot carry a host pointer, so __builtin_write_NVM() hands the model
+ * the journal's row buffer by name.
+ */
+
+#ifndef XC_H
+#define XC_H
+
+#include <stdint.h>
+
+#define SIM_FLASH_BASE      0x22800UL   // JOURNAL_BASE
+#define SIM_FLASH_PAGES     16
+#define SIM_PAGE_WORDS      1024
+#define SIM_ROW_WORDS       128
+
+// The section attributes of the journal area mean nothing on the host
+#define space(x)            unused
+#define address(x)          aligned(2)
+#define noload              used
+
+typedef struct
+{
+    unsigned WREN:1, WR:1;      // NVMCON itself is a separate variable here
+} NVMCONBITS;
+
+extern volatile uint16_t TBLPAG, NVMADR, NVMADRU, NVMCON, NVMSRCADRL, NVMSRCADRH;
+extern volatile NVMCONBITS NVMCONbits;
+
+uint16_t simFlash_read(uint16_t page, uint16_t offset);
+void simFlash_execute(const uint16_t *rowData);
+
+#define __builtin_tblrdl(offset)    simFlash_read(TBLPAG, (offset))
+#define __builtin_tblpage(p)        ((uint16_t)(SIM_FLASH_BASE >> 16))
+#define __builtin_tbloffset(p)      ((uint16_t)(SIM_FLASH_BASE & 0xFFFF))
+#define __builtin_write_NVM()       simFlash_execute(rowBuf)
+
+#endif // XC_H
@@ -0,0 +1,244 @@
+/*
+ * File:   journal_check.c
+ *
+ * Host check of Pedometer/step_journal against the flash model in
+ * flash_sim.c, across hundreds of simulated power cycles:
+ *
+ *   make journal-check
+ *
+ * Each boot clears RAM as the C startup does, mounts, and requires every
+ * chunk of the step history to read back as the newest copy of it that
+ * was ever completely programmed (the ledger, kept from the rows as they
+ * are written). Then it runs a session of step seconds and ends it with
+ * one of the resets below. The run wraps the log many times, so page
+ * reuse and the carry-forward of still-live chunks are always in play.
+ *
+ *   plain      power lost at a random second
+ *   pending    power lost while a page waits for its idle-time erase
+ *   torn row   power lost part-way through a row program
+ *   torn erase power lost part-way through a page erase
+ *   synced     stepJournal_sync() first, as before a power-down
+ *
+ * Mount work is reported as flash words read and records CRC-checked per
+ * boot; there is no device clock here to fill in mountMs.
+ *
+ * The journal source is included rather than linked so the harness can
+ * clear its RAM and see when an erase is pending. Exit status is non-zero
+ * on the first mismatch or on any word programmed twice without an erase.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <setjmp.h>
+#include "flash_sim.h"
+// NVMSRCADRL takes the 16-bit RAM address of the row buffer; the model gets the buffer itself
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"
+#include "../../Pedometer/step_journal.c"
+#include "../../Pedometer/step_index.h"
+
+#define DEFAULT_BOOTS       600
+#define SESSION_SECONDS     20000UL     // longest session before its reset
+#define PENDING_LIMIT       200000UL    // give up waiting for a pending erase
+#define IDLE_ONE_IN         4           // main loop passes that reach stepJournal_idle()
+
+enum { RESET_PLAIN, RESET_PENDING, RESET_TORN_ROW, RESET_TORN_ERASE, RESET_SYNCED, RESET_KINDS };
+
+static const char *const resetNames[RESET_KINDS] = { "plain", "pending", "torn row", "torn erase", "synced" };
+
+static jmp_buf powerFail;
+static uint8_t ledger[STEP_CHUNK_COUNT][STEP_CHUNK_BYTES];
+static bool ledgerHas[STEP_CHUNK_COUNT];
+static unsigned long resets[RESET_KINDS];
+static unsigned long erasesPendingAtReset;
+static unsigned long chunksChecked;
+static unsigned long mountReads, mountReadsMax, mountChecks, mountChecksMax;
+static uint32_t clock;          // simulated seconds since the first boot
+
+static uint32_t rng = 12345;
+
+static uint32_t nextRandom(uint32_t range)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return (rng >> 16) % range;
+}
+
+static uint32_t noClock(void)
+{
+    return 0;
+}
+
+static void powerLost(void)
+{
+    longjmp(powerFail, 1);
+}
+
+/* Every record of a row that is completely programmed and checks out becomes the newest copy of its chunk */
+static void rowProgrammed(uint32_t firstWord)
+{
+    uint16_t w[RECORD_WORDS];
+    uint8_t record, i;
+
+    for (record = 0; record < RECORDS_PER_ROW; record++) {
+        for (i = 0; i < RECORD_WORDS; i++)
+            w[i] = simFlash_word(firstWord + record * RECORD_WORDS + i);
+        if (w[1] >= STEP_CHUNK_COUNT || crc16(w, RECORD_WORDS - 1) != w[RECORD_WORDS - 1])
+            continue;
+        for (i = 0; i < STEP_CHUNK_BYTES / 2; i++) {
+            ledger[w[1]][2 * i] = (uint8_t)w[2 + i];
+            ledger[w[1]][2 * i + 1] = (uint8_t)(w[2 + i] >> 8);
+        }
+        ledgerHas[w[1]] = true;
+    }
+}
+
+/* Reset: RAM is zeroed by the C startup, then main() mounts */
+static void powerOn(void)
+{
+    SimFlashCounts before, after;
+
+    memset(&journal, 0, sizeof(journal));
+    memset(latestPage, 0, sizeof(latestPage));
+    memset(rowBuf, 0, sizeof(rowBuf));
+    memset(&stats, 0, sizeof(stats));
+    stepHistory_init();
+    simFlash_getCounts(&before);
+    stepJournal_mount(noClock);
+    simFlash_getCounts(&after);
+
+    mountReads += after.reads - before.reads;
+    if (after.reads - before.reads > mountReadsMax)
+        mountReadsMax = after.reads - before.reads;
+    mountChecks += stats.recordsChecked;
+    if (stats.recordsChecked > mountChecksMax)
+        mountChecksMax = stats.recordsChecked;
+}
+
+static bool checkRestored(int boot)
+{
+    uint8_t chunk[STEP_CHUNK_BYTES];
+    StepHistoryReader rd;
+    StepAggregate agg;
+    uint32_t sum;
+    uint16_t c, held, age;
+    int tier;
+
+    for (c = 0; c < STEP_CHUNK_COUNT; c++) {
+        if (!ledgerHas[c])
+            continue;
+        stepHistory_readChunk(c, chunk);
+        chunksChecked++;
+        if (memcmp(chunk, ledger[c], STEP_CHUNK_BYTES) != 0) {
+            printf("boot %d: chunk %u restored differs from its newest programmed copy\n", boot, c);
+            return false;
+        }
+    }
+    for (tier = STEP_TIER_MINUTE; tier < STEP_TIER_COUNT; tier++) {
+        held = stepHistory_count((StepTier)tier);
+        if (held == 0)
+            continue;
+        sum = 0;
+        stepHistory_openReader(&rd, (StepTier)tier, held - 1);
+        for (age = 0; age < held; age++)
+            sum += stepHistory_readNext(&rd);
+        if (!stepIndex_query((StepTier)tier, 0, held - 1, &agg) || agg.sum != sum || agg.count != held) {
+            printf("boot %d: tier %d index disagrees with its blocks after mount\n", boot, tier);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* One second of the main loop; walking bouts by day, quiet nights */
+static void second(uint32_t t, bool idle)
+{
+    uint32_t hour = (t / 3600) % 24;
+
+    if (hour >= 7 && hour < 23 && (t / 600) % 5 == 0)
+        stepHistory_addSteps((uint16_t)(1 + nextRandom(2)));
+    else if (nextRandom(20) == 0)
+        stepHistory_addSteps(1);
+    stepHistory_tick();
+    stepJournal_tick();
+    if (idle && nextRandom(IDLE_ONE_IN) == 0)
+        stepJournal_idle();
+}
+
+static void runSession(int kind)
+{
+    uint32_t seconds = 1 + nextRandom(SESSION_SECONDS);
+    uint32_t s;
+
+    for (s = 0; s < seconds; s++)
+        second(clock++, kind != RESET_PENDING);
+
+    switch (kind) {
+    case RESET_PENDING:
+        for (s = 0; s < PENDING_LIMIT && journal.erasePage == NO_PAGE; s++)
+            second(clock++, false);
+        break;
+    case RESET_TORN_ROW:
+        simFlash_tearProgram((uint16_t)nextRandom(SIM_ROW_WORDS));
+        stepJournal_sync();
+        break;
+    case RESET_TORN_ERASE:
+        simFlash_tearErase((uint16_t)nextRandom(SIM_PAGE_WORDS));
+        for (s = 0; s < PENDING_LIMIT; s++)
+            second(clock++, true);
+        break;
+    case RESET_SYNCED:
+        stepJournal_sync();
+        break;
+    default:
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int boots = (argc > 1) ? atoi(argv[1]) : DEFAULT_BOOTS;
+    SimFlashCounts counts;
+    volatile int kind;          // survives the longjmp out of a torn NVM operation
+    int boot;
+
+    simFlash_format();
+    simFlash_setResetHook(powerLost);
+    simFlash_setProgramHook(rowProgrammed);
+
+    for (boot = 0; boot <= boots; boot++) {
+        powerOn();
+        if (!checkRestored(boot)) {
+            printf("FAILED\n");
+            return 1;
+        }
+        if (boot == boots)
+            break;
+        kind = (boot == 0) ? RESET_PLAIN : (int)nextRandom(RESET_KINDS);
+        if (setjmp(powerFail) == 0)
+            runSession(kind);
+        simFlash_tearProgram(0xFFFF);
+        simFlash_tearErase(0xFFFF);
+        if (journal.erasePage != NO_PAGE)
+            erasesPendingAtReset++;
+        resets[kind]++;
+    }
+
+    simFlash_getCounts(&counts);
+    printf("%d boots over %lu simulated days, %lu chunk restores checked\n",
+           boots, (unsigned long)(clock / 86400), chunksChecked);
+    for (kind = 0; kind < RESET_KINDS; kind++)
+        printf("  %-10s resets %lu\n", resetNames[kind], resets[kind]);
+    printf("  resets with an erase pending %lu\n", erasesPendingAtReset);
+    printf("mount: flash words read %lu on average, %lu at most; records CRC-checked %lu, %lu\n",
+           mountReads / (boots + 1), mountReadsMax, mountChecks / (boots + 1), mountChecksMax);
+    printf("rows programmed %lu, pages erased %lu (%lu laps of the log)\n",
+           (unsigned long)counts.rowsProgrammed, (unsigned long)counts.pagesErased,
+           (unsigned long)counts.pagesErased / SIM_FLASH_PAGES);
+    if (counts.overwrites) {
+        printf("FAILED: %lu words programmed without an erase\n", (unsigned long)counts.overwrites);
+        return 1;
+    }
+    return 0;
+}
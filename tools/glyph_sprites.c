@@ -0,0 +1,106 @@
+/*
+ * File:   glyph_sprites.c
+ *
+ * Build step for oledDriver/oledC_sprites.c: renders the clock's glyphs at
+ * the scales it draws them and writes them out as const 1bpp sprites.
+ *
+ *   cc -O2 -o glyph_sprites tools/glyph_sprites.c
+ *   ./glyph_sprites > oledDriver/oledC_sprites.c
+ *
+ * or "make sprites" from the project directory. Edit the table below to
+ * change which characters are baked in; each sprite costs
+ * 8 * scale * ceil(5 * scale / 8) bytes of flash.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../oledDriver/oledC_font.h"
+
+#define FONT_WIDTH  5
+#define FONT_HEIGHT 8
+
+typedef struct
+{
+    unsigned scale;
+    const char *chars;
+} sprite_set_spec_t;
+
+// Scale 2: hh:mm:ss on the watch face; scale 1: menu clock, AM/PM and date
+static const sprite_set_spec_t specs[] = {
+    { 1, "0123456789:/AMP" },
+    { 2, "0123456789:" },
+};
+
+#define SET_COUNT (sizeof(specs) / sizeof(specs[0]))
+
+static void printChar(char ch)
+{
+    printf(ch == '\'' || ch == '\\' ? "'\\%c'" : "'%c'", ch);
+}
+
+static void writeSet(unsigned set)
+{
+    const sprite_set_spec_t *spec = &specs[set];
+    unsigned width = FONT_WIDTH * spec->scale;
+    unsigned rowBytes = (width + 7) / 8;
+    unsigned rows = FONT_HEIGHT * spec->scale;
+    unsigned i, r, c, b;
+    uint8_t row[8];
+
+    printf("static const uint8_t scale%uBits[] = {\n", spec->scale);
+    for(i = 0; spec->chars[i]; i++)
+    {
+        const uint8_t *f = &font[(spec->chars[i] - ' ') * FONT_WIDTH];
+
+        printf("    // ");
+        printChar(spec->chars[i]);
+        printf("\n");
+        for(r = 0; r < rows; r++)
+        {
+            memset(row, 0, sizeof(row));
+            for(c = 0; c < width; c++)
+            {
+                if(f[c / spec->scale] & (0x80 >> (r / spec->scale)))
+                {
+                    row[c / 8] |= 0x80 >> (c % 8);
+                }
+            }
+            printf("   ");
+            for(b = 0; b < rowBytes; b++)
+            {
+                printf(" 0x%02X,", row[b]);
+            }
+            printf("\n");
+        }
+    }
+    printf("};\n\n");
+}
+
+int main(void)
+{
+    unsigned set;
+
+    printf("/*\n"
+           " * File:   oledC_sprites.c\n"
+           " *\n"
+           " * Generated by tools/glyph_sprites.c; do not edit.\n"
+           " */\n\n"
+           "#include <stdint.h>\n"
+           "#include \"oledC_sprites.h\"\n\n");
+    for(set = 0; set < SET_COUNT; set++)
+    {
+        writeSet(set);
+    }
+    printf("const oledc_sprite_set_t oledC_spriteSets[] = {\n");
+    for(set = 0; set < SET_COUNT; set++)
+    {
+        unsigned width = FONT_WIDTH * specs[set].scale;
+        printf("    { %u, %u, %u, %u, \"%s\", scale%uBits },\n",
+               specs[set].scale, width, (width + 7) / 8,
+               FONT_HEIGHT * specs[set].scale, specs[set].chars, specs[set].scale);
+    }
+    printf("};\n\n"
+           "const uint8_t oledC_spriteSetCount = %u;\n", (unsigned)SET_COUNT);
+    return 0;
+}
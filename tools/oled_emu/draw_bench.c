@@ -0,0 +1,212 @@
+/*
+ * File:   draw_bench.c
+ *
+ * Bus cost of the drawing paths that replaced older ones, measured side
+ * by side in the SSD1351 model:
+ *
+ *   make draw-bench
+ *
+ *   clock      one hh/mm/ss update at scale 2 drawn as clear + transparent
+ *              text, as opaque cells scaled from the font, or as opaque
+ *              cells copied from the sprite table (the same bytes as the
+ *              font; the sprites save CPU time, not bus time)
+ *   shapes     filled circles and a ring drawn by the span rasterisers and
+ *              by the point-per-pixel loops they replaced (kept here as
+ *              the baseline)
+ *
+ * Bytes and windows decide the bus time, which is given at the SPI1 clock
+ * spi1_open() sets up. The byte-at-a-time against FIFO fill throughput is
+ * CPU time, not bus bytes; the firmware measures it on the board when
+ * built with BUS_BENCHMARK.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../oledDriver/oledC.h"
+#include "../../oledDriver/oledC_shapes.h"
+#include "../../oledDriver/oledC_framebuffer.h"
+#include "../../oledDriver/oledC_colors.h"
+#include "ssd1351.h"
+
+#define FCY             4000000UL
+#define SPI1_BRG        0           // spi1_open(): SCK = FCY / (2 * (BRG + 1))
+#define SPI_HZ          (FCY / (2 * (SPI1_BRG + 1)))
+#define CLOCK_UPDATES   20
+#define CLOCK_Y         30
+
+enum { CLOCK_CLEAR_DRAW, CLOCK_OPAQUE_FONT, CLOCK_OPAQUE_SPRITES, CLOCK_PATHS };
+
+static const char *const clockNames[CLOCK_PATHS] = { "clear+draw", "opaque font", "opaque sprites" };
+
+enum { SHAPE_CIRCLE_SMALL, SHAPE_CIRCLE_LARGE, SHAPE_RING, SHAPE_COUNT };
+
+static const char *const shapeNames[SHAPE_COUNT] = { "circle r10", "circle r40", "ring r30 w6" };
+
+static void pointCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint16_t color)
+{
+    int8_t xCurr = radius + 1, yMax = 0, y = 0, x;
+    int16_t d = 0;
+
+    while(xCurr >= yMax)
+    {
+        d += 2 * yMax + 1;
+        yMax++;
+        if(d >= 0)
+        {
+            for(; y < yMax; y++)
+            {
+                for(x = y; x < xCurr; x++)
+                {
+                    oledC_DrawPoint(x0 + x, y0 + y, color);
+                    oledC_DrawPoint(x0 + x, y0 - y, color);
+                    oledC_DrawPoint(x0 - x, y0 + y, color);
+                    oledC_DrawPoint(x0 - x, y0 - y, color);
+                    oledC_DrawPoint(x0 + y, y0 + x, color);
+                    oledC_DrawPoint(x0 + y, y0 - x, color);
+                    oledC_DrawPoint(x0 - y, y0 + x, color);
+                    oledC_DrawPoint(x0 - y, y0 - x, color);
+                }
+            }
+            d += -2 * xCurr + 1;
+            xCurr--;
+        }
+    }
+}
+
+static void pointRing(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t width, uint16_t color)
+{
+    int8_t x, y;
+    int16_t d;
+
+    radius += width >> 1;
+    while(width-- > 0)
+    {
+        x = radius;
+        y = 0;
+        d = 0;
+        while(x >= y)
+        {
+            oledC_DrawPoint(x0 + x, y0 + y, color);
+            oledC_DrawPoint(x0 + x, y0 - y, color);
+            oledC_DrawPoint(x0 - x, y0 + y, color);
+            oledC_DrawPoint(x0 - x, y0 - y, color);
+            oledC_DrawPoint(x0 + y, y0 + x, color);
+            oledC_DrawPoint(x0 + y, y0 - x, color);
+            oledC_DrawPoint(x0 - y, y0 + x, color);
+            oledC_DrawPoint(x0 - y, y0 - x, color);
+            d += 2 * y + 1;
+            y++;
+            if(d >= 0)
+            {
+                d += -2 * x + 1;
+                x--;
+            }
+        }
+        radius--;
+    }
+}
+
+static void clearPanel(void)
+{
+    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
+    oledC_flush();
+    ssd1351_resetCounts();
+}
+
+static void drawClock(uint8_t path)
+{
+    static const uint8_t x[3] = { 0, 36, 72 };
+    char str[3];
+    uint8_t update, field;
+
+    oledC_useGlyphSprites(path == CLOCK_OPAQUE_SPRITES);
+    for(update = 0; update < CLOCK_UPDATES; update++)
+    {
+        for(field = 0; field < 3; field++)
+        {
+            snprintf(str, sizeof(str), "%02u", (unsigned)((update * 7 + field * 13) % 60));
+            if(path == CLOCK_CLEAR_DRAW)
+            {
+                oledC_DrawRectangle(x[field], CLOCK_Y, x[field] + 20, CLOCK_Y + 17, OLEDC_COLOR_BLACK);
+                oledC_DrawString(x[field], CLOCK_Y, 2, 2, (uint8_t *)str, OLEDC_COLOR_WHITE);
+            }
+            else
+            {
+                oledC_DrawStringOpaque(x[field], CLOCK_Y, 2, 2, (uint8_t *)str,
+                                       OLEDC_COLOR_WHITE, OLEDC_COLOR_BLACK);
+            }
+        }
+        oledC_flush();
+    }
+    oledC_useGlyphSprites(true);
+}
+
+static void drawShape(uint8_t shape, bool points)
+{
+    oledC_beginTransaction();
+    switch(shape)
+    {
+        case SHAPE_CIRCLE_SMALL:
+            if(points)
+                pointCircle(48, 48, 10, OLEDC_COLOR_WHITE);
+            else
+                oledC_DrawCircle(48, 48, 10, OLEDC_COLOR_WHITE);
+            break;
+        case SHAPE_CIRCLE_LARGE:
+            if(points)
+                pointCircle(48, 48, 40, OLEDC_COLOR_WHITE);
+            else
+                oledC_DrawCircle(48, 48, 40, OLEDC_COLOR_WHITE);
+            break;
+        default:
+            if(points)
+                pointRing(48, 48, 30, 6, OLEDC_COLOR_WHITE);
+            else
+                oledC_DrawRing(48, 48, 30, 6, OLEDC_COLOR_WHITE);
+            break;
+    }
+    oledC_endTransaction();
+    oledC_flush();
+}
+
+static void row(const char *group, const char *name, unsigned long per)
+{
+    ssd1351_counts_t counts;
+
+    ssd1351_getCounts(&counts);
+    printf("%-8s %-16s %8lu %8lu %10lu\n", group, name,
+           (unsigned long)counts.bytes / per, (unsigned long)counts.windows / per,
+           (unsigned long)(counts.bytes * 8ULL * 1000000ULL / SPI_HZ / per));
+}
+
+int main(void)
+{
+    char name[24];
+    uint8_t i;
+
+    ssd1351_reset();
+    oledC_setup();
+    printf("SPI1 at %lu Hz\n", (unsigned long)SPI_HZ);
+    printf("%-8s %-16s %8s %8s %10s\n", "group", "path", "bytes", "windows", "bus us");
+
+    for(i = 0; i < CLOCK_PATHS; i++)
+    {
+        clearPanel();
+        drawClock(i);
+        row("clock", clockNames[i], CLOCK_UPDATES);
+    }
+
+    for(i = 0; i < SHAPE_COUNT; i++)
+    {
+        clearPanel();
+        drawShape(i, true);
+        snprintf(name, sizeof(name), "%s pts", shapeNames[i]);
+        row("shapes", name, 1);
+        clearPanel();
+        drawShape(i, false);
+        snprintf(name, sizeof(name), "%s spans", shapeNames[i]);
+        row("shapes", name, 1);
+    }
+    return 0;
+}
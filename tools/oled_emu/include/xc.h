@@ -0,0 +1,52 @@
+/*
+ * File:   xc.h
+ *
+ * Host stand-in for the device header: the port latches the OLED driver
+ * writes, which spi1_host.c reads DC and nCS back from, and the button,
+ * LED and Timer1 registers main.c touches (defined by screen_bench.c).
+ */
+
+#ifndef XC_H
+#define XC_H
+
+typedef struct
+{
+    unsigned LATA0:1, LATA1:1, LATA2:1, LATA3:1, LATA4:1, LATA5:1, LATA6:1, LATA7:1;
+    unsigned LATA8:1, LATA9:1, LATA10:1, LATA11:1, LATA12:1, LATA13:1, LATA14:1, LATA15:1;
+} LATABITS;
+
+typedef struct
+{
+    unsigned LATC0:1, LATC1:1, LATC2:1, LATC3:1, LATC4:1, LATC5:1, LATC6:1, LATC7:1;
+    unsigned LATC8:1, LATC9:1, LATC10:1, LATC11:1, LATC12:1, LATC13:1, LATC14:1, LATC15:1;
+} LATCBITS;
+
+typedef struct
+{
+    unsigned TRISA8:1, TRISA9:1;
+} TRISABITS;
+
+typedef struct
+{
+    unsigned TCKPS:2, TON:1;
+} T1CONBITS;
+
+typedef struct
+{
+    unsigned T1IF:1;
+} IFS0BITS;
+
+typedef struct
+{
+    unsigned T1IE:1;
+} IEC0BITS;
+
+extern volatile LATABITS LATAbits;
+extern volatile LATCBITS LATCbits;
+extern volatile TRISABITS TRISAbits;
+extern volatile T1CONBITS T1CONbits;
+extern volatile IFS0BITS IFS0bits;
+extern volatile IEC0BITS IEC0bits;
+extern volatile unsigned int PORTA, T1CON, TMR1, PR1;
+
+#endif // XC_H
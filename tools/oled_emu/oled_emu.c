@@ -0,0 +1,299 @@
+/*
+ * File:   oled_emu.c
+ *
+ * Runs the OLED driver on the host against the SSD1351 model and reports
+ * what each frame cost on the bus, with a hash of the image it left.
+ *
+ *   make emu
+ *   build/tools/oled_emu [-o dir]
+ *
+ * or by hand, from the project directory:
+ *
+ *   cc -O2 -DOLEDC_SHADOW_PIXELS=2880 -Itools/oled_emu/include -o oled_emu \
+ *      tools/oled_emu/oled_emu.c tools/oled_emu/ssd1351.c tools/oled_emu/spi1_host.c \
+ *      oledDriver/oledC*.c
+ *
+ * -o writes each frame as dir/frame_NN.ppm. Add -DOLEDC_FRAMEBUFFER_BPP=2
+ * to the compile to see the same frames through the shadow framebuffer.
+ * The hashes change only when what the panel shows changes, so two runs
+ * can be diffed to catch rendering regressions. The driver's own byte
+ * count (oledC_getBusStats) is checked against the model's.
+ *
+ * Then two menu rows are shadowed (oledC_shadowRegion) and XOR-highlighted
+ * step by step. Each step checks the pixels the model was asked for, the
+ * driver's hits and misses, and that exactly the rectangle changed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../oledDriver/oledC.h"
+#include "../../oledDriver/oledC_shapes.h"
+#include "../../oledDriver/oledC_framebuffer.h"
+#include "../../oledDriver/oledC_compositor.h"
+#include "../../oledDriver/oledC_colors.h"
+#include "../../oledDriver/oledC_shadow.h"
+#include "ssd1351.h"
+
+typedef struct
+{
+    const char *name;
+    void (*draw)(void);
+} scene_t;
+
+static void clearScreen(void)
+{
+    oledC_DrawRectangle(0, 0, 95, 95, OLEDC_COLOR_BLACK);
+}
+
+static void drawShapes(void)
+{
+    oledC_DrawCircle(24, 24, 16, OLEDC_COLOR_RED);
+    oledC_DrawRing(70, 24, 14, 4, OLEDC_COLOR_GREEN);
+    oledC_DrawLine(4, 90, 91, 50, 3, OLEDC_COLOR_BLUE);
+    oledC_DrawRectangle(40, 60, 56, 76, OLEDC_COLOR_YELLOW);
+}
+
+static void drawText(void)
+{
+    oledC_DrawStringOpaque(4, 4, 2, 2, (uint8_t *)"12:34", OLEDC_COLOR_WHITE, OLEDC_COLOR_BLACK);
+    oledC_DrawString(4, 30, 1, 1, (uint8_t *)"Pedometer", OLEDC_COLOR_WHITE);
+}
+
+static const char *const menuItems[] = { "Pedometer", "12H/24H", "Set Time", "Exit" };
+
+#define MENU_ITEMS  (sizeof(menuItems) / sizeof(menuItems[0]))
+
+static void composeMenu(uint8_t selected)
+{
+    uint8_t i;
+
+    oledC_frameBegin(OLEDC_COLOR_BLACK);
+    for(i = 0; i < MENU_ITEMS; i++)
+    {
+        oledC_frameBox(0, 15 + i * 15, 95, 14 + (i + 1) * 15,
+                       i == selected ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+        oledC_frameText(1, 15 + i * 15, 1, menuItems[i],
+                        i == selected ? OLEDC_COLOR_BLACK : OLEDC_COLOR_WHITE);
+    }
+    oledC_frameEnd();
+}
+
+static void menuFirst(void)
+{
+    oledC_frameInvalidate();
+    composeMenu(0);
+}
+
+static void menuMove(void)
+{
+    composeMenu(1);
+}
+
+static void scrollUp(void)
+{
+    oledC_scrollRows(8, NULL, NULL);
+}
+
+static const scene_t scenes[] = {
+    { "clear",      clearScreen },
+    { "shapes",     drawShapes },
+    { "text",       drawText },
+    { "menu",       menuFirst },
+    { "menu move",  menuMove },
+    { "scroll 8",   scrollUp },
+};
+
+#define SCENE_COUNT (sizeof(scenes) / sizeof(scenes[0]))
+
+#define ROW_PIXELS  (96 * 15)
+#define XOR_MASK    0xFFFF
+#if OLEDC_FRAMEBUFFER_BPP
+#define PANEL_READ  0           // the framebuffer answers every read
+#else
+#define PANEL_READ  1
+#endif
+
+typedef struct
+{
+    const char *name;
+    void (*prepare)(void);      // not counted
+    uint8_t x0, y0, x1, y1;     // rectangle XORed, inclusive
+    uint32_t pixelsRead;        // expected from the model
+    uint32_t hits, misses;      // expected from oledC_getReadStats
+} readback_t;
+
+/* The same menu drawn with plain calls, which the framebuffer sees as well */
+static void drawMenu(void)
+{
+    uint8_t i;
+
+    clearScreen();
+    for(i = 0; i < MENU_ITEMS; i++)
+    {
+        oledC_DrawRectangle(0, 15 + i * 15, 95, 14 + (i + 1) * 15, i ? OLEDC_COLOR_BLACK : OLEDC_COLOR_WHITE);
+        oledC_DrawString(1, 15 + i * 15, 1, 1, (uint8_t *)menuItems[i], i ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+    }
+}
+
+static void textInRow(void)
+{
+    oledC_DrawStringOpaque(1, 30, 1, 1, (uint8_t *)"Set Time", OLEDC_COLOR_WHITE, OLEDC_COLOR_BLACK);
+}
+
+static void scrollDown(void)
+{
+    oledC_scrollRows(-8, NULL, NULL);
+}
+
+static const readback_t readbacks[] = {
+    // First read of a region loads all of it from the panel
+    { "load",     NULL,       0, 30, 95, 44, ROW_PIXELS * PANEL_READ, ROW_PIXELS, ROW_PIXELS * PANEL_READ },
+    // Then it is RAM only, and the XOR takes the highlight off again
+    { "again",    NULL,       0, 30, 95, 44, 0, ROW_PIXELS, 0 },
+    // Drawing into a loaded region writes through
+    { "write",    textInRow,  0, 30, 95, 44, 0, ROW_PIXELS, 0 },
+    // A scroll moves the picture under the regions; they load again
+    { "scroll",   scrollDown, 0, 45, 95, 59, ROW_PIXELS * PANEL_READ, ROW_PIXELS, ROW_PIXELS * PANEL_READ },
+    // Outside every region a read goes to the panel
+    { "outside",  NULL,       5, 5, 5, 5, PANEL_READ, 1 - PANEL_READ, PANEL_READ },
+};
+
+#define READBACK_COUNT (sizeof(readbacks) / sizeof(readbacks[0]))
+
+/* Pixels that are not before XOR the mask inside the rectangle, or not before outside it */
+static unsigned xorErrors(const readback_t *r, uint16_t before[SSD1351_PANEL][SSD1351_PANEL])
+{
+    static uint16_t after[SSD1351_PANEL][SSD1351_PANEL];
+    unsigned errors = 0;
+    int x, y;
+    bool inside;
+
+    ssd1351_panel(after);
+    for(y = 0; y < SSD1351_PANEL; y++)
+    {
+        for(x = 0; x < SSD1351_PANEL; x++)
+        {
+            inside = x >= r->x0 && x <= r->x1 && y >= r->y0 && y <= r->y1;
+            if(after[y][x] != (inside ? before[y][x] ^ XOR_MASK : before[y][x]))
+            {
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+static int checkReadBack(void)
+{
+    static uint16_t before[SSD1351_PANEL][SSD1351_PANEL];
+    const readback_t *r;
+    ssd1351_counts_t counts;
+    oledc_read_stats_t reads;
+    unsigned i, errors;
+    int failed = 0;
+
+    oledC_shadowClear();
+#if OLEDC_FRAMEBUFFER_BPP
+    // The scenes filled the palette; the XOR has to land on exact colours
+    oledC_setPaletteColor(0, OLEDC_COLOR_BLACK);
+    oledC_setPaletteColor(1, OLEDC_COLOR_WHITE);
+#endif
+    drawMenu();
+    oledC_flush();
+    if(!oledC_shadowRegion(0, 30, 95, 44) || !oledC_shadowRegion(0, 45, 95, 59))
+    {
+        printf("\nread-back: built without OLEDC_SHADOW_PIXELS, not checked\n");
+        return 0;
+    }
+    printf("\n%-10s %8s %8s %8s  %s\n", "read-back", "read", "hits", "misses", "image");
+    for(i = 0; i < READBACK_COUNT; i++)
+    {
+        r = &readbacks[i];
+        if(r->prepare)
+        {
+            r->prepare();
+            oledC_flush();
+        }
+        ssd1351_panel(before);
+        ssd1351_resetCounts();
+        oledC_resetReadStats();
+        oledC_XorRectangle(r->x0, r->y0, r->x1, r->y1, XOR_MASK);
+        oledC_flush();
+        ssd1351_getCounts(&counts);
+        oledC_getReadStats(&reads);
+        errors = xorErrors(r, before);
+        printf("%-10s %8lu %8lu %8lu  %s\n", r->name, (unsigned long)counts.pixelsRead,
+               (unsigned long)reads.hits, (unsigned long)reads.misses, errors ? "WRONG" : "ok");
+        if(counts.pixelsRead != r->pixelsRead || reads.hits != r->hits || reads.misses != r->misses)
+        {
+            printf("  expected %lu %lu %lu\n", (unsigned long)r->pixelsRead,
+                   (unsigned long)r->hits, (unsigned long)r->misses);
+            failed = 1;
+        }
+        if(errors)
+        {
+            printf("  %u pixels not XORed as asked\n", errors);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = NULL;
+    char path[256];
+    ssd1351_counts_t counts;
+    oledc_bus_stats_t stats;
+    unsigned i;
+    int failed = 0;
+
+    if(argc == 3 && !strcmp(argv[1], "-o"))
+    {
+        dir = argv[2];
+    }
+    else if(argc != 1)
+    {
+        fprintf(stderr, "usage: oled_emu [-o dir]\n");
+        return 2;
+    }
+
+    ssd1351_reset();
+    oledC_setup();
+    printf("%-10s %8s %8s %8s %8s %6s  %s\n",
+           "frame", "bytes", "commands", "pixels", "windows", "cs", "image");
+    for(i = 0; i < SCENE_COUNT; i++)
+    {
+        ssd1351_resetCounts();
+        oledC_resetBusStats();
+        scenes[i].draw();
+        oledC_flush();
+        ssd1351_getCounts(&counts);
+        oledC_getBusStats(&stats);
+        printf("%-10s %8lu %8lu %8lu %8lu %6lu  %08lx\n", scenes[i].name,
+               (unsigned long)counts.bytes, (unsigned long)counts.commands,
+               (unsigned long)counts.pixels, (unsigned long)counts.windows,
+               (unsigned long)counts.transactions, (unsigned long)ssd1351_hash());
+        if(stats.bytes != counts.bytes)
+        {
+            printf("  driver counted %lu bytes\n", (unsigned long)stats.bytes);
+            failed = 1;
+        }
+        if(dir)
+        {
+            snprintf(path, sizeof(path), "%s/frame_%02u.ppm", dir, i);
+            if(!ssd1351_writePPM(path))
+            {
+                fprintf(stderr, "cannot write %s\n", path);
+                return 1;
+            }
+        }
+    }
+    if(checkReadBack())
+    {
+        failed = 1;
+    }
+    return failed;
+}
@@ -0,0 +1,319 @@
+/*
+ * File:   screen_bench.c
+ *
+ * Render cost of each UI screen, drawn by the real main.c code through the
+ * OLED driver into the SSD1351 model, checked against screen_budgets.txt.
+ *
+ *   make screen-bench
+ *   build/tools/screen_bench [-o dir] [budgets]
+ *
+ * main.c is compiled into this file with its main() renamed, so its
+ * compose functions and state are reachable; the accelerometer, I2C and
+ * flash journal are stubbed out and the step history is the real one.
+ * Each screen reports SPI bytes, windows opened and the bus time those
+ * bytes take at the SPI1 clock spi1_open() sets up. The run fails when a
+ * screen goes over its budget in bytes or windows, or has none. -o writes
+ * what each screen left on the panel as dir/<screen>.ppm.
+ *
+ * The budgets are for the default build (no framebuffer). Raise one only
+ * with the change that makes the screen cost more, and say why.
+ *
+ * After the screens, the render task runs the watch face for a simulated
+ * minute of clock ticks on a clock that advances with the bus time of
+ * what was sent, and its frame statistics are printed. The first frame
+ * repaints the whole panel and is reported on its own; a tick frame over
+ * the interval fails the run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// XC16 attributes on _T1Interrupt; the host compiler reads interrupt differently
+#define interrupt
+#define auto_psv
+#define main firmware_main
+#include "../../main.c"
+#undef main
+
+#include "ssd1351.h"
+
+#define FCY             4000000UL
+#define SPI1_BRG        0           // spi1_open(): SCK = FCY / (2 * (BRG + 1))
+#define SPI_HZ          (FCY / (2 * (SPI1_BRG + 1)))
+#define MAX_SCREENS     16
+#define NAME_MAX        24
+#define RENDER_SECONDS  60
+
+volatile TRISABITS TRISAbits;
+volatile T1CONBITS T1CONbits;
+volatile IFS0BITS IFS0bits;
+volatile IEC0BITS IEC0bits;
+volatile unsigned int PORTA = 0xFFFF, T1CON, TMR1, PR1;    // buttons released
+
+void SYSTEM_Initialize(void) {}
+void i2c1_open(void) {}
+I2Cerror i2cReadSlaveRegister(unsigned char devAddW, unsigned char regAdd, unsigned char *reg)
+{
+    *reg = 0;
+    return OK;
+}
+I2Cerror i2cWriteSlave(unsigned char devAddW, unsigned char regAdd, unsigned char data)
+{
+    return OK;
+}
+I2Cerror accelTap_initialize(TapClock millis) { return OK; }
+TapEvent accelTap_getEvent(void) { return TAP_NONE; }
+void accelTap_flush(void) {}
+void stepJournal_mount(StepJournalClock millis) {}
+void stepJournal_tick(void) {}
+void stepJournal_idle(void) {}
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);    // not measured
+    void (*draw)(void);
+} screen_t;
+
+typedef struct
+{
+    char name[NAME_MAX];
+    unsigned long bytes;
+    unsigned long windows;
+} budget_t;
+
+static budget_t budgets[MAX_SCREENS];
+static int budgetCount;
+
+/*--- the screens, as the firmware reaches them ---*/
+static void watchFace(void)
+{
+    currentPace = 96;           // walking: foot icon and pace shown
+    lastStepTime = msCounter;
+    oledC_frameInvalidate();
+    composeWatchFace(OLEDC_RENDER_ALL);
+}
+
+static void clockTick(void)
+{
+    updateTime();
+    composeWatchFace(RENDER_CLOCK);
+}
+
+static void menuEntry(void)
+{
+    enterMenu();
+    composeMenu(OLEDC_RENDER_ALL);
+}
+
+static void menuMove(void)
+{
+    navigateMenuDown();
+    composeMenu(RENDER_INPUT);
+}
+
+static void timeConfigOpen(void)
+{
+    newHour = hours;
+    newMinute = minutes;
+    activeField = 0;
+    composeTimeConfig(OLEDC_RENDER_ALL);
+}
+
+static void timeFieldChange(void)
+{
+    newHour = (newHour == 12) ? 1 : newHour + 1;
+    composeTimeConfig(RENDER_INPUT);
+}
+
+/* Two hours of paces from 15 to 60 steps/min, changing every half minute */
+static void fillHistory(void)
+{
+    uint32_t second;
+
+    stepHistory_init();
+    for(second = 0; second < 2 * 3600UL; second++)
+    {
+        stepHistory_addSteps(second % (1 + (second / 30) % 4) == 0 ? 1 : 0);
+        stepHistory_tick();
+    }
+    graphSpanIndex = 0;
+    oledC_frameInvalidate();
+}
+
+static void graphFull(void)
+{
+    composeGraph(OLEDC_RENDER_ALL);
+}
+
+static const screen_t screens[] = {
+    { "watch-face",     NULL,               watchFace },
+    { "clock-tick",     NULL,               clockTick },
+    { "menu-entry",     NULL,               menuEntry },
+    { "menu-move",      NULL,               menuMove },
+    { "set-time-field", timeConfigOpen,     timeFieldChange },
+    { "graph-full",     fillHistory,        graphFull },
+};
+
+#define SCREEN_COUNT (sizeof(screens) / sizeof(screens[0]))
+
+/* Milliseconds: stepped by the run, plus the bus time of every byte since it began */
+static uint32_t simMillis;
+
+static uint32_t busClock(void)
+{
+    ssd1351_counts_t counts;
+
+    ssd1351_getCounts(&counts);
+    return simMillis + (uint32_t)(counts.bytes * 8ULL * 1000ULL / SPI_HZ);
+}
+
+static bool runRenderTask(void)
+{
+    oledc_render_stats_t stats;
+    uint16_t entryMs;
+
+    ssd1351_resetCounts();
+    simMillis = 0;
+    currentPace = 0;
+    oledC_renderInit(busClock, FRAME_INTERVAL);
+    oledC_renderSetScreen(composeWatchFace);
+    oledC_renderService();
+    oledC_getRenderStats(&stats);
+    entryMs = stats.lastMs;
+    oledC_resetRenderStats();
+    for(; simMillis < RENDER_SECONDS * 1000UL; simMillis++)
+    {
+        if(simMillis % 1000 == 999)
+        {
+            updateTime();
+            oledC_renderPost(RENDER_CLOCK);
+        }
+        oledC_renderService();
+    }
+    oledC_getRenderStats(&stats);
+    printf("render task, watch face for %u s at %u ms a frame:\n", RENDER_SECONDS, FRAME_INTERVAL);
+    printf("  entry frame %u ms\n", entryMs);
+    printf("  frames %lu  skipped %lu  over budget %lu  max %u ms\n",
+           (unsigned long)stats.frames, (unsigned long)stats.skipped,
+           (unsigned long)stats.overBudget, stats.maxMs);
+    return stats.overBudget != 0;
+}
+
+/* "name bytes windows" per line; # starts a comment */
+static bool readBudgets(const char *path)
+{
+    char line[128];
+    FILE *f = fopen(path, "r");
+
+    if(f == NULL)
+    {
+        return false;
+    }
+    while(fgets(line, sizeof(line), f) && budgetCount < MAX_SCREENS)
+    {
+        budget_t *b = &budgets[budgetCount];
+        char *hash = strchr(line, '#');
+        if(hash)
+        {
+            *hash = '\0';
+        }
+        if(sscanf(line, "%23s %lu %lu", b->name, &b->bytes, &b->windows) == 3)
+        {
+            budgetCount++;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static const budget_t *findBudget(const char *name)
+{
+    int i;
+    for(i = 0; i < budgetCount; i++)
+    {
+        if(!strcmp(budgets[i].name, name))
+        {
+            return &budgets[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = "tools/oled_emu/screen_budgets.txt";
+    const char *dir = NULL;
+    char image[256];
+    ssd1351_counts_t counts;
+    unsigned i;
+    int failed = 0;
+    int arg = 1;
+
+    if(arg + 1 < argc && !strcmp(argv[arg], "-o"))
+    {
+        dir = argv[arg + 1];
+        arg += 2;
+    }
+    if(arg < argc)
+    {
+        path = argv[arg++];
+    }
+    if(arg != argc)
+    {
+        fprintf(stderr, "usage: screen_bench [-o dir] [budgets]\n");
+        return 2;
+    }
+
+    if(!readBudgets(path))
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 2;
+    }
+
+    ssd1351_reset();
+    oledC_setup();
+    initOLED();
+    printf("SPI1 at %lu Hz\n", (unsigned long)SPI_HZ);
+    printf("%-16s %8s %8s %10s %16s\n", "screen", "bytes", "windows", "bus us", "budget");
+    for(i = 0; i < SCREEN_COUNT; i++)
+    {
+        const budget_t *budget = findBudget(screens[i].name);
+        bool over;
+
+        if(screens[i].setup)
+        {
+            screens[i].setup();
+            oledC_flush();
+        }
+        ssd1351_resetCounts();
+        screens[i].draw();
+        oledC_flush();
+        ssd1351_getCounts(&counts);
+
+        over = budget == NULL || counts.bytes > budget->bytes || counts.windows > budget->windows;
+        printf("%-16s %8lu %8lu %10lu ", screens[i].name,
+               (unsigned long)counts.bytes, (unsigned long)counts.windows,
+               (unsigned long)(counts.bytes * 8ULL * 1000000ULL / SPI_HZ));
+        if(budget)
+        {
+            printf("%8lu %7lu", budget->bytes, budget->windows);
+        }
+        else
+        {
+            printf("%16s", "none");
+        }
+        printf("%s\n", over ? "  OVER" : "");
+        failed |= over;
+        if(dir)
+        {
+            snprintf(image, sizeof(image), "%s/%s.ppm", dir, screens[i].name);
+            ssd1351_writePPM(image);
+        }
+    }
+    failed |= runRenderTask();
+    return failed;
+}
@@ -0,0 +1,138 @@
+/*
+ * File:   spi1_host.c
+ *
+ * spi1_driver.h for the host: every byte goes to the SSD1351 model with
+ * the DC level the driver left in LATC3, while nCS (LATC9) is low. The
+ * 16-bit and DMA paths send the high byte first, as SPI1 does in MODE16.
+ * Delays return at once.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+#include "../../spiDriver/spi1_driver.h"
+#include "../../System/delay.h"
+#include "ssd1351.h"
+
+volatile LATABITS LATAbits;
+volatile LATCBITS LATCbits;
+
+static bool selected;
+
+static uint8_t busByte(uint8_t byte)
+{
+    bool cs = (LATCbits.LATC9 == 0);
+
+    if(cs != selected)
+    {
+        selected = cs;
+        ssd1351_select(cs);
+    }
+    return cs ? ssd1351_exchange(byte, LATCbits.LATC3) : 0xFF;
+}
+
+bool spi1_open(void)
+{
+    return true;
+}
+
+void spi1_close(void)
+{
+    selected = false;
+}
+
+uint8_t spi1_exchangeByte(uint8_t b)
+{
+    return busByte(b);
+}
+
+void spi1_exchangeBlock(void *block, size_t blockSize)
+{
+    uint8_t *b = block;
+    while(blockSize--)
+    {
+        *b = busByte(*b);
+        b++;
+    }
+}
+
+void spi1_writeBlock(void *block, size_t blockSize)
+{
+    spi1_writeBlockFast(block, blockSize);
+}
+
+void spi1_readBlock(void *block, size_t blockSize)
+{
+    uint8_t *b = block;
+    while(blockSize--)
+    {
+        *b++ = busByte(0xFF);
+    }
+}
+
+void spi1_writeBlockFast(const void *block, size_t blockSize)
+{
+    const uint8_t *b = block;
+    while(blockSize--)
+    {
+        busByte(*b++);
+    }
+}
+
+void spi1_writeBlock16(const uint16_t *block, size_t count)
+{
+    while(count--)
+    {
+        busByte(*block >> 8);
+        busByte(*block++ & 0xFF);
+    }
+}
+
+void spi1_writeRepeat16(uint16_t word, size_t count)
+{
+    while(count--)
+    {
+        busByte(word >> 8);
+        busByte(word & 0xFF);
+    }
+}
+
+bool spi1_writeBlockDMA(const uint16_t *block, size_t count, void (*callback)(void))
+{
+    spi1_writeBlock16(block, count);
+    if(callback)
+    {
+        callback();
+    }
+    return true;
+}
+
+bool spi1_dmaBusy(void)
+{
+    return false;
+}
+
+void spi1_dmaWait(void)
+{
+}
+
+void spi1_writeByte(uint8_t byte)
+{
+    busByte(byte);
+}
+
+uint8_t spi1_readByte(void)
+{
+    return busByte(0xFF);
+}
+
+void DELAY_milliseconds(uint16_t milliseconds)
+{
+    (void)milliseconds;
+}
+
+void DELAY_microseconds(uint16_t microseconds)
+{
+    (void)microseconds;
+}
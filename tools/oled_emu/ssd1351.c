@@ -0,0 +1,303 @@
+/*
+ * File:   ssd1351.c
+ *
+ * SSD1351 command decoder and display RAM.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ssd1351.h"
+
+#define RAM_SIZE        128
+#define COLUMN_OFFSET   16
+
+#define CMD_COLUMN      0x15
+#define CMD_ROW         0x75
+#define CMD_WRITE_RAM   0x5C
+#define CMD_READ_RAM    0x5D
+#define CMD_REMAP       0xA0
+#define CMD_START_LINE  0xA1
+#define CMD_OFFSET      0xA2
+#define CMD_ALL_OFF     0xA4
+#define CMD_ALL_ON      0xA5
+#define CMD_NORMAL      0xA6
+#define CMD_INVERSE     0xA7
+#define CMD_SLEEP_ON    0xAE
+#define CMD_SLEEP_OFF   0xAF
+
+/*
+ * The firmware's remap (oledC_setDisplayOrientation) shows its drawing the
+ * right way round on the board; other settings flip relative to it.
+ */
+#define REMAP_REFERENCE 0x32
+#define REMAP_VERTICAL  0x01    // address increments down the column first
+#define REMAP_COLUMNS   0x02
+#define REMAP_RGB       0x04
+#define REMAP_COM       0x10
+
+static uint16_t ram[RAM_SIZE][RAM_SIZE];
+static uint8_t column0, column1, row0, row1;
+static uint8_t column, row;
+static uint8_t command;
+static uint8_t args[2];
+static uint8_t argCount;
+static bool highByte;
+static uint8_t pixelHigh;
+static bool windowMoved;
+static uint8_t remap, startLine, displayOffset, displayMode;
+static bool sleeping;
+static ssd1351_counts_t counts;
+
+void ssd1351_reset(void)
+{
+    memset(ram, 0, sizeof(ram));
+    column0 = 0;
+    column1 = RAM_SIZE - 1;
+    row0 = 0;
+    row1 = RAM_SIZE - 1;
+    column = 0;
+    row = 0;
+    command = 0;
+    argCount = 0;
+    highByte = true;
+    windowMoved = true;
+    remap = 0x40;
+    startLine = 0;
+    displayOffset = 0x60;
+    displayMode = CMD_NORMAL;
+    sleeping = true;
+    ssd1351_resetCounts();
+}
+
+/* Next cell of the window, wrapping at its edges as the controller does */
+static void advance(void)
+{
+    if(remap & REMAP_VERTICAL)
+    {
+        if(row != row1)
+        {
+            row = (row + 1) & (RAM_SIZE - 1);
+            return;
+        }
+        row = row0;
+        column = column == column1 ? column0 : (column + 1) & (RAM_SIZE - 1);
+    }
+    else
+    {
+        if(column != column1)
+        {
+            column = (column + 1) & (RAM_SIZE - 1);
+            return;
+        }
+        column = column0;
+        row = row == row1 ? row0 : (row + 1) & (RAM_SIZE - 1);
+    }
+}
+
+static void startCommand(uint8_t byte)
+{
+    counts.commands++;
+    command = byte;
+    argCount = 0;
+    highByte = true;
+    switch(byte)
+    {
+    case CMD_WRITE_RAM:
+    case CMD_READ_RAM:
+        column = column0;
+        row = row0;
+        if(byte == CMD_WRITE_RAM && windowMoved)
+        {
+            counts.windows++;
+            windowMoved = false;
+        }
+        break;
+    case CMD_ALL_OFF:
+    case CMD_ALL_ON:
+    case CMD_NORMAL:
+    case CMD_INVERSE:
+        displayMode = byte;
+        break;
+    case CMD_SLEEP_ON:
+    case CMD_SLEEP_OFF:
+        sleeping = (byte == CMD_SLEEP_ON);
+        break;
+    default:
+        break;
+    }
+}
+
+static void argument(uint8_t byte)
+{
+    if(argCount < sizeof(args))
+    {
+        args[argCount] = byte;
+    }
+    argCount++;
+    switch(command)
+    {
+    case CMD_COLUMN:
+    case CMD_ROW:
+        if(argCount == 2)
+        {
+            if(command == CMD_COLUMN)
+            {
+                column0 = args[0] & (RAM_SIZE - 1);
+                column1 = args[1] & (RAM_SIZE - 1);
+            }
+            else
+            {
+                row0 = args[0] & (RAM_SIZE - 1);
+                row1 = args[1] & (RAM_SIZE - 1);
+            }
+            windowMoved = true;
+        }
+        break;
+    case CMD_REMAP:
+        remap = argCount == 1 ? byte : remap;
+        break;
+    case CMD_START_LINE:
+        startLine = argCount == 1 ? byte & (RAM_SIZE - 1) : startLine;
+        break;
+    case CMD_OFFSET:
+        displayOffset = argCount == 1 ? byte & (RAM_SIZE - 1) : displayOffset;
+        break;
+    default:
+        break;
+    }
+}
+
+uint8_t ssd1351_exchange(uint8_t byte, bool data)
+{
+    uint8_t back = 0xFF;
+
+    counts.bytes++;
+    if(!data)
+    {
+        startCommand(byte);
+    }
+    else if(command == CMD_WRITE_RAM)
+    {
+        if(highByte)
+        {
+            pixelHigh = byte;
+        }
+        else
+        {
+            ram[row][column] = (uint16_t)pixelHigh << 8 | byte;
+            counts.pixels++;
+            advance();
+        }
+        highByte = !highByte;
+    }
+    else if(command == CMD_READ_RAM)
+    {
+        back = highByte ? ram[row][column] >> 8 : ram[row][column] & 0xFF;
+        if(!highByte)
+        {
+            counts.pixelsRead++;
+            advance();
+        }
+        highByte = !highByte;
+    }
+    else
+    {
+        argument(byte);
+    }
+    return back;
+}
+
+void ssd1351_select(bool selected)
+{
+    if(selected)
+    {
+        counts.transactions++;
+    }
+}
+
+void ssd1351_getCounts(ssd1351_counts_t *out)
+{
+    *out = counts;
+}
+
+void ssd1351_resetCounts(void)
+{
+    memset(&counts, 0, sizeof(counts));
+}
+
+void ssd1351_panel(uint16_t image[SSD1351_PANEL][SSD1351_PANEL])
+{
+    uint8_t flips = remap ^ REMAP_REFERENCE;
+    uint16_t pixel;
+    int x, y, com, seg;
+
+    for(y = 0; y < SSD1351_PANEL; y++)
+    {
+        com = (flips & REMAP_COM) ? SSD1351_PANEL - 1 - y : y;
+        for(x = 0; x < SSD1351_PANEL; x++)
+        {
+            seg = (flips & REMAP_COLUMNS) ? SSD1351_PANEL - 1 - x : x;
+            pixel = ram[(startLine + displayOffset + com) & (RAM_SIZE - 1)][COLUMN_OFFSET + seg];
+            if(flips & REMAP_RGB)
+            {
+                pixel = (pixel & 0x07E0) | (pixel >> 11) | (pixel << 11);
+            }
+            if(sleeping || displayMode == CMD_ALL_OFF)
+            {
+                pixel = 0x0000;
+            }
+            else if(displayMode == CMD_ALL_ON)
+            {
+                pixel = 0xFFFF;
+            }
+            else if(displayMode == CMD_INVERSE)
+            {
+                pixel = ~pixel;
+            }
+            image[y][x] = pixel;
+        }
+    }
+}
+
+bool ssd1351_writePPM(const char *path)
+{
+    static uint16_t image[SSD1351_PANEL][SSD1351_PANEL];
+    FILE *f = fopen(path, "wb");
+    int x, y;
+
+    if(f == NULL)
+    {
+        return false;
+    }
+    ssd1351_panel(image);
+    fprintf(f, "P6\n%d %d\n255\n", SSD1351_PANEL, SSD1351_PANEL);
+    for(y = 0; y < SSD1351_PANEL; y++)
+    {
+        for(x = 0; x < SSD1351_PANEL; x++)
+        {
+            uint16_t p = image[y][x];
+            fputc(((p >> 11) & 0x1F) * 255 / 31, f);
+            fputc(((p >> 5) & 0x3F) * 255 / 63, f);
+            fputc((p & 0x1F) * 255 / 31, f);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+uint32_t ssd1351_hash(void)
+{
+    static uint16_t image[SSD1351_PANEL][SSD1351_PANEL];
+    uint32_t hash = 2166136261UL;
+    int x, y;
+
+    ssd1351_panel(image);
+    for(y = 0; y < SSD1351_PANEL; y++)
+    {
+        for(x = 0; x < SSD1351_PANEL; x++)
+        {
+            hash = (hash ^ (image[y][x] >> 8)) * 16777619UL;
+            hash = (hash ^ (image[y][x] & 0xFF)) * 16777619UL;
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,51 @@
+/*
+ * File:   ssd1351.h
+ *
+ * Host model of the SSD1351 controller as the firmware drives it: the
+ * bytes clocked out on SPI1 with DC low are commands, with DC high their
+ * arguments or pixel data. Only bytes sent while nCS is low count.
+ *
+ * Modelled: the column and row windows and the RAM write/read cursor,
+ * 128x128 RGB565 RAM, remap (address increment direction, column and COM
+ * flips, colour order), start line, display offset, display modes and
+ * sleep. RAM reads are answered from the window like writes, so the
+ * driver's read-back (oledC_ReadPoint, shadow region loads) can be checked.
+ * The panel image is the 96x96 the firmware draws to: columns
+ * 16..111 of the rows COM0..95 scan out.
+ */
+
+#ifndef SSD1351_H
+#define SSD1351_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SSD1351_PANEL   96
+
+typedef struct ssd1351_counts_t
+{
+    uint32_t bytes;         // everything clocked out with nCS low
+    uint32_t commands;
+    uint32_t pixels;        // 16-bit words written to RAM
+    uint32_t pixelsRead;    // 16-bit words read from RAM
+    uint32_t windows;       // RAM writes opened on a new column/row window
+    uint32_t transactions;  // nCS low periods
+} ssd1351_counts_t;
+
+void ssd1351_reset(void);
+/* One byte on the bus; data is the DC pin */
+uint8_t ssd1351_exchange(uint8_t byte, bool data);
+/* nCS edges */
+void ssd1351_select(bool selected);
+
+void ssd1351_getCounts(ssd1351_counts_t *counts);
+void ssd1351_resetCounts(void);
+
+/* What the panel shows, RGB565, row by row */
+void ssd1351_panel(uint16_t image[SSD1351_PANEL][SSD1351_PANEL]);
+/* The panel as binary PPM; false if the file cannot be written */
+bool ssd1351_writePPM(const char *path);
+/* FNV-1a of the panel image, to compare runs */
+uint32_t ssd1351_hash(void);
+
+#endif // SSD1351_H
@@ -0,0 +1,8 @@
+/*
+ * File:   delay.h
+ *
+ * oledC.c includes "../system/delay.h"; the directory is System/ and host
+ * file systems are case sensitive. Found through -Itools/oled_emu/include.
+ */
+
+#include "../../../System/delay.h"
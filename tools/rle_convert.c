@@ -0,0 +1,180 @@
+/*
+ * File:   rle_convert.c
+ *
+ * Converts a one-bit bitmap into an oledc_rle_image_t (see oledC_shapes.h).
+ *
+ *   cc -O2 -o rle_convert tools/rle_convert.c
+ *   ./rle_convert [-i] [-c background ink] name width < rows.txt
+ *
+ * rows.txt holds one row per number, most significant bit leftmost, in
+ * any mix of 0x, 0b or decimal; declarations, commas, braces and comments
+ * around them are skipped, so an existing C array can be fed in as is.
+ * Set bits become colour 1 (ink) and clear bits colour 0 (background); -i
+ * swaps them, for bitmaps such as the oledC_example logo that draw their
+ * clear bits. Colours are RGB565 and default to black and white.
+ *
+ * Runs are what the bus saves, not flash: a 16x16 icon with ragged edges
+ * takes more run bytes than bits. The byte counts are printed on stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_ROWS    96
+#define MAX_WIDTH   32
+#define RUN_MAX     64
+
+static uint32_t rows[MAX_ROWS];
+
+/*
+ * Next row on stdin, or -1 at the end. Comments, digits inside identifiers
+ * (uint16_t) and array sizes ([16]) are not rows.
+ */
+static int readRow(uint32_t *value)
+{
+    static int prev = ' ';
+    static int bracket;
+    int c, base = 10;
+
+    for(;;)
+    {
+        c = getchar();
+        if(c == EOF)
+        {
+            return -1;
+        }
+        if(prev == '/' && c == '/')
+        {
+            while(c != EOF && c != '\n')
+            {
+                c = getchar();
+            }
+        }
+        else if(prev == '/' && c == '*')
+        {
+            for(prev = 0; (c = getchar()) != EOF && !(prev == '*' && c == '/'); prev = c)
+            {
+            }
+            c = ' ';
+        }
+        else if(c == '[' || c == ']')
+        {
+            bracket = (c == '[');
+        }
+        else if(isdigit(c) && !bracket && !isalnum(prev) && prev != '_')
+        {
+            break;
+        }
+        prev = c;
+    }
+    *value = 0;
+    if(c == '0')
+    {
+        c = getchar();
+        if(c == 'x' || c == 'X')
+        {
+            base = 16;
+            c = getchar();
+        }
+        else if(c == 'b' || c == 'B')
+        {
+            base = 2;
+            c = getchar();
+        }
+    }
+    while(isxdigit(c) && (base == 16 || isdigit(c)))
+    {
+        *value = *value * base + (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+        c = getchar();
+    }
+    prev = c;
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: rle_convert [-i] [-c background ink] name width < rows.txt\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned background = 0x0000, ink = 0xFFFF;
+    unsigned width, height = 0, x, y, bytes = 0, pixels;
+    unsigned runIndex = 0, runLength = 0, index;
+    int invert = 0;
+    const char *name;
+    int arg = 1;
+
+    while(arg < argc && argv[arg][0] == '-')
+    {
+        if(!strcmp(argv[arg], "-i"))
+        {
+            invert = 1;
+            arg++;
+        }
+        else if(!strcmp(argv[arg], "-c") && arg + 2 < argc)
+        {
+            background = (unsigned)strtoul(argv[arg + 1], NULL, 0) & 0xFFFF;
+            ink = (unsigned)strtoul(argv[arg + 2], NULL, 0) & 0xFFFF;
+            arg += 3;
+        }
+        else
+        {
+            usage();
+        }
+    }
+    if(argc - arg != 2)
+    {
+        usage();
+    }
+    name = argv[arg];
+    width = (unsigned)atoi(argv[arg + 1]);
+    if(width == 0 || width > MAX_WIDTH)
+    {
+        fprintf(stderr, "width must be 1..%d\n", MAX_WIDTH);
+        return 1;
+    }
+    while(height < MAX_ROWS && readRow(&rows[height]) == 0)
+    {
+        height++;
+    }
+    if(height == 0)
+    {
+        fprintf(stderr, "no rows\n");
+        return 1;
+    }
+
+    printf("// %s: %ux%u, converted with tools/rle_convert.c\n", name, width, height);
+    printf("static const uint8_t %sRuns[] = {\n   ", name);
+    pixels = width * height;
+    for(y = 0; y < height; y++)
+    {
+        for(x = 0; x < width; x++)
+        {
+            index = ((rows[y] >> (width - 1 - x)) & 1) ^ invert;
+            if(runLength && (index != runIndex || runLength == RUN_MAX))
+            {
+                printf(" OLEDC_RLE_RUN(%u, %u),", runIndex, runLength);
+                if(++bytes % 4 == 0)
+                {
+                    printf("\n   ");
+                }
+                runLength = 0;
+            }
+            runIndex = index;
+            runLength++;
+        }
+    }
+    printf(" OLEDC_RLE_RUN(%u, %u)\n};\n", runIndex, runLength);
+    bytes++;
+    printf("static const uint16_t %sColors[] = { 0x%04X, 0x%04X };\n", name, background, ink);
+    printf("static const oledc_rle_image_t %s = { %u, %u, 2, %sColors, %sRuns };\n",
+           name, width, height, name, name);
+    fprintf(stderr, "%s: %u pixels, %u run bytes (%u bytes as bits)\n",
+            name, pixels, bytes, (width + 7) / 8 * height);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * File:   step_codec_bench.c
+ *
+ * Host benchmark for Pedometer/step_codec: compression ratio, history
+ * reach and encode/decode throughput.
+ *
+ *   cc -O2 -o step_codec_bench tools/step_codec_bench.c Pedometer/step_codec.c
+ *   ./step_codec_bench [day.txt ...]
+ *
+ * Each day file holds 1440 per-minute step counts, one per line (a day
+ * dumped from the MINUTE tier). Without files a synthetic four weeks are used:
+ * nights near zero, walking bouts of 80-120 steps/min, light activity in
+ * between. Throughput is host time; it shows relative cost only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../Pedometer/step_codec.h"
+
+#define MINUTES_PER_DAY     1440
+#define MAX_DAYS            64
+#define SYNTHETIC_DAYS      28
+#define THROUGHPUT_ROUNDS   200
+
+// Same slices as step_history.h
+#define MINUTE_BLOCKS       200
+#define QUARTER_BLOCKS      210
+#define DAY_BLOCKS          158
+
+static uint16_t minutes[MAX_DAYS * MINUTES_PER_DAY];
+static uint32_t series[MAX_DAYS * MINUTES_PER_DAY];
+static uint8_t  blocks[MAX_DAYS * MINUTES_PER_DAY][STEP_CODEC_BLOCK_BYTES];
+
+static uint32_t rng = 12345;
+
+static uint32_t nextRandom(uint32_t range)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return (rng >> 16) % range;
+}
+
+static void synthesizeDay(uint16_t *day)
+{
+    int m = 0;
+
+    while (m < MINUTES_PER_DAY) {
+        int hour = m / 60;
+        if (hour < 7 || hour >= 23) {
+            day[m++] = (nextRandom(100) < 3) ? (uint16_t)nextRandom(12) : 0;
+        } else if (nextRandom(100) < 6) {
+            int len = 5 + (int)nextRandom(35);
+            int pace = 80 + (int)nextRandom(40);
+            while (len-- && m < MINUTES_PER_DAY)
+                day[m++] = (uint16_t)(pace - 8 + (int)nextRandom(17));
+        } else {
+            day[m++] = (nextRandom(100) < 25) ? (uint16_t)nextRandom(25) : 0;
+        }
+    }
+}
+
+static bool loadDay(const char *path, uint16_t *day)
+{
+    FILE *f = fopen(path, "r");
+    unsigned v;
+    int m = 0;
+
+    if (!f)
+        return false;
+    while (m < MINUTES_PER_DAY && fscanf(f, "%u", &v) == 1)
+        day[m++] = (uint16_t)(v > 0xFFFF ? 0xFFFF : v);
+    fclose(f);
+    return m == MINUTES_PER_DAY;
+}
+
+/* Encode like step_history does: fill a block, then open the next */
+static int encodeSeries(const uint32_t *values, int n)
+{
+    StepEncoder enc;
+    int used = 1;
+    int i;
+
+    stepCodec_begin(&enc, blocks[0]);
+    for (i = 0; i < n; i++) {
+        if (!stepCodec_append(&enc, values[i])) {
+            stepCodec_begin(&enc, blocks[used++]);
+            stepCodec_append(&enc, values[i]);
+        }
+    }
+    return used;
+}
+
+static bool decodeSeries(const uint32_t *values, int n, int used)
+{
+    StepDecoder dec;
+    uint32_t v;
+    int i = 0;
+    int b;
+
+    for (b = 0; b < used; b++) {
+        stepCodec_decodeBegin(&dec, blocks[b]);
+        while (stepCodec_decodeNext(&dec, &v)) {
+            if (i >= n || v != values[i])
+                return false;
+            i++;
+        }
+    }
+    return i == n;
+}
+
+static void report(const char *tier, const uint32_t *values, int n, int rawBytes,
+                   int sliceBlocks, double periodsPerDay)
+{
+    int used = encodeSeries(values, n);
+    double perBlock = (double)n / used;
+    double ratio = (double)(n * rawBytes) / (used * STEP_CODEC_BLOCK_BYTES);
+    double reachDays = sliceBlocks * perBlock / periodsPerDay;
+
+    printf("%-8s %6d samples %5d blocks %6.1f/block  %5.2fx vs %d-byte ring  reach %7.1f days  %s\n",
+           tier, n, used, perBlock, ratio, rawBytes, reachDays,
+           decodeSeries(values, n, used) ? "round-trip ok" : "ROUND-TRIP FAILED");
+}
+
+static void throughput(const uint32_t *values, int n)
+{
+    clock_t start;
+    double encodeSec, decodeSec;
+    StepDecoder dec;
+    uint32_t v, sink = 0;
+    int used = 0;
+    int r, b;
+
+    start = clock();
+    for (r = 0; r < THROUGHPUT_ROUNDS; r++)
+        used = encodeSeries(values, n);
+    encodeSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (r = 0; r < THROUGHPUT_ROUNDS; r++) {
+        for (b = 0; b < used; b++) {
+            stepCodec_decodeBegin(&dec, blocks[b]);
+            while (stepCodec_decodeNext(&dec, &v))
+                sink += v;
+        }
+    }
+    decodeSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("host throughput: encode %.1f M samples/s, decode %.1f M samples/s (checksum %u)\n",
+           THROUGHPUT_ROUNDS * (double)n / encodeSec / 1e6,
+           THROUGHPUT_ROUNDS * (double)n / decodeSec / 1e6, (unsigned)sink);
+}
+
+int main(int argc, char **argv)
+{
+    int days = 0;
+    int n, i, j;
+
+    if (argc > 1) {
+        for (i = 1; i < argc && days < MAX_DAYS; i++) {
+            if (!loadDay(argv[i], &minutes[days * MINUTES_PER_DAY])) {
+                fprintf(stderr, "%s: need %d per-minute counts\n", argv[i], MINUTES_PER_DAY);
+                return 1;
+            }
+            days++;
+        }
+        printf("%d recorded day(s)\n", days);
+    } else {
+        for (days = 0; days < SYNTHETIC_DAYS; days++)
+            synthesizeDay(&minutes[days * MINUTES_PER_DAY]);
+        printf("%d synthetic day(s), no recordings given\n", days);
+    }
+
+    n = days * MINUTES_PER_DAY;
+    for (i = 0; i < n; i++)
+        series[i] = minutes[i];
+    report("minute", series, n, 2, MINUTE_BLOCKS, MINUTES_PER_DAY);
+    throughput(series, n);
+
+    for (i = 0; i < n / 15; i++) {
+        series[i] = 0;
+        for (j = 0; j < 15; j++)
+            series[i] += minutes[i * 15 + j];
+    }
+    report("quarter", series, n / 15, 2, QUARTER_BLOCKS, MINUTES_PER_DAY / 15);
+
+    for (i = 0; i < days; i++) {
+        series[i] = 0;
+        for (j = 0; j < MINUTES_PER_DAY; j++)
+            series[i] += minutes[i * MINUTES_PER_DAY + j];
+    }
+    report("day", series, days, 4, DAY_BLOCKS, 1);
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * File:   step_codec_check.c
+ *
+ * Host round-trip check of Pedometer/step_codec with resume mid-block, the
+ * path a journal restore takes: the encoder is rebuilt from the block
+ * bytes alone and appending goes on from there.
+ *
+ *   cc -O2 -o step_codec_check tools/step_codec_check.c Pedometer/step_codec.c
+ *   ./step_codec_check [trials]
+ *
+ * Each trial encodes a random series twice, straight through and with
+ * stepCodec_resume() before a random sixth of the appends, and requires:
+ *   - both runs write byte-identical blocks (resume restores all state)
+ *   - a refused append leaves the block untouched
+ *   - every block is stepCodec_intact() and decodes back to the series
+ * The series shapes drive blocks through tokens, packed widths and the
+ * rewrites between them. Exit status is non-zero on the first mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../Pedometer/step_codec.h"
+
+#define DEFAULT_TRIALS      2000
+#define MAX_SERIES          3000
+#define RESUME_ONE_IN       6
+
+enum { SHAPE_QUIET, SHAPE_MINUTES, SHAPE_QUARTERS, SHAPE_SPIKES, SHAPE_BOUTS, SHAPE_COUNT };
+
+static const char *const shapeNames[SHAPE_COUNT] = { "quiet", "minutes", "quarters", "spikes", "bouts" };
+
+static uint32_t series[MAX_SERIES];
+static uint8_t  straight[MAX_SERIES][STEP_CODEC_BLOCK_BYTES];
+static uint8_t  resumed[MAX_SERIES][STEP_CODEC_BLOCK_BYTES];
+
+static uint32_t rng = 12345;
+
+static uint32_t nextRandom(uint32_t range)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return (rng >> 16) % range;
+}
+
+static void synthesize(int shape, int n)
+{
+    int bout = 1 + (int)nextRandom(30);
+    int i;
+
+    for (i = 0; i < n; i++) {
+        switch (shape) {
+        case SHAPE_QUIET:
+            series[i] = nextRandom(3) ? 0 : nextRandom(20);
+            break;
+        case SHAPE_MINUTES:
+            series[i] = nextRandom(130);
+            break;
+        case SHAPE_QUARTERS:
+            series[i] = nextRandom(2000);
+            break;
+        case SHAPE_SPIKES:
+            series[i] = nextRandom(50) ? nextRandom(300) : nextRandom(65536) * 4099UL;
+            break;
+        default:
+            series[i] = ((i / bout) % 2) ? nextRandom(40000) : 0;
+            break;
+        }
+    }
+}
+
+/* Append like step_history does; the block must not change when refused */
+static bool append(StepEncoder *enc, uint8_t (*blocks)[STEP_CODEC_BLOCK_BYTES], int *used, uint32_t value)
+{
+    uint8_t before[STEP_CODEC_BLOCK_BYTES];
+
+    memcpy(before, blocks[*used - 1], STEP_CODEC_BLOCK_BYTES);
+    if (stepCodec_append(enc, value))
+        return true;
+    if (memcmp(before, blocks[*used - 1], STEP_CODEC_BLOCK_BYTES) != 0) {
+        printf("refused append changed the block\n");
+        return false;
+    }
+    stepCodec_begin(enc, blocks[(*used)++]);
+    if (!stepCodec_append(enc, value)) {
+        printf("empty block refused %lu\n", (unsigned long)value);
+        return false;
+    }
+    return true;
+}
+
+static int encode(uint8_t (*blocks)[STEP_CODEC_BLOCK_BYTES], int n, bool resume)
+{
+    StepEncoder enc;
+    int used = 1;
+    int i;
+
+    memset(blocks, 0, (size_t)n * STEP_CODEC_BLOCK_BYTES);
+    stepCodec_begin(&enc, blocks[0]);
+    for (i = 0; i < n; i++) {
+        if (resume && nextRandom(RESUME_ONE_IN) == 0 && !stepCodec_resume(&enc, blocks[used - 1])) {
+            printf("resume refused block %d after sample %d\n", used - 1, i);
+            return 0;
+        }
+        if (!append(&enc, blocks, &used, series[i]))
+            return 0;
+    }
+    return used;
+}
+
+static bool decode(int n, int used)
+{
+    StepDecoder dec;
+    uint32_t v;
+    int i = 0;
+    int b;
+
+    for (b = 0; b < used; b++) {
+        if (!stepCodec_intact(resumed[b])) {
+            printf("block %d not intact\n", b);
+            return false;
+        }
+        stepCodec_decodeBegin(&dec, resumed[b]);
+        while (stepCodec_decodeNext(&dec, &v)) {
+            if (i >= n || v != series[i]) {
+                printf("sample %d decoded %lu, encoded %lu\n", i, (unsigned long)v,
+                       (unsigned long)(i < n ? series[i] : 0));
+                return false;
+            }
+            i++;
+        }
+    }
+    if (i != n) {
+        printf("decoded %d of %d samples\n", i, n);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int trials = (argc > 1) ? atoi(argv[1]) : DEFAULT_TRIALS;
+    unsigned long samples = 0, blocks = 0;
+    int trial, shape, n, used, usedStraight;
+
+    for (trial = 0; trial < trials; trial++) {
+        shape = (int)nextRandom(SHAPE_COUNT);
+        n = 1 + (int)nextRandom(MAX_SERIES);
+        synthesize(shape, n);
+        usedStraight = encode(straight, n, false);
+        used = encode(resumed, n, true);
+        if (used == 0 || usedStraight == 0 || used != usedStraight ||
+            memcmp(straight, resumed, (size_t)used * STEP_CODEC_BLOCK_BYTES) != 0 ||
+            !decode(n, used)) {
+            if (used != usedStraight)
+                printf("%d blocks straight through, %d with resume\n", usedStraight, used);
+            else if (used && memcmp(straight, resumed, (size_t)used * STEP_CODEC_BLOCK_BYTES) != 0)
+                printf("blocks differ with resume\n");
+            printf("FAILED trial %d (%s, %d samples)\n", trial, shapeNames[shape], n);
+            return 1;
+        }
+        samples += n;
+        blocks += used;
+    }
+    printf("%d trials, %lu samples in %lu blocks round-trip with resume\n", trials, samples, blocks);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * File:   step_index_check.c
+ *
+ * Host check of Pedometer/step_index against brute force: drives
+ * step_history with synthetic seconds and, once per simulated day, compares
+ * stepIndex_query with sums, minima and maxima taken by reading every
+ * bucket of the range back through stepHistory_openReader.
+ *
+ *   cc -O2 -o step_index_check tools/step_index_check.c \
+ *       Pedometer/step_history.c Pedometer/step_index.c Pedometer/step_codec.c
+ *   ./step_index_check [days]
+ *
+ * The default run is long enough for every coded tier, DAY included, to
+ * wrap its ring, so ranges across the head block and the wrap are covered.
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Pedometer/step_history.h"
+#include "../Pedometer/step_index.h"
+
+#define SECONDS_PER_DAY     86400UL
+#define DEFAULT_DAYS        1200
+#define RANDOM_RANGES       40
+#define MAX_HELD            (STEP_DAY_BLOCKS * STEP_CODEC_MAX_SAMPLES)
+
+static const char *const tierNames[STEP_TIER_COUNT] = { "second", "minute", "quarter", "day" };
+
+static uint32_t buckets[MAX_HELD];
+static uint32_t rng = 12345;
+static unsigned long queries;
+
+static uint32_t nextRandom(uint32_t range)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return (rng >> 16) % range;
+}
+
+/* Nights near zero, walking bouts of 1-2 steps a second, light activity */
+static void simulateDay(void)
+{
+    uint32_t s = 0;
+    uint32_t bout = 0;
+    uint16_t steps;
+
+    while (s < SECONDS_PER_DAY) {
+        uint32_t hour = s / 3600;
+
+        if (bout) {
+            steps = 1 + (uint16_t)nextRandom(2);
+            bout--;
+        } else if (hour >= 7 && hour < 23 && nextRandom(3000) == 0) {
+            bout = 300 + nextRandom(2100);
+            steps = 0;
+        } else {
+            steps = (nextRandom(100) < ((hour >= 7 && hour < 23) ? 4 : 0)) ? 1 : 0;
+        }
+        if (steps)
+            stepHistory_addSteps(steps);
+        stepHistory_tick();
+        s++;
+    }
+}
+
+/* Every held bucket of a tier, buckets[age] with age 0 the newest */
+static uint16_t readTier(StepTier tier)
+{
+    uint16_t held = stepHistory_count(tier);
+    StepHistoryReader rd;
+    uint16_t age;
+
+    if (held == 0)
+        return 0;
+    stepHistory_openReader(&rd, tier, held - 1);
+    for (age = held; age > 0; age--)
+        buckets[age - 1] = stepHistory_readNext(&rd);
+    return held;
+}
+
+static bool checkRange(StepTier tier, uint16_t held, uint16_t newestAge, uint16_t oldestAge)
+{
+    StepAggregate got;
+    uint32_t sum = 0;
+    uint16_t count = 0, min = 0xFFFF, max = 0, v;
+    uint16_t last = (oldestAge < held) ? oldestAge : held - 1;
+    uint16_t age;
+    bool ok;
+
+    for (age = newestAge; age <= last && newestAge <= last; age++) {
+        v = (buckets[age] > 0xFFFF) ? 0xFFFF : (uint16_t)buckets[age];
+        sum += buckets[age];
+        count++;
+        if (v < min)
+            min = v;
+        if (v > max)
+            max = v;
+    }
+    ok = stepIndex_query(tier, newestAge, oldestAge, &got);
+    queries++;
+    if (ok != (count > 0) || got.count != count ||
+        (count && (got.sum != sum || got.min != min || got.max != max))) {
+        printf("%s ages %u..%u of %u: index %s sum %lu n %u min %u max %u, "
+               "brute force sum %lu n %u min %u max %u\n",
+               tierNames[tier], newestAge, oldestAge, held, ok ? "ok" : "empty",
+               (unsigned long)got.sum, got.count, got.min, got.max,
+               (unsigned long)sum, count, min, max);
+        return false;
+    }
+    return true;
+}
+
+static bool checkTier(StepTier tier)
+{
+    uint16_t held = readTier(tier);
+    uint16_t a, b;
+    int i;
+
+    if (held == 0)
+        return true;
+    if (!checkRange(tier, held, 0, held - 1) ||
+        !checkRange(tier, held, 0, 0) ||
+        !checkRange(tier, held, held - 1, held - 1) ||
+        !checkRange(tier, held, 0, held + 10) ||
+        !checkRange(tier, held, held, held + 10))
+        return false;
+    for (i = 0; i < RANDOM_RANGES; i++) {
+        a = (uint16_t)nextRandom(held);
+        b = (uint16_t)nextRandom(held);
+        if (!checkRange(tier, held, (a < b) ? a : b, (a < b) ? b : a))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int days = (argc > 1) ? atoi(argv[1]) : DEFAULT_DAYS;
+    int day, tier;
+
+    stepHistory_init();
+    for (day = 1; day <= days; day++) {
+        simulateDay();
+        for (tier = 0; tier < STEP_TIER_COUNT; tier++) {
+            if (!checkTier((StepTier)tier)) {
+                printf("FAILED on day %d\n", day);
+                return 1;
+            }
+        }
+    }
+    for (tier = 0; tier < STEP_TIER_COUNT; tier++)
+        printf("%-8s %5u buckets held\n", tierNames[tier], stepHistory_count((StepTier)tier));
+    printf("%d days, %lu queries match brute force\n", days, queries);
+    return 0;
+}